@@ -22,12 +22,34 @@
 
 #include <tinyara/config.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <sched.h>
+#include <semaphore.h>
 #include <time.h>
 #include <sys/types.h>
 
 #define SWITCHING_ITERATIONS 1000000
 
+/* The wakeup cost is measured with these numbers of ready tasks.
+ * Every task of the measurement has its own priority above the measuring
+ * task, and the woken task has the lowest of them. The woken task is
+ * therefore inserted behind every ready task by sched_addprioritized(),
+ * at a depth which grows with the number of ready tasks.
+ */
+
+#define LATENCY_ITERATIONS   1000
+#define LATENCY_PRIORITY     100
+#define LATENCY_STACKSIZE    1024
+
+static const int g_ready_task_nums[] = { 10, 50, 100 };
+
+static sem_t g_ready_sem;
+static sem_t g_wakeup_sem;
+static volatile int g_wakeup_count;
+static volatile int g_ready_task_alive;
+static volatile bool g_ready_task_stop;
+
 static int yield_task_1(int a, char *b[])
 {
 	int cnt = SWITCHING_ITERATIONS;
@@ -61,6 +83,114 @@ static int yield_task_2(int a, char *b[])
 	return 0;
 }
 
+static uint64_t elapsed_ns(struct timespec *from, struct timespec *to)
+{
+	return (uint64_t)(to->tv_sec - from->tv_sec) * 1000000000ULL + to->tv_nsec - from->tv_nsec;
+}
+
+static int ready_task(int argc, char *argv[])
+{
+	/* Wait at the gate, the measuring task opens it to make this task ready */
+
+	for (;;) {
+		sem_wait(&g_ready_sem);
+		if (g_ready_task_stop) {
+			break;
+		}
+	}
+
+	g_ready_task_alive--;
+
+	return 0;
+}
+
+static int wakeup_task(int argc, char *argv[])
+{
+	while (g_wakeup_count < LATENCY_ITERATIONS) {
+		sem_wait(&g_wakeup_sem);
+		g_wakeup_count++;
+	}
+
+	return 0;
+}
+
+static void measure_wakeup_latency(int ready_task_num)
+{
+	struct timespec start;
+	struct timespec end;
+	uint64_t wakeup_ns = 0;
+	int cnt;
+	int idx;
+
+	g_wakeup_count = 0;
+	g_ready_task_alive = 0;
+	g_ready_task_stop = false;
+
+	/* The created tasks have higher priorities, so they run right away and
+	 * block at their semaphores before task_create() returns.
+	 */
+
+	for (cnt = 0; cnt < ready_task_num; cnt++) {
+		if (task_create("ready_task", LATENCY_PRIORITY + 2 + cnt, LATENCY_STACKSIZE, ready_task, NULL) < 0) {
+			break;
+		}
+		g_ready_task_alive++;
+	}
+
+	if (cnt == ready_task_num && task_create("wakeup_task", LATENCY_PRIORITY + 1, LATENCY_STACKSIZE, wakeup_task, NULL) >= 0) {
+		for (cnt = 0; cnt < LATENCY_ITERATIONS; cnt++) {
+			/* With the scheduler locked, every woken task is queued by
+			 * priority and none of them runs until sched_unlock().
+			 */
+
+			sched_lock();
+
+			for (idx = 0; idx < ready_task_num; idx++) {
+				sem_post(&g_ready_sem);
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			sem_post(&g_wakeup_sem);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			wakeup_ns += elapsed_ns(&start, &end);
+
+			/* All of them run and block again before this task resumes */
+
+			sched_unlock();
+		}
+
+		printf("%3d ready tasks: Average Wakeup Time is %lu ns (%d wakeups)\n", ready_task_num, (unsigned long)(wakeup_ns / LATENCY_ITERATIONS), g_wakeup_count);
+	} else {
+		printf("%3d ready tasks: skipped, failed to create the tasks\n", ready_task_num);
+	}
+
+	g_ready_task_stop = true;
+	while (g_ready_task_alive > 0) {
+		sem_post(&g_ready_sem);
+	}
+}
+
+static int latency_task(int argc, char *argv[])
+{
+	unsigned int idx;
+
+	/* They are used for signaling, priority inheritance does not apply */
+
+	sem_init(&g_ready_sem, 0, 0);
+	sem_setprotocol(&g_ready_sem, SEM_PRIO_NONE);
+	sem_init(&g_wakeup_sem, 0, 0);
+	sem_setprotocol(&g_wakeup_sem, SEM_PRIO_NONE);
+
+	for (idx = 0; idx < sizeof(g_ready_task_nums) / sizeof(g_ready_task_nums[0]); idx++) {
+		measure_wakeup_latency(g_ready_task_nums[idx]);
+	}
+
+	sem_destroy(&g_wakeup_sem);
+	sem_destroy(&g_ready_sem);
+
+	return 0;
+}
+
 #ifdef CONFIG_BUILD_KERNEL
 int main(int argc, FAR char *argv[])
 #else
@@ -75,6 +205,10 @@ int ctx_switch_main(int argc, char *argv[])
 	task_create("A_Task", SCHED_PRIORITY_MAX, 1024, yield_task_1, NULL);
 	task_create("B_Task", SCHED_PRIORITY_MAX, 1024, yield_task_2, NULL);
 
+	/* This runs after the tasks above finish, as it has the lower priority */
+
+	task_create("Latency_Task", LATENCY_PRIORITY, 2048, latency_task, NULL);
+
 	sched_unlock();
 
 	return 0;
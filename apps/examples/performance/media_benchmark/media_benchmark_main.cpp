@@ -0,0 +1,486 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+
+#include <media/MediaPlayer.h>
+#include <media/MediaPlayerObserverInterface.h>
+#include <media/FileInputDataSource.h>
+#include <media/MediaTypes.h>
+#include <media/MediaUtils.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_MEDIA_BENCHMARK_PATH
+#define CONFIG_EXAMPLES_MEDIA_BENCHMARK_PATH "/mnt"
+#endif
+
+#ifndef CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION
+#define CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION 2
+#endif
+
+#define MEDIA_BENCHMARK_CHUNK_FRAMES 256
+#define MEDIA_BENCHMARK_TIMEOUT_SEC 60
+
+#if defined(CONFIG_CONTAINER_MPEG2TS) && defined(CONFIG_AUDIO_CODEC)
+#define MEDIA_BENCHMARK_SEGMENT
+#endif
+
+/* Reference HLS segment: PAT, PMT and an MPEG-1 audio stream of silent
+ * 128kbps 44.1kHz stereo mp3 frames, several frames per PES packet.
+ */
+#define TS_PACKET_SIZE        188
+#define TS_HEADER_SIZE        4
+#define TS_PAT_PID            0x0000
+#define TS_PMT_PID            0x0100
+#define TS_AUDIO_PID          0x0101
+#define TS_PES_FRAMES         4
+#define MP3_FRAME_SIZE        417 /* 144 * 128000 / 44100 */
+#define MP3_FRAME_SAMPLES     1152
+#define MP3_FRAME_RATE        44100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct reference_stream_s {
+	unsigned int sampleRate;
+	unsigned int channels;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Reference streams generated as wav, chosen so that the pcm is passed
+ * through, remixed, resampled or both on the way to the output.
+ */
+static const struct reference_stream_s g_reference_streams[] = {
+	{16000, 2},
+	{16000, 1},
+	{44100, 2},
+	{48000, 1},
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* One observer per stream, so that a completion posted after a timed out
+ * stream was stopped cannot be taken for the end of the next stream.
+ */
+class BenchmarkObserver : public media::MediaPlayerObserverInterface, public std::enable_shared_from_this<BenchmarkObserver>
+{
+public:
+	BenchmarkObserver() : mError(false)
+	{
+		sem_init(&mDone, 0, 0);
+	}
+	~BenchmarkObserver()
+	{
+		sem_destroy(&mDone);
+	}
+	bool wait(const struct timespec *timeout)
+	{
+		return sem_timedwait(&mDone, timeout) == OK;
+	}
+	bool failed()
+	{
+		return mError;
+	}
+	void onPlaybackStarted(media::MediaPlayer &mediaPlayer) override
+	{
+	}
+	void onPlaybackFinished(media::MediaPlayer &mediaPlayer) override
+	{
+		sem_post(&mDone);
+	}
+	void onPlaybackError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+		printf("playback error : %d\n", error);
+		mError = true;
+		sem_post(&mDone);
+	}
+	void onStartError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+		printf("start error : %d\n", error);
+		mError = true;
+		sem_post(&mDone);
+	}
+	void onStopError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+	}
+	void onPauseError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+	}
+
+private:
+	sem_t mDone;
+	bool mError;
+};
+
+static unsigned int elapsed_ms(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static bool make_reference_stream(const char *path, const struct reference_stream_s *ref)
+{
+	int16_t chunk[MEDIA_BENCHMARK_CHUNK_FRAMES * 2];
+	unsigned int frames = ref->sampleRate * CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION;
+	unsigned int period = ref->sampleRate / 440;
+	unsigned int written = 0;
+	unsigned int i;
+	unsigned int ch;
+	FILE *fp;
+
+	fp = fopen(path, "w");
+	if (fp == NULL) {
+		printf("failed to create %s\n", path);
+		return false;
+	}
+
+	if (!media::utils::createWavHeader(fp)) {
+		fclose(fp);
+		return false;
+	}
+
+	/* A 440Hz triangle wave, the content does not matter to the pipeline */
+	while (written < frames) {
+		unsigned int n = frames - written;
+		if (n > MEDIA_BENCHMARK_CHUNK_FRAMES) {
+			n = MEDIA_BENCHMARK_CHUNK_FRAMES;
+		}
+		for (i = 0; i < n; i++) {
+			unsigned int phase = (written + i) % period;
+			int32_t level = (int32_t)(phase * 4 * 16000 / period);
+			int16_t sample = (int16_t)(level < 32000 ? level - 16000 : 48000 - level);
+			for (ch = 0; ch < ref->channels; ch++) {
+				chunk[i * ref->channels + ch] = sample;
+			}
+		}
+		if (fwrite(chunk, sizeof(int16_t) * ref->channels, n, fp) != n) {
+			printf("failed to write %s\n", path);
+			fclose(fp);
+			return false;
+		}
+		written += n;
+	}
+
+	if (!media::utils::writeWavHeader(fp, ref->channels, ref->sampleRate, media::AUDIO_FORMAT_TYPE_S16_LE, WAVE_HEADER_LENGTH + frames * ref->channels * sizeof(int16_t))) {
+		fclose(fp);
+		return false;
+	}
+
+	fclose(fp);
+	return true;
+}
+
+#ifdef MEDIA_BENCHMARK_SEGMENT
+/* CRC-32/MPEG-2 which PSI sections end with */
+static uint32_t ts_crc32(const uint8_t *data, size_t length)
+{
+	uint32_t crc = 0xffffffff;
+	int i;
+
+	while (length-- > 0) {
+		crc ^= (uint32_t)*data++ << 24;
+		for (i = 0; i < 8; i++) {
+			crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/* Write data as the payload of TS packets of pid, the first packet starts the unit.
+ * A short last packet is filled up by stuffing in its adaptation field.
+ */
+static bool write_ts_payload(FILE *fp, uint16_t pid, uint8_t *cc, const uint8_t *data, size_t length)
+{
+	uint8_t packet[TS_PACKET_SIZE];
+	bool start = true;
+
+	while (length > 0) {
+		size_t room = TS_PACKET_SIZE - TS_HEADER_SIZE;
+		size_t n = length < room ? length : room;
+		size_t offset = TS_HEADER_SIZE;
+
+		packet[0] = 0x47;
+		packet[1] = (start ? 0x40 : 0x00) | ((pid >> 8) & 0x1f);
+		packet[2] = pid & 0xff;
+		packet[3] = 0x10 | (*cc & 0x0f);
+		if (n < room) {
+			size_t stuffing = room - n - 1;
+			packet[3] |= 0x20;
+			packet[offset++] = (uint8_t)stuffing;
+			if (stuffing > 0) {
+				packet[offset++] = 0x00;
+				memset(&packet[offset], 0xff, stuffing - 1);
+				offset += stuffing - 1;
+			}
+		}
+		memcpy(&packet[offset], data, n);
+		if (fwrite(packet, 1, TS_PACKET_SIZE, fp) != TS_PACKET_SIZE) {
+			return false;
+		}
+
+		*cc = (*cc + 1) & 0x0f;
+		data += n;
+		length -= n;
+		start = false;
+	}
+	return true;
+}
+
+/* Write a PSI section, given without its CRC, in a single TS packet */
+static bool write_ts_section(FILE *fp, uint16_t pid, uint8_t *cc, const uint8_t *section, size_t length)
+{
+	uint8_t payload[TS_PACKET_SIZE - TS_HEADER_SIZE];
+	uint32_t crc;
+
+	memset(payload, 0xff, sizeof(payload));
+	payload[0] = 0x00; /* pointer_field */
+	memcpy(&payload[1], section, length);
+	crc = ts_crc32(section, length);
+	payload[1 + length] = (uint8_t)(crc >> 24);
+	payload[2 + length] = (uint8_t)(crc >> 16);
+	payload[3 + length] = (uint8_t)(crc >> 8);
+	payload[4 + length] = (uint8_t)crc;
+	return write_ts_payload(fp, pid, cc, payload, sizeof(payload));
+}
+
+static bool make_reference_segment(const char *path, unsigned int *audio_ms)
+{
+	static const uint8_t pat[] = {
+		0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1, 0x00, 0x00,
+		0x00, 0x01, 0xe0 | (TS_PMT_PID >> 8), TS_PMT_PID & 0xff
+	};
+	static const uint8_t pmt[] = {
+		0x02, 0xb0, 0x12, 0x00, 0x01, 0xc1, 0x00, 0x00,
+		0xe0 | (TS_AUDIO_PID >> 8), TS_AUDIO_PID & 0xff, 0xf0, 0x00,
+		0x03, 0xe0 | (TS_AUDIO_PID >> 8), TS_AUDIO_PID & 0xff, 0xf0, 0x00
+	};
+	/* MPEG-1 layer III frame header, no crc; all zero side info decodes to silence */
+	static const uint8_t frame_header[] = { 0xff, 0xfb, 0x90, 0x00 };
+	unsigned int frames = MP3_FRAME_RATE * CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION / MP3_FRAME_SAMPLES;
+	size_t pes_size = 9 + TS_PES_FRAMES * MP3_FRAME_SIZE;
+	uint8_t pat_cc = 0;
+	uint8_t pmt_cc = 0;
+	uint8_t audio_cc = 0;
+	unsigned int written = 0;
+	unsigned int i;
+	uint8_t *pes;
+	bool ret = false;
+	FILE *fp;
+
+	pes = new uint8_t[pes_size];
+	if (pes == NULL) {
+		return false;
+	}
+
+	fp = fopen(path, "w");
+	if (fp == NULL) {
+		printf("failed to create %s\n", path);
+		delete[] pes;
+		return false;
+	}
+
+	if (!write_ts_section(fp, TS_PAT_PID, &pat_cc, pat, sizeof(pat)) || !write_ts_section(fp, TS_PMT_PID, &pmt_cc, pmt, sizeof(pmt))) {
+		goto errout;
+	}
+
+	while (written < frames) {
+		unsigned int n = frames - written;
+		if (n > TS_PES_FRAMES) {
+			n = TS_PES_FRAMES;
+		}
+		size_t size = 9 + n * MP3_FRAME_SIZE;
+
+		/* audio stream 0, PES_packet_length, no PTS */
+		memset(pes, 0, size);
+		pes[2] = 0x01;
+		pes[3] = 0xc0;
+		pes[4] = (uint8_t)((size - 6) >> 8);
+		pes[5] = (uint8_t)(size - 6);
+		pes[6] = 0x80;
+		for (i = 0; i < n; i++) {
+			memcpy(&pes[9 + i * MP3_FRAME_SIZE], frame_header, sizeof(frame_header));
+		}
+		if (!write_ts_payload(fp, TS_AUDIO_PID, &audio_cc, pes, size)) {
+			goto errout;
+		}
+		written += n;
+	}
+
+	*audio_ms = frames * MP3_FRAME_SAMPLES * 1000 / MP3_FRAME_RATE;
+	ret = true;
+
+errout:
+	if (!ret) {
+		printf("failed to write %s\n", path);
+	}
+	fclose(fp);
+	delete[] pes;
+	return ret;
+}
+#endif
+
+static void print_result(const char *name, unsigned int audio_ms, unsigned int wall_ms, const media::player_statistics_t *stats)
+{
+	printf("\n[%s]\n", name);
+	printf("  elapsed          : %u ms", wall_ms);
+	if (audio_ms > 0 && wall_ms > 0) {
+		/* how many times faster than real time the pipeline ran */
+		printf(" for %u ms of audio, x%u.%02u", audio_ms, audio_ms / wall_ms, (audio_ms % wall_ms) * 100 / wall_ms);
+	}
+	printf("\n");
+	printf("  input            : %u bytes, %u KB/s\n", stats->inputBytes, wall_ms ? stats->inputBytes / wall_ms : 0);
+	printf("  read             : %u ms total, %u us max\n", (unsigned int)(stats->inputTime / 1000), stats->inputTimeMax);
+	if (stats->demuxedBytes > 0) {
+		unsigned int demux_ms = (unsigned int)(stats->demuxTime / 1000);
+		/* bytes per ms is about KB/s */
+		printf("  demux            : %u ES bytes, %u ms total, %u us max, %u KB/s\n", stats->demuxedBytes, demux_ms, stats->demuxTimeMax, demux_ms ? stats->demuxedBytes / demux_ms : 0);
+	}
+	printf("  decode           : %u frames, %u us avg, %u us max\n", stats->decodedFrames, stats->decodedFrames ? (unsigned int)(stats->decodeTime / stats->decodedFrames) : 0, stats->decodeTimeMax);
+	printf("  resync           : %u times, %u ms total\n", stats->resyncs, (unsigned int)(stats->resyncTime / 1000));
+	printf("  output (convert) : %u writes, %u us avg, %u us max\n", stats->outputWrites, stats->outputWrites ? (unsigned int)(stats->outputTime / stats->outputWrites) : 0, stats->outputTimeMax);
+	printf("  buffer latency   : %u us last, %u us max\n", stats->latency, stats->latencyMax);
+	printf("  buffer level     : %u / %u min, %u max\n", stats->bufferLevelMin, stats->bufferSize, stats->bufferLevelMax);
+	/* xruns are counted for all output streams together */
+	printf("  underruns, xruns : %u, %u\n", stats->underruns, stats->xruns);
+}
+
+static bool run_stream(const char *name, std::unique_ptr<media::stream::FileInputDataSource> source, unsigned int audio_ms)
+{
+	media::MediaPlayer mp;
+	auto observer = std::make_shared<BenchmarkObserver>();
+	media::player_statistics_t stats;
+	struct timespec start;
+	struct timespec timeout;
+	unsigned int wall_ms;
+	bool ret = false;
+
+	if (mp.create() != media::PLAYER_OK) {
+		printf("MediaPlayer::create failed\n");
+		return false;
+	}
+
+	mp.setObserver(observer);
+	if (mp.setDataSource(std::move(source)) != media::PLAYER_OK || mp.prepare() != media::PLAYER_OK) {
+		printf("failed to prepare %s\n", name);
+		goto errout_with_create;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (mp.start() != media::PLAYER_OK) {
+		printf("MediaPlayer::start failed\n");
+		goto errout_with_prepare;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	timeout.tv_sec += MEDIA_BENCHMARK_TIMEOUT_SEC;
+	if (!observer->wait(&timeout)) {
+		printf("%s did not finish in %d seconds\n", name, MEDIA_BENCHMARK_TIMEOUT_SEC);
+		mp.stop();
+		goto errout_with_prepare;
+	}
+	wall_ms = elapsed_ms(&start);
+
+	if (!observer->failed() && mp.getStatistics(&stats) == media::PLAYER_OK) {
+		print_result(name, audio_ms, wall_ms, &stats);
+		ret = true;
+	}
+
+errout_with_prepare:
+	mp.unprepare();
+errout_with_create:
+	mp.destroy();
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+extern "C" {
+int media_benchmark_main(int argc, char *argv[])
+{
+	char path[64];
+	unsigned int i;
+	int failed = 0;
+
+	printf("media pipeline benchmark, %d seconds per reference stream\n", CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION);
+
+	for (i = 0; i < sizeof(g_reference_streams) / sizeof(g_reference_streams[0]); i++) {
+		const struct reference_stream_s *ref = &g_reference_streams[i];
+
+		snprintf(path, sizeof(path), "%s/bench_%u_%u.wav", CONFIG_EXAMPLES_MEDIA_BENCHMARK_PATH, ref->sampleRate, ref->channels);
+		if (!make_reference_stream(path, ref)) {
+			failed++;
+			continue;
+		}
+
+		auto source = std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(path));
+		if (!run_stream(path, std::move(source), CONFIG_EXAMPLES_MEDIA_BENCHMARK_DURATION * 1000)) {
+			failed++;
+		}
+		unlink(path);
+	}
+
+#ifdef MEDIA_BENCHMARK_SEGMENT
+	unsigned int segment_ms;
+
+	snprintf(path, sizeof(path), "%s/bench_segment.ts", CONFIG_EXAMPLES_MEDIA_BENCHMARK_PATH);
+	if (make_reference_segment(path, &segment_ms)) {
+		auto source = std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(path));
+		if (!run_stream(path, std::move(source), segment_ms)) {
+			failed++;
+		}
+		unlink(path);
+	} else {
+		failed++;
+	}
+#endif
+
+	/* Encoded reference streams (opus, mp3, aac, ts...) are given as arguments */
+	for (i = 1; i < (unsigned int)argc; i++) {
+		auto source = std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(argv[i]));
+		if (!run_stream(argv[i], std::move(source), 0)) {
+			failed++;
+		}
+	}
+
+	printf("\nmedia pipeline benchmark done, %d failed\n", failed);
+	return failed ? -1 : 0;
+}
+}
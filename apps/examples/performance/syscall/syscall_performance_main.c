@@ -28,6 +28,7 @@
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #define NUM_LOOPS	1000000
 #define SEC_10	10
@@ -173,6 +174,30 @@ static void syscall_perf_timer_settime(void)
 	measure_performance(timer_settime, 4, timer_id, 0, NULL, NULL);
 }
 
+/*
+ * @fn                   :open_close
+ * @description          :Open and close a path, the unit measured below
+ * @return               :void
+ */
+static void open_close(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+/*
+ * @fn                   :syscall_perf_open_close
+ * @description          :Measuring performance for open + close of a device node
+ * @return               :void
+ */
+static void syscall_perf_open_close(void)
+{
+	measure_performance(open_close, 7, "/dev/console");
+}
+
 /****************************************************************************
  * Name: Syscall Performance
  ****************************************************************************/
@@ -213,5 +238,10 @@ int syscall_performance_main(void)
 	syscall_perf_mq_open();
 	sched_unlock();
 
+	/* System Call 7 */
+	sched_lock();
+	syscall_perf_open_close();
+	sched_unlock();
+
 	return 0;
 }
@@ -694,6 +694,82 @@ static void utc_audio_pcm_readi_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         audio_pcm_readi_begin_p
+* @brief            consume recorded samples straight from a lent capture buffer
+* @scenario         get a recorded buffer and give all of its frames back
+* @apicovered       pcm_readi_begin, pcm_readi_commit
+* @precondition     NA
+* @postcondition    NA
+*/
+
+static void utc_audio_pcm_readi_begin_p(void)
+{
+	int ret;
+	void *buffer = NULL;
+	unsigned int frames;
+
+	g_pcm = pcm_open(0, 0, PCM_IN, NULL);
+	TC_ASSERT_GT("pcm_readi_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	frames = pcm_get_buffer_size(g_pcm);
+	ret = pcm_readi_begin(g_pcm, &buffer, &frames);
+	TC_ASSERT_EQ_CLEANUP("pcm_readi_begin", ret, 0, clean_all_data(0, NULL));
+	TC_ASSERT_NEQ_CLEANUP("pcm_readi_begin", buffer, NULL, clean_all_data(0, NULL));
+	TC_ASSERT_GT_CLEANUP("pcm_readi_begin", frames, 0, clean_all_data(0, NULL));
+
+	ret = pcm_readi_commit(g_pcm, frames);
+	TC_ASSERT_EQ_CLEANUP("pcm_readi_commit", ret, frames, clean_all_data(0, NULL));
+
+	pcm_drop(g_pcm);
+	clean_all_data(0, NULL);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         audio_pcm_readi_begin_n
+* @brief            consume recorded samples straight from a lent capture buffer
+* @scenario         pass invalid parameters, use a playback pcm or commit without begin
+* @apicovered       pcm_readi_begin, pcm_readi_commit
+* @precondition     NA
+* @postcondition    NA
+*/
+
+static void utc_audio_pcm_readi_begin_n(void)
+{
+	int ret;
+	void *buffer;
+	unsigned int frames = 1;
+
+	ret = pcm_readi_begin(NULL, &buffer, &frames);
+	TC_ASSERT_LT("pcm_readi_begin", ret, 0);
+
+	ret = pcm_readi_commit(NULL, frames);
+	TC_ASSERT_LT("pcm_readi_commit", ret, 0);
+
+	g_pcm = pcm_open(0, 0, PCM_IN, NULL);
+	TC_ASSERT_GT("pcm_readi_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	ret = pcm_readi_begin(g_pcm, NULL, &frames);
+	TC_ASSERT_LT_CLEANUP("pcm_readi_begin", ret, 0, clean_all_data(0, NULL));
+
+	ret = pcm_readi_begin(g_pcm, &buffer, NULL);
+	TC_ASSERT_LT_CLEANUP("pcm_readi_begin", ret, 0, clean_all_data(0, NULL));
+
+	ret = pcm_readi_commit(g_pcm, frames);
+	TC_ASSERT_LT_CLEANUP("pcm_readi_commit", ret, 0, clean_all_data(0, NULL));
+	clean_all_data(0, NULL);
+
+	g_pcm = pcm_open(0, 0, PCM_OUT, NULL);
+	TC_ASSERT_GT("pcm_readi_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	ret = pcm_readi_begin(g_pcm, &buffer, &frames);
+	TC_ASSERT_LT_CLEANUP("pcm_readi_begin", ret, 0, clean_all_data(0, NULL));
+
+	clean_all_data(0, NULL);
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         audio_pcm_drop_p
 * @brief            drop all the buffers which are being processed and stop the device
@@ -925,6 +1001,80 @@ static void utc_audio_pcm_writei_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         audio_pcm_writei_begin_p
+* @brief            render samples straight into a lent playback buffer
+* @scenario         get a free buffer, fill it with silence and enqueue it
+* @apicovered       pcm_writei_begin, pcm_writei_commit
+* @precondition     NA
+* @postcondition    NA
+*/
+
+static void utc_audio_pcm_writei_begin_p(void)
+{
+	int ret;
+	void *buffer = NULL;
+	unsigned int frames;
+
+	g_pcm = pcm_open(0, 0, PCM_OUT, NULL);
+	TC_ASSERT_GT("pcm_writei_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	frames = pcm_get_buffer_size(g_pcm);
+	ret = pcm_writei_begin(g_pcm, &buffer, &frames);
+	TC_ASSERT_EQ_CLEANUP("pcm_writei_begin", ret, 0, clean_all_data(0, NULL));
+	TC_ASSERT_NEQ_CLEANUP("pcm_writei_begin", buffer, NULL, clean_all_data(0, NULL));
+	TC_ASSERT_GT_CLEANUP("pcm_writei_begin", frames, 0, clean_all_data(0, NULL));
+
+	memset(buffer, 0, pcm_frames_to_bytes(g_pcm, frames));
+	ret = pcm_writei_commit(g_pcm, frames);
+	TC_ASSERT_EQ_CLEANUP("pcm_writei_commit", ret, frames, clean_all_data(0, NULL));
+
+	pcm_drop(g_pcm);
+	clean_all_data(0, NULL);
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         audio_pcm_writei_begin_n
+* @brief            render samples straight into a lent playback buffer
+* @scenario         pass invalid parameters, use a capture pcm or commit without begin
+* @apicovered       pcm_writei_begin, pcm_writei_commit
+* @precondition     NA
+* @postcondition    NA
+*/
+
+static void utc_audio_pcm_writei_begin_n(void)
+{
+	int ret;
+	void *buffer;
+	unsigned int frames = 1;
+
+	ret = pcm_writei_begin(NULL, &buffer, &frames);
+	TC_ASSERT_LT("pcm_writei_begin", ret, 0);
+
+	g_pcm = pcm_open(0, 0, PCM_OUT, NULL);
+	TC_ASSERT_GT("pcm_writei_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	ret = pcm_writei_begin(g_pcm, NULL, &frames);
+	TC_ASSERT_LT_CLEANUP("pcm_writei_begin", ret, 0, clean_all_data(0, NULL));
+
+	ret = pcm_writei_begin(g_pcm, &buffer, NULL);
+	TC_ASSERT_LT_CLEANUP("pcm_writei_begin", ret, 0, clean_all_data(0, NULL));
+
+	ret = pcm_writei_commit(g_pcm, frames);
+	TC_ASSERT_LT_CLEANUP("pcm_writei_commit", ret, 0, clean_all_data(0, NULL));
+	clean_all_data(0, NULL);
+
+	g_pcm = pcm_open(0, 0, PCM_IN, NULL);
+	TC_ASSERT_GT("pcm_writei_begin", pcm_get_file_descriptor(g_pcm), 0);
+
+	ret = pcm_writei_begin(g_pcm, &buffer, &frames);
+	TC_ASSERT_LT_CLEANUP("pcm_writei_begin", ret, 0, clean_all_data(0, NULL));
+
+	clean_all_data(0, NULL);
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         audio_pcm_drain_p
 * @brief            play/record all enqueued buffers and stop the device
@@ -1499,6 +1649,8 @@ int utc_audio_main(int argc, char *argv[])
 #ifndef CONFIG_DISABLE_MANUAL_TESTCASE
 	utc_audio_pcm_readi_p();
 	utc_audio_pcm_readi_n();
+	utc_audio_pcm_readi_begin_p();
+	utc_audio_pcm_readi_begin_n();
 
 	/* writei_p and drain_p should be executed together since drain needs writei for testing.
 	  drain_p includes the cleanup part needed by writei to exit cleanly 
@@ -1506,6 +1658,8 @@ int utc_audio_main(int argc, char *argv[])
 	utc_audio_pcm_writei_p();
 	utc_audio_pcm_drain_p();
 	utc_audio_pcm_writei_n();
+	utc_audio_pcm_writei_begin_p();
+	utc_audio_pcm_writei_begin_n();
 	utc_audio_pcm_drain_n();
 	utc_audio_pcm_drop_p();
 	utc_audio_pcm_drop_n();
@@ -19,6 +19,8 @@
 #include <media/FileOutputDataSource.h>
 #include "tc_common.h"
 #include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
 
 using namespace std;
 using namespace media;
@@ -209,6 +211,56 @@ static void utc_media_FileOutputDataSource_write_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+static uint32_t read_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void utc_media_FileOutputDataSource_write_async_p(void)
+{
+	FileOutputDataSource dataSource(channels, sampleRate, pcmFormat, filePaths[1]);
+	/* More than the whole writer pool, with a tail that does not fill a buffer */
+	const size_t total = CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE * CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT * 2 + 100;
+	unsigned char chunk[300];
+	unsigned char header[WAVE_HEADER_LENGTH];
+	struct stat st;
+	size_t written = 0;
+	FILE *fp;
+
+	memset(chunk, 0x5a, sizeof(chunk));
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", dataSource.open(), true);
+	while (written < total) {
+		size_t len = total - written;
+		if (len > sizeof(chunk)) {
+			len = sizeof(chunk);
+		}
+		TC_ASSERT_EQ_CLEANUP("utc_media_FileOutputDataSource_write_async", dataSource.write(chunk, len), (ssize_t)len, dataSource.close(); remove(filePaths[1]));
+		written += len;
+	}
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileOutputDataSource_write_async", dataSource.close(), true, remove(filePaths[1]));
+
+	/* Everything queued to the writer is in the file, and the header describes it */
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileOutputDataSource_write_async", stat(filePaths[1], &st), 0, remove(filePaths[1]));
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileOutputDataSource_write_async", (size_t)st.st_size, WAVE_HEADER_LENGTH + total, remove(filePaths[1]));
+
+	fp = fopen(filePaths[1], "rb");
+	TC_ASSERT_CLEANUP("utc_media_FileOutputDataSource_write_async", fp != NULL, remove(filePaths[1]));
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileOutputDataSource_write_async", fread(header, 1, WAVE_HEADER_LENGTH, fp), WAVE_HEADER_LENGTH, fclose(fp); remove(filePaths[1]));
+	fclose(fp);
+	remove(filePaths[1]);
+
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", memcmp(header, "RIFF", 4), 0);
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", read_le32(header + 4), WAVE_HEADER_LENGTH + total - 8);
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", memcmp(header + 8, "WAVE", 4), 0);
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", read_le32(header + 24), sampleRate);
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", memcmp(header + 36, "data", 4), 0);
+	TC_ASSERT_EQ("utc_media_FileOutputDataSource_write_async", read_le32(header + 40), total);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 int utc_media_fileoutputdatasource_main(void)
 {
 	utc_media_FileOutputDataSource_getChannels_p();
@@ -235,6 +287,9 @@ int utc_media_fileoutputdatasource_main(void)
 
 	utc_media_FileOutputDataSource_write_p();
 	utc_media_FileOutputDataSource_write_n();
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	utc_media_FileOutputDataSource_write_async_p();
+#endif
 
 	return 0;
 }
@@ -221,6 +221,129 @@ static void utc_media_MediaPlayer_setDataSource_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+static void utc_media_MediaPlayer_setNextDataSource_p(void)
+{
+	media::MediaPlayer mp;
+	auto source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	mp.create();
+	mp.setDataSource(std::move(source));
+	mp.prepare();
+
+	source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setNextDataSource", mp.setNextDataSource(std::move(source)), media::PLAYER_OK, goto cleanup);
+
+	/* replace the pending one */
+	source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setNextDataSource", mp.setNextDataSource(std::move(source)), media::PLAYER_OK, goto cleanup);
+
+	/* clear the pending one */
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_setNextDataSource", mp.setNextDataSource(nullptr), media::PLAYER_OK, goto cleanup);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mp.unprepare();
+	mp.destroy();
+}
+
+static void utc_media_MediaPlayer_setNextDataSource_n(void)
+{
+	/* setNextDataSource without create */
+	{
+		media::MediaPlayer mp;
+		auto source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+
+		TC_ASSERT_NEQ("utc_media_MediaPlayer_setNextDataSource", mp.setNextDataSource(std::move(source)), media::PLAYER_OK);
+	}
+
+	/* setNextDataSource before prepare */
+	{
+		media::MediaPlayer mp;
+		auto source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+		mp.create();
+		mp.setDataSource(std::move(source));
+
+		source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+		TC_ASSERT_NEQ_CLEANUP("utc_media_MediaPlayer_setNextDataSource", mp.setNextDataSource(std::move(source)), media::PLAYER_OK, mp.destroy());
+
+		mp.destroy();
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+class TrackObserver : public media::MediaPlayerObserverInterface
+{
+public:
+	TrackObserver() : trackChanged(0), finished(false) {}
+	void onPlaybackStarted(media::MediaPlayer &mediaPlayer) override {}
+	void onPlaybackFinished(media::MediaPlayer &mediaPlayer) override
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		finished = true;
+		cv.notify_one();
+	}
+	void onPlaybackError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+		onPlaybackFinished(mediaPlayer);
+	}
+	void onStartError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override
+	{
+		onPlaybackFinished(mediaPlayer);
+	}
+	void onStopError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onPauseError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onPlaybackTrackChanged(media::MediaPlayer &mediaPlayer) override
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		trackChanged++;
+	}
+	bool waitFinished(int sec)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		return cv.wait_for(lock, std::chrono::seconds(sec), [this] { return finished; });
+	}
+	int getTrackChanged()
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		return trackChanged;
+	}
+private:
+	std::mutex mtx;
+	std::condition_variable cv;
+	int trackChanged;
+	bool finished;
+};
+
+static void utc_media_MediaPlayer_onPlaybackTrackChanged_p(void)
+{
+	media::MediaPlayer mp;
+	auto observer = std::make_shared<TrackObserver>();
+	bool finished;
+	auto source = std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath));
+	source->setSampleRate(16000);
+	source->setChannels(1);
+	mp.create();
+	mp.setObserver(observer);
+	mp.setDataSource(std::move(source));
+	mp.prepare();
+
+	/* two short streams played back to back */
+	source = std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath));
+	source->setSampleRate(16000);
+	source->setChannels(1);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_onPlaybackTrackChanged", mp.setNextDataSource(std::move(source)), media::PLAYER_OK, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_onPlaybackTrackChanged", mp.start(), media::PLAYER_OK, goto cleanup);
+
+	finished = observer->waitFinished(10);
+	TC_ASSERT_CLEANUP("utc_media_MediaPlayer_onPlaybackTrackChanged", finished, mp.stop(); goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_onPlaybackTrackChanged", observer->getTrackChanged(), 1, goto cleanup);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mp.unprepare();
+	mp.destroy();
+}
+
 static void utc_media_MediaPlayer_setObserver_p(void)
 {
 	media::MediaPlayer mp;
@@ -641,6 +764,39 @@ static void utc_media_MediaPlayer_isPlaying_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_MEDIA_STATISTICS
+static void utc_media_MediaPlayer_getStatistics_p(void)
+{
+	media::MediaPlayer mp;
+	media::player_statistics_t stats;
+	std::unique_ptr<media::stream::FileInputDataSource> source = std::move(std::unique_ptr<media::stream::FileInputDataSource>(new media::stream::FileInputDataSource(dummyfilepath)));
+	mp.create();
+	mp.setDataSource(std::move(source));
+	mp.prepare();
+
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getStatistics", mp.getStatistics(&stats), media::PLAYER_OK, goto cleanup);
+
+	/* nothing is written to the output before start */
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getStatistics", stats.outputWrites, 0, goto cleanup);
+
+	TC_SUCCESS_RESULT();
+cleanup:
+	mp.unprepare();
+	mp.destroy();
+}
+#endif
+
+static void utc_media_MediaPlayer_getStatistics_n(void)
+{
+	media::MediaPlayer mp;
+	mp.create();
+
+	TC_ASSERT_NEQ_CLEANUP("utc_media_MediaPlayer_getStatistics", mp.getStatistics(nullptr), media::PLAYER_OK, mp.destroy());
+
+	mp.destroy();
+	TC_SUCCESS_RESULT();
+}
+
 static void utc_media_MediaPlayer_operator_equal_p(void)
 {
 	media::MediaPlayer mp;
@@ -678,6 +834,11 @@ int utc_media_MediaPlayer_main(void)
 	utc_media_MediaPlayer_prepare_p();
 	utc_media_MediaPlayer_prepare_n();
 
+	utc_media_MediaPlayer_setNextDataSource_p();
+	utc_media_MediaPlayer_setNextDataSource_n();
+
+	utc_media_MediaPlayer_onPlaybackTrackChanged_p();
+
 	utc_media_MediaPlayer_prepareAsync_p();
 	utc_media_MediaPlayer_prepareAsync_n();
 
@@ -705,6 +866,11 @@ int utc_media_MediaPlayer_main(void)
 	utc_media_MediaPlayer_isPlaying_p();
 	utc_media_MediaPlayer_isPlaying_n();
 
+#ifdef CONFIG_MEDIA_STATISTICS
+	utc_media_MediaPlayer_getStatistics_p();
+#endif
+	utc_media_MediaPlayer_getStatistics_n();
+
 	utc_media_MediaPlayer_operator_equal_p();
 	utc_media_MediaPlayer_operator_equal_n();
 
@@ -235,6 +235,61 @@ static void utc_media_SpeechDetector_waitEndPoint_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+static void utc_media_SpeechDetector_initPreRoll_p(void)
+{
+	auto instance = media::voice::SpeechDetector::instance();
+	bool ret = instance->initPreRoll(TEST_SAMPLE_RATE, TEST_CHANNELS, 100);
+	TC_ASSERT_EQ("utc_media_SpeechDetector_initPreRoll", ret, true);
+	TC_SUCCESS_RESULT();
+	instance->deinitPreRoll();
+}
+
+static void utc_media_SpeechDetector_initPreRoll_n(void)
+{
+	auto instance = media::voice::SpeechDetector::instance();
+	bool ret = instance->initPreRoll(TEST_SAMPLE_RATE, TEST_CHANNELS, 0);
+	TC_ASSERT_EQ("utc_media_SpeechDetector_initPreRoll", ret, false);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_SpeechDetector_readPreRoll_p(void)
+{
+	/* 1ms ring at 16kHz stereo holds 32 samples */
+	short sample[48];
+	short out[48];
+	auto instance = media::voice::SpeechDetector::instance();
+	instance->initPreRoll(TEST_SAMPLE_RATE, TEST_CHANNELS, 1);
+	for (int i = 0; i < 48; i++) {
+		sample[i] = (short)i;
+	}
+
+	/* Only the latest 32 samples are kept, oldest first */
+	instance->capturePreRoll(sample, 24);
+	instance->capturePreRoll(sample + 24, 24);
+	int ret = instance->readPreRoll(out, 48);
+	TC_ASSERT_EQ_CLEANUP("utc_media_SpeechDetector_readPreRoll", ret, 32, instance->deinitPreRoll());
+	TC_ASSERT_EQ_CLEANUP("utc_media_SpeechDetector_readPreRoll", out[0], 16, instance->deinitPreRoll());
+	TC_ASSERT_EQ_CLEANUP("utc_media_SpeechDetector_readPreRoll", out[31], 47, instance->deinitPreRoll());
+
+	/* Samples read are removed from the ring */
+	ret = instance->readPreRoll(out, 48);
+	instance->deinitPreRoll();
+	TC_ASSERT_EQ("utc_media_SpeechDetector_readPreRoll", ret, 0);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_SpeechDetector_readPreRoll_n(void)
+{
+	short out[16];
+	auto instance = media::voice::SpeechDetector::instance();
+	int ret = instance->readPreRoll(out, 16);
+	TC_ASSERT_EQ("utc_media_SpeechDetector_readPreRoll", ret, 0);
+	bool captured = instance->capturePreRoll(out, 16);
+	TC_ASSERT_EQ("utc_media_SpeechDetector_readPreRoll", captured, false);
+	TC_SUCCESS_RESULT();
+}
+
 int utc_media_SpeechDetector_main(void)
 {
 	utc_media_SpeechDetector_instance_p();
@@ -254,5 +309,9 @@ int utc_media_SpeechDetector_main(void)
 	utc_media_SpeechDetector_detectEndPoint_n();
 	utc_media_SpeechDetector_waitEndPoint_p();
 	utc_media_SpeechDetector_waitEndPoint_n();
+	utc_media_SpeechDetector_initPreRoll_p();
+	utc_media_SpeechDetector_initPreRoll_n();
+	utc_media_SpeechDetector_readPreRoll_p();
+	utc_media_SpeechDetector_readPreRoll_n();
 	return 0;
 }
@@ -32,6 +32,18 @@
 #include <araui/ui_commons.h>
 #include <araui/ui_widget.h>
 
+/**
+ * @brief Structure that represents the frame statistics of the AraUI Core Service
+ *
+ * @see ui_core_get_frame_stats()
+ */
+typedef struct {
+	uint32_t frame_count;      //!< number of frames rendered since ui_start()
+	uint32_t dropped_count;    //!< number of frame periods missed by slow frames
+	uint32_t last_frame_time;  //!< time taken by the latest frame in milliseconds
+	uint32_t max_frame_time;   //!< longest time taken by a frame in milliseconds
+} ui_frame_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -50,6 +62,17 @@ ui_error_t ui_start(void);
  */
 ui_error_t ui_stop(void);
 
+/**
+ * @brief Get the frame statistics of the AraUI Core Service.
+ *
+ * The frames are rendered only when some widget is changed or animated,
+ * so the frame count does not increase while the screen is idle.
+ *
+ * @param[out] stats Frame statistics.
+ * @return On success, UI_OK is returned. On failure, the defined error type is returned.
+ */
+ui_error_t ui_core_get_frame_stats(ui_frame_stats_t *stats);
+
 /**
  * @brief Set the quick panel to the certain event type.
  *
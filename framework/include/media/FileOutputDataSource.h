@@ -30,6 +30,9 @@
 #define __MEDIA_FILEOUTPUTDATASOURCE_H
 
 #include <media/OutputDataSource.h>
+#include <pthread.h>
+#include <mutex>
+#include <condition_variable>
 
 namespace media {
 namespace stream {
@@ -117,8 +120,27 @@ public:
 	ssize_t write(unsigned char *buf, size_t size) override;
 
 private:
+	bool startWriter();
+	void stopWriter();
+	void submitBuffer(std::unique_lock<std::mutex> &lock, bool closing = false);
+	static void *writerMain(void *arg);
+
 	std::string mDataPath;
 	FILE* mFp;
+
+	/* Background writer, used with CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC */
+	pthread_t mWriter;
+	std::mutex mMutex;
+	std::condition_variable mCondv;
+	unsigned char *mPool;
+	size_t *mLengths;
+	int mFill;
+	size_t mFillLen;
+	size_t mFillLimit;
+	int mPending;
+	size_t mUnsynced;
+	bool mWriterRunning;
+	bool mWriterError;
 };
 } // namespace stream
 } // namespace media
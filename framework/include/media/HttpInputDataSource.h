@@ -119,6 +119,18 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	ssize_t read(unsigned char *buf, size_t size) override;
+	/**
+	 * @brief Move the read position of the http source
+	 * @details @b #include <media/HttpInputDataSource.h>
+	 * The download is restarted from the offset with a range request, on the
+	 * connection kept by the previous download when the server allows it.
+	 * Called before open(), the source is opened from the offset.
+	 * It must not be called while read() is in progress, e.g. pause the player first.
+	 * param[in] offset byte offset from the start of the resource
+	 * @return True is Success, False is Fail (e.g. the server does not support ranges)
+	 * @since TizenRT v2.1 PRE
+	 */
+	bool seek(off_t offset);
 
 public:
 	/**
@@ -132,10 +144,14 @@ private:
 	static size_t HeaderCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static size_t WriteCallback(char *data, size_t size, size_t nmemb, void *userp);
 	static void *workerMain(void *arg);
+	bool startDownload();
+	void stopDownload();
 
 private:
 	std::string mContentType;
 	std::string mUrl;
+	off_t mOffset;
+	long mStatusCode;
 	pthread_t mThread;
 	std::mutex mMutex;
 	std::condition_variable mCondv;
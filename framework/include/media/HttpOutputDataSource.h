@@ -0,0 +1,168 @@
+/* ****************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @ingroup MEDIA
+ * @{
+ */
+
+/**
+ * @file media/HttpOutputDataSource.h
+ * @brief Media HttpOutputDataSource APIs
+ */
+
+#ifndef __MEDIA_HTTPOUTPUTDATASOURCE_H
+#define __MEDIA_HTTPOUTPUTDATASOURCE_H
+
+#include <media/OutputDataSource.h>
+#include <pthread.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef CONFIG_ENABLE_CURL
+#error CONFIG_ENABLE_CURL should be turn on to use HttpOutputDataSource class.
+#endif
+
+namespace media {
+namespace stream {
+
+class HttpStream;
+class StreamBuffer;
+class StreamBufferReader;
+class StreamBufferWriter;
+
+/**
+ * @class
+ * @brief This class is http output data structure
+ * @details @b #include <media/HttpOutputDataSource.h>
+ * The recorded data is posted to the url while recording, with chunked
+ * transfer encoding, so the length does not have to be known in advance.
+ * @since TizenRT v2.1 PRE
+ */
+class HttpOutputDataSource : public OutputDataSource
+{
+public:
+	/**
+	 * @brief Constructs an empty HttpOutputDataSource.
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * Delete the default construct
+	 * @since TizenRT v2.1 PRE
+	 */
+	HttpOutputDataSource() = delete;
+	/**
+	 * @brief Constructs a new object provide with url
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * param[in] url The URL the recorded data is posted to
+	 * @since TizenRT v2.1 PRE
+	 */
+	HttpOutputDataSource(const std::string &url);
+	/**
+	 * @brief Constructs a new object provide with audio configuration
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * param[in] channels   The channels that the channels of audio
+	 * param[in] sampleRate The sampleRate that the sample rate of audio
+	 * param[in] pcmFormat  The pcmFormat that the pcm format of audio
+	 * param[in] url        The URL the recorded data is posted to
+	 * @since TizenRT v2.1 PRE
+	 */
+	HttpOutputDataSource(unsigned int channels, unsigned int sampleRate, audio_format_type_t pcmFormat, const std::string &url);
+	/**
+	 * @brief Copy constructs for HttpOutputDataSource.
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * @since TizenRT v2.1 PRE
+	 */
+	HttpOutputDataSource(const HttpOutputDataSource &source);
+	/**
+	 * @brief Operator= for HttpOutputDataSource.
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * @since TizenRT v2.1 PRE
+	 */
+	HttpOutputDataSource &operator=(const HttpOutputDataSource &source);
+	/**
+	 * @brief Deconstructs an HttpOutputDataSource.
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual ~HttpOutputDataSource();
+
+	/**
+	 * @brief Adds an http header to the upload request, e.g. "Content-Type: audio/L16"
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * It should be called before open().
+	 * param[in] header The header line without CRLF
+	 * @since TizenRT v2.1 PRE
+	 */
+	void addHeader(const std::string &header);
+
+	/**
+	 * @brief Whether http upload is ready to be written.
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * @return True is ready, False is not ready
+	 * @since TizenRT v2.1 PRE
+	 */
+	bool isPrepared() override;
+	/**
+	 * @brief Start the http upload
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * @return True is Success, False is Fail
+	 * @since TizenRT v2.1 PRE
+	 */
+	bool open() override;
+	/**
+	 * @brief Finish the http upload
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * The data written so far is sent, then the upload is ended.
+	 * @return True is Success, False is Fail (the upload failed)
+	 * @since TizenRT v2.1 PRE
+	 */
+	bool close() override;
+
+	/**
+	 * @brief Puts the data to be uploaded
+	 * @details @b #include <media/HttpOutputDataSource.h>
+	 * Blocks while the upload buffer is full.
+	 * @param[in] buf The buf that buffer to be uploaded
+	 * @param[in] size The size that the size of the buffer
+	 * @return if there is nothing to write, it returns 0
+	 *         if error occurred, it returns -1, else written size returns
+	 * @since TizenRT v2.1 PRE
+	 */
+	ssize_t write(unsigned char *buf, size_t size) override;
+
+private:
+	static size_t ReadCallback(char *data, size_t size, size_t nmemb, void *userp);
+	static void *workerMain(void *arg);
+
+private:
+	std::string mUrl;
+	std::vector<std::string> mHeaders;
+	pthread_t mThread;
+	bool mIsUploading;
+	bool mUploadResult;
+	std::shared_ptr<HttpStream> mHttpStream;
+	std::shared_ptr<StreamBuffer> mStreamBuffer;
+	std::shared_ptr<StreamBufferReader> mBufferReader;
+	std::shared_ptr<StreamBufferWriter> mBufferWriter;
+};
+
+} // namespace stream
+} // namespace media
+
+#endif // __MEDIA_HTTPOUTPUTDATASOURCE_H
+/** @} */ // end of MEDIA group
@@ -30,6 +30,7 @@
 #ifndef __MEDIA_MEDIAPLAYER_H
 #define __MEDIA_MEDIAPLAYER_H
 
+#include <stdint.h>
 #include <memory>
 #include <media/stream_info.h>
 #include <media/InputDataSource.h>
@@ -59,6 +60,52 @@ typedef enum player_error_e player_error_t;
 const int PLAYER_OK = PLAYER_ERROR_NONE;
 typedef int player_result_t;
 
+/**
+ * @brief Measurements of the playback pipeline, collected since the data source was set
+ * @details @b #include <media/MediaPlayer.h>
+ * Times are in microseconds, with the resolution of the system clock. Total times are
+ * 64 bits wide, so that they do not wrap in a long playback.
+ * @since TizenRT v2.1 PRE
+ */
+struct player_statistics_s {
+	/** Bytes read from the data source */
+	unsigned int inputBytes;
+	/** Time spent in reading the data source, in total and the longest read */
+	uint64_t inputTime;
+	unsigned int inputTimeMax;
+	/** Elementary stream bytes given by the container demuxer, the time spent in it in total and the longest call */
+	unsigned int demuxedBytes;
+	uint64_t demuxTime;
+	unsigned int demuxTimeMax;
+	/** Frames given by the decoder */
+	unsigned int decodedFrames;
+	/** Time spent in the decoder, in total and the longest call */
+	uint64_t decodeTime;
+	unsigned int decodeTimeMax;
+	/** Times the decoder lost the frame sync and searched for the next frame, and the time spent searching */
+	unsigned int resyncs;
+	uint64_t resyncTime;
+	/** Size and fill level of the pcm buffer between decoder and output */
+	unsigned int bufferSize;
+	unsigned int bufferLevel;
+	unsigned int bufferLevelMin;
+	unsigned int bufferLevelMax;
+	/** Times the output found the pcm buffer empty */
+	unsigned int underruns;
+	/** Writes to the audio output, the time spent in them in total and the longest write */
+	unsigned int outputWrites;
+	uint64_t outputTime;
+	unsigned int outputTimeMax;
+	/** Time from reading data from the source to handing its pcm to the output, last and longest */
+	unsigned int latency;
+	unsigned int latencyMax;
+	/** Xruns recovered by the audio manager since the data source was set. The audio manager
+	 *  counts them for all output streams together, so xruns of other players are included. */
+	unsigned int xruns;
+};
+
+typedef struct player_statistics_s player_statistics_t;
+
 class MediaPlayerImpl;
 
 /**
@@ -199,6 +246,22 @@ public:
 	 */
 	player_result_t setDataSource(std::unique_ptr<stream::InputDataSource>);
 
+	/**
+	 * @brief Set the DataSource to be played right after the current one
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API
+	 * The next DataSource is opened and buffered in the background while the current one plays.
+	 * When the current DataSource reaches its end, playback goes on with the next one without
+	 * stopping, and onPlaybackTrackChanged is called. The audio output is kept open when both
+	 * DataSources have the same channels, sample rate and pcm format.
+	 * Setting another DataSource replaces the pending one, and nullptr clears it.
+	 * It can be called once the player is prepared.
+	 * @param[in] dataSource The dataSource that the config of input data
+	 * @return The result of the setNextDataSource operation
+	 * @since TizenRT v2.1 PRE
+	 */
+	player_result_t setNextDataSource(std::unique_ptr<stream::InputDataSource>);
+
 	/**
 	 * @brief Set the observer of MediaPlayer
 	 * @details @b #include <media/MediaPlayer.h>
@@ -228,6 +291,18 @@ public:
 	 * @since TizenRT v2.1 PRE
 	 */
 	bool isPlaying();
+
+	/**
+	 * @brief Get the measurements of the playback pipeline
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous API
+	 * They are reset when a data source is set, and are available with CONFIG_MEDIA_STATISTICS.
+	 * Those of every player can also be read from /proc/media.
+	 * @param[out] stats The measurements collected since the data source was set
+	 * @return The result of the getStatistics operation
+	 * @since TizenRT v2.1 PRE
+	 */
+	player_result_t getStatistics(player_statistics_t *stats);
 private:
 	std::shared_ptr<MediaPlayerImpl> mPMpImpl;
 	uint64_t mId;
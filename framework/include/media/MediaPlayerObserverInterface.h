@@ -134,6 +134,12 @@ public:
 	 * @since TizenRT v2.0
 	 */
 	virtual void onAsyncPrepared(MediaPlayer &mediaPlayer, player_error_t error) {}
+	/**
+	 * @brief informs the user that playback went on with the data source given by setNextDataSource.
+	 * @details @b #include <media/MediaPlayerObserverInterface.h>
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual void onPlaybackTrackChanged(MediaPlayer &mediaPlayer) {}
 };
 } // namespace media
 
@@ -118,6 +118,45 @@ public:
 	 * @since TizenRT v2.1 PRE
 	 */
 	virtual bool waitEndPoint(int timeout) = 0;
+
+	/**
+	 * @brief Init the pre-roll ring, which keeps the latest audio captured before a trigger
+	 * @details @b #include <media/voice/SpeechDetector.h>
+	 * The ring holds the last msec of audio fed by capturePreRoll(), so that the speech
+	 * preceding the keyword can be put in front of the recorded stream.
+	 * param[in] samprate sample rate of the captured audio
+	 * param[in] channels channels of the captured audio
+	 * param[in] msec length of the ring in millisecond
+	 * @return Return success if the pre-roll ring is successfully init
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual bool initPreRoll(uint32_t samprate, uint8_t channels, uint32_t msec) = 0;
+	/**
+	 * @brief Deinit the pre-roll ring
+	 * @details @b #include <media/voice/SpeechDetector.h>
+	 * @return Return success if the pre-roll ring is successfully deinit
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual bool deinitPreRoll() = 0;
+	/**
+	 * @brief Capture audio to the pre-roll ring, the oldest samples are overwritten
+	 * @details @b #include <media/voice/SpeechDetector.h>
+	 * param[in] sample Audio sample vector
+	 * param[in] numSample the number of samples
+	 * @return Return success if the samples are captured
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual bool capturePreRoll(short *sample, int numSample) = 0;
+	/**
+	 * @brief Read the captured audio out of the pre-roll ring, oldest sample first
+	 * @details @b #include <media/voice/SpeechDetector.h>
+	 * The samples read are removed from the ring.
+	 * param[out] sample Audio sample vector to fill
+	 * param[in] numSample the size of the sample vector
+	 * @return The number of samples read
+	 * @since TizenRT v2.1 PRE
+	 */
+	virtual int readPreRoll(short *sample, int numSample) = 0;
 protected:
 	SpeechDetector() = default;
 };
@@ -348,6 +348,52 @@ int pcm_writei(struct pcm *pcm, const void *data, unsigned int frame_count);
  */
 int pcm_readi(struct pcm *pcm, void *data, unsigned int frame_count);
 
+/**
+ * @brief Lends the next free playback buffer so the caller can render into it directly.
+ *
+ * @details @b #include <tinyalsa/tinyalsa.h>
+ * @param[in]     pcm    A PCM handle.
+ * @param[out]    buffer Pointer to the sample memory of the lent buffer
+ * @param[in,out] frames The number of frames wanted, reduced to the buffer capacity
+ * @return On success, 0 returned. On failure, a negative number returned.
+ * @since TizenRT v3.1
+ */
+int pcm_writei_begin(struct pcm *pcm, void **buffer, unsigned int *frames);
+
+/**
+ * @brief Enqueues the buffer lent by pcm_writei_begin.
+ *
+ * @details @b #include <tinyalsa/tinyalsa.h>
+ * @param[in] pcm    A PCM handle.
+ * @param[in] frames The number of frames written into the buffer
+ * @return On success, number of frames committed returned. On failure, a negative number returned.
+ * @since TizenRT v3.1
+ */
+int pcm_writei_commit(struct pcm *pcm, unsigned int frames);
+
+/**
+ * @brief Lends the recorded samples of the next filled capture buffer.
+ *
+ * @details @b #include <tinyalsa/tinyalsa.h>
+ * @param[in]     pcm    A PCM handle.
+ * @param[out]    buffer Pointer to the recorded samples
+ * @param[in,out] frames The number of frames wanted, reduced to the frames available
+ * @return On success, 0 returned. On failure, a negative number returned.
+ * @since TizenRT v3.1
+ */
+int pcm_readi_begin(struct pcm *pcm, void **buffer, unsigned int *frames);
+
+/**
+ * @brief Consumes frames lent by pcm_readi_begin and recycles the buffer once it is empty.
+ *
+ * @details @b #include <tinyalsa/tinyalsa.h>
+ * @param[in] pcm    A PCM handle.
+ * @param[in] frames The number of frames used by the caller
+ * @return On success, number of frames consumed returned. On failure, a negative number returned.
+ * @since TizenRT v3.1
+ */
+int pcm_readi_commit(struct pcm *pcm, unsigned int frames);
+
 /**
 * @brief Stops a PCM. Any data present in the buffers will be dropped.
 *
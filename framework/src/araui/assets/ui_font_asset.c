@@ -175,6 +175,8 @@ static void _ui_font_asset_destroy_func(void *userdata)
 
 	body = (ui_font_asset_body_t *)userdata;
 
+	ui_glyph_cache_remove_font(body);
+
 	UI_FREE(body->ttf_buf);
 	UI_FREE(body);
 }
@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <araui/ui_commons.h>
+#include <stb/stb_truetype.h>
+#include "ui_debug.h"
+#include "ui_renderer.h"
+#include "ui_asset_internal.h"
+
+/**
+ * Glyphs are kept in a fixed table of entries, found through a hash table and
+ * evicted in LRU order when the table is full or the bitmaps exceed the budget.
+ * The cache is not locked, it must only be used from the UI core thread.
+ */
+#define UI_GLYPH_CACHE_NUM      (CONFIG_UI_GLYPH_CACHE_NUM)
+#define UI_GLYPH_CACHE_BUCKETS  (64)
+#define UI_GLYPH_CACHE_NIL      (-1)
+
+typedef struct {
+	ui_font_asset_body_t *font;
+	size_t font_size;
+	uint32_t codepoint;
+	ui_glyph_t glyph;
+	int16_t prev;       //!< more recently used entry
+	int16_t next;       //!< less recently used entry
+	int16_t hash_next;
+	bool used;
+} ui_glyph_entry_t;
+
+static ui_glyph_entry_t g_entries[UI_GLYPH_CACHE_NUM];
+static int16_t g_buckets[UI_GLYPH_CACHE_BUCKETS];
+static int16_t g_lru_head = UI_GLYPH_CACHE_NIL;
+static int16_t g_lru_tail = UI_GLYPH_CACHE_NIL;
+static size_t g_bitmap_bytes = 0;
+static bool g_initialized = false;
+
+static uint32_t _ui_glyph_cache_hash(ui_font_asset_body_t *font, size_t font_size, uint32_t codepoint)
+{
+	uint32_t hash;
+
+	hash = (uint32_t)(uintptr_t)font;
+	hash ^= (uint32_t)font_size * 31;
+	hash ^= codepoint * 2654435761u;
+
+	return (hash ^ (hash >> 16)) % UI_GLYPH_CACHE_BUCKETS;
+}
+
+static void _ui_glyph_cache_init(void)
+{
+	int idx;
+
+	for (idx = 0; idx < UI_GLYPH_CACHE_BUCKETS; idx++) {
+		g_buckets[idx] = UI_GLYPH_CACHE_NIL;
+	}
+
+	memset(g_entries, 0, sizeof(g_entries));
+	g_lru_head = UI_GLYPH_CACHE_NIL;
+	g_lru_tail = UI_GLYPH_CACHE_NIL;
+	g_bitmap_bytes = 0;
+	g_initialized = true;
+}
+
+static void _ui_glyph_cache_lru_unlink(int16_t idx)
+{
+	ui_glyph_entry_t *entry = &g_entries[idx];
+
+	if (entry->prev != UI_GLYPH_CACHE_NIL) {
+		g_entries[entry->prev].next = entry->next;
+	} else {
+		g_lru_head = entry->next;
+	}
+
+	if (entry->next != UI_GLYPH_CACHE_NIL) {
+		g_entries[entry->next].prev = entry->prev;
+	} else {
+		g_lru_tail = entry->prev;
+	}
+}
+
+static void _ui_glyph_cache_lru_push_front(int16_t idx)
+{
+	ui_glyph_entry_t *entry = &g_entries[idx];
+
+	entry->prev = UI_GLYPH_CACHE_NIL;
+	entry->next = g_lru_head;
+
+	if (g_lru_head != UI_GLYPH_CACHE_NIL) {
+		g_entries[g_lru_head].prev = idx;
+	}
+	g_lru_head = idx;
+
+	if (g_lru_tail == UI_GLYPH_CACHE_NIL) {
+		g_lru_tail = idx;
+	}
+}
+
+static void _ui_glyph_cache_remove(int16_t idx)
+{
+	ui_glyph_entry_t *entry = &g_entries[idx];
+	int16_t *link;
+
+	link = &g_buckets[_ui_glyph_cache_hash(entry->font, entry->font_size, entry->codepoint)];
+	while (*link != UI_GLYPH_CACHE_NIL) {
+		if (*link == idx) {
+			*link = entry->hash_next;
+			break;
+		}
+		link = &g_entries[*link].hash_next;
+	}
+
+	_ui_glyph_cache_lru_unlink(idx);
+
+	g_bitmap_bytes -= entry->glyph.width * entry->glyph.height;
+	UI_FREE(entry->glyph.bitmap);
+	entry->used = false;
+}
+
+static int16_t _ui_glyph_cache_alloc_entry(size_t bitmap_size)
+{
+	int16_t idx;
+	bool flushed = false;
+
+	// Evict the least recently used glyphs until the new one fits
+	while (g_lru_tail != UI_GLYPH_CACHE_NIL && g_bitmap_bytes + bitmap_size > CONFIG_UI_GLYPH_CACHE_SIZE) {
+		if (!flushed) {
+			// A queued blit may still refer the bitmap of the evicted glyph
+			ui_renderer_flush();
+			flushed = true;
+		}
+		_ui_glyph_cache_remove(g_lru_tail);
+	}
+
+	for (idx = 0; idx < UI_GLYPH_CACHE_NUM; idx++) {
+		if (!g_entries[idx].used) {
+			return idx;
+		}
+	}
+
+	if (!flushed) {
+		ui_renderer_flush();
+	}
+
+	idx = g_lru_tail;
+	_ui_glyph_cache_remove(idx);
+
+	return idx;
+}
+
+const ui_glyph_t *ui_glyph_cache_get(ui_font_asset_body_t *font, size_t font_size, uint32_t codepoint)
+{
+	ui_glyph_entry_t *entry;
+	uint32_t hash;
+	int16_t idx;
+	float scale;
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+	int advance;
+
+	if (!font) {
+		return UI_NULL;
+	}
+
+	if (!g_initialized) {
+		_ui_glyph_cache_init();
+	}
+
+	hash = _ui_glyph_cache_hash(font, font_size, codepoint);
+
+	for (idx = g_buckets[hash]; idx != UI_GLYPH_CACHE_NIL; idx = g_entries[idx].hash_next) {
+		entry = &g_entries[idx];
+		if (entry->font == font && entry->font_size == font_size && entry->codepoint == codepoint) {
+			if (g_lru_head != idx) {
+				_ui_glyph_cache_lru_unlink(idx);
+				_ui_glyph_cache_lru_push_front(idx);
+			}
+			return &entry->glyph;
+		}
+	}
+
+	// Cache miss, rasterize the glyph once and keep it
+	scale = stbtt_ScaleForPixelHeight(&font->ttf_info, font_size);
+	stbtt_GetCodepointBitmapBox(&font->ttf_info, codepoint, scale, scale, &x1, &y1, &x2, &y2);
+	stbtt_GetCodepointHMetrics(&font->ttf_info, codepoint, &advance, 0);
+
+	idx = _ui_glyph_cache_alloc_entry((x2 - x1) * (y2 - y1));
+	entry = &g_entries[idx];
+
+	memset(entry, 0, sizeof(ui_glyph_entry_t));
+	entry->font = font;
+	entry->font_size = font_size;
+	entry->codepoint = codepoint;
+	entry->glyph.x_offset = x1;
+	entry->glyph.y_offset = y1;
+	entry->glyph.width = x2 - x1;
+	entry->glyph.height = y2 - y1;
+	entry->glyph.advance = advance * scale;
+
+	if (entry->glyph.width > 0 && entry->glyph.height > 0) {
+		entry->glyph.bitmap = (uint8_t *)UI_ALLOC(entry->glyph.width * entry->glyph.height);
+		if (!entry->glyph.bitmap) {
+			UI_LOGE("error: out of memory!\n");
+			return UI_NULL;
+		}
+		stbtt_MakeCodepointBitmap(&font->ttf_info, entry->glyph.bitmap,
+			entry->glyph.width, entry->glyph.height, entry->glyph.width,
+			scale, scale, codepoint);
+		g_bitmap_bytes += entry->glyph.width * entry->glyph.height;
+	} else {
+		entry->glyph.width = 0;
+		entry->glyph.height = 0;
+	}
+
+	entry->used = true;
+	entry->hash_next = g_buckets[hash];
+	g_buckets[hash] = idx;
+	_ui_glyph_cache_lru_push_front(idx);
+
+	return &entry->glyph;
+}
+
+void ui_glyph_cache_remove_font(ui_font_asset_body_t *font)
+{
+	int16_t idx;
+	bool flushed = false;
+
+	if (!g_initialized) {
+		return;
+	}
+
+	for (idx = 0; idx < UI_GLYPH_CACHE_NUM; idx++) {
+		if (g_entries[idx].used && g_entries[idx].font == font) {
+			if (!flushed) {
+				ui_renderer_flush();
+				flushed = true;
+			}
+			_ui_glyph_cache_remove(idx);
+		}
+	}
+}
+
+void ui_glyph_cache_clear(void)
+{
+	int16_t idx;
+
+	if (!g_initialized) {
+		return;
+	}
+
+	ui_renderer_flush();
+
+	for (idx = 0; idx < UI_GLYPH_CACHE_NUM; idx++) {
+		if (g_entries[idx].used) {
+			_ui_glyph_cache_remove(idx);
+		}
+	}
+}
@@ -30,6 +30,7 @@
 #include <time.h>
 #include <vec/vec.h>
 #include <araui/ui_commons.h>
+#include <araui/ui_core.h>
 #include <araui/ui_animation.h>
 #include "ui_renderer.h"
 #include "ui_request_callback.h"
@@ -55,6 +56,8 @@ typedef struct {
 	pthread_t pid;
 	pid_t caller_pid;
 	ui_quick_panel_event_type_t visible_event_type;
+	bool active;              //!< a widget is animating or changed by itself in this frame
+	ui_frame_stats_t stats;
 
 #if defined(CONFIG_UI_ENABLE_TOUCH)
 	ui_widget_body_t *locked_target;
@@ -75,7 +78,7 @@ static void *_ui_core_thread_loop(void *param);
 static bool _ui_core_quick_panel_visible(void);
 
 #if defined(CONFIG_UI_ENABLE_TOUCH)
-static void _ui_core_dispatch_touch_event(void);
+static bool _ui_core_dispatch_touch_event(void);
 static void _ui_core_handle_touch_event(ui_touch_event_t touch_event, ui_coord_t coord);
 static bool _ui_core_quick_panel_touch_down(ui_touch_event_t touch_event, ui_coord_t coord);
 #endif
@@ -138,6 +141,7 @@ ui_error_t ui_start(void)
 	}
 
 	g_core.state = UI_CORE_STATE_RUNNING;
+	memset(&g_core.stats, 0, sizeof(ui_frame_stats_t));
 
 	if (pthread_create(&g_core.pid, &attr, _ui_core_thread_loop, NULL)) {
 		ui_dal_deinit();
@@ -175,6 +179,7 @@ ui_error_t ui_stop(void)
 	}
 
 	g_core.state = UI_CORE_STATE_STOPPING;
+	ui_request_callback_wakeup();
 
 	if (pthread_join(g_core.pid, NULL) != OK) {
 		UI_LOGE("pthread_join failed.\n");
@@ -198,6 +203,8 @@ ui_error_t ui_stop(void)
 		return UI_OPERATION_FAIL;
 	}
 
+	ui_glyph_cache_clear();
+
 	return UI_OK;
 }
 
@@ -257,6 +264,12 @@ static ui_error_t _ui_process_widget(ui_widget_body_t *widget, uint32_t dt)
 			}
 		}
 
+		// The next frame is needed while something changes without any request.
+		// update_flag is checked after the redraw pass, which consumes it.
+		if (curr_widget->anim || curr_widget->tick_cb || curr_widget->interval_cb) {
+			g_core.active = true;
+		}
+
 		vec_foreach(&curr_widget->children, child, iter) {
 			ui_widget_queue_enqueue(child);
 		}
@@ -292,10 +305,14 @@ static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_are
 		if (curr_widget->visible) {
 			if (curr_widget->render_cb) {
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
+				// Cull the widget whose bounding box does not touch the draw area.
+				// Its children are still visited, they can be placed outside of their parent.
 				new_vp = ui_rect_intersect(draw_area, curr_widget->global_rect);
-				ui_dal_set_viewport(new_vp.x, new_vp.y, new_vp.width, new_vp.height);
-				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
-				ui_dal_set_viewport(draw_area.x, draw_area.y, draw_area.width, draw_area.height);
+				if (new_vp.width > 0 && new_vp.height > 0) {
+					ui_dal_set_viewport(new_vp.x, new_vp.y, new_vp.width, new_vp.height);
+					curr_widget->render_cb((ui_widget_t)curr_widget, dt);
+					ui_dal_set_viewport(draw_area.x, draw_area.y, draw_area.width, draw_area.height);
+				}
 #else
 				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
 #endif
@@ -338,7 +355,11 @@ static void _ui_redraw(uint32_t dt)
 	ui_window_body_t *window;
 
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
+	// The redraw list holds disjoint rectangles coalesced from the dirty tiles,
+	// so every damaged pixel is rendered exactly once.
 	vec_foreach(ui_window_get_redraw_list(), redraw_rect, iter) {
+		ui_dal_set_viewport(redraw_rect->x, redraw_rect->y, redraw_rect->width, redraw_rect->height);
+
 		window = ui_window_get_current();
 		if (window) {
 			_ui_render_widget(window->root, *redraw_rect, dt);
@@ -348,6 +369,8 @@ static void _ui_redraw(uint32_t dt)
 			_ui_render_widget(g_quick_panel_info[g_core.visible_event_type], *redraw_rect, dt);
 		}
 
+		ui_renderer_flush();
+
 		if (window || _ui_core_quick_panel_visible()) {
 			ui_dal_redraw(redraw_rect->x, redraw_rect->y, redraw_rect->width, redraw_rect->height);
 		}
@@ -371,6 +394,8 @@ static void _ui_redraw(uint32_t dt)
 		_ui_render_widget(g_quick_panel_info[g_core.visible_event_type], redraw_rect, dt);
 	}
 
+	ui_renderer_flush();
+
 	if (window || _ui_core_quick_panel_visible()) {
 		ui_dal_redraw(redraw_rect.x, redraw_rect.y, redraw_rect.width, redraw_rect.height);
 	}
@@ -383,7 +408,6 @@ static void _ui_update_redraw_list(ui_widget_body_t *widget)
 	ui_mat3_t parent_mat;
 	ui_widget_body_t *curr_widget;
 	ui_widget_body_t *child;
-	bool update_flag = false;
 
 	if (!widget) {
 		UI_LOGE("error: invalid widget!\n");
@@ -400,7 +424,7 @@ static void _ui_update_redraw_list(ui_widget_body_t *widget)
 			break;
 		}
 
-		if (curr_widget->update_flag || update_flag) {
+		if (curr_widget->update_flag) {
 			if (curr_widget->parent) {
 				parent_mat = curr_widget->parent->trans_mat;
 			} else {
@@ -429,7 +453,11 @@ static void _ui_update_redraw_list(ui_widget_body_t *widget)
 #endif
 
 			curr_widget->update_flag = false;
-			update_flag = true;
+
+			// The transform of the descendants depends on this widget, only they follow it.
+			vec_foreach(&curr_widget->children, child, iter) {
+				child->update_flag = true;
+			}
 		}
 
 		vec_foreach(&curr_widget->children, child, iter) {
@@ -438,37 +466,107 @@ static void _ui_update_redraw_list(ui_widget_body_t *widget)
 	}
 }
 
+/**
+ * @brief Check whether a widget was changed after the redraw list was built,
+ * e.g. by a draw callback, so that it still waits for a frame.
+ */
+static bool _ui_core_has_pending_update(ui_widget_body_t *widget)
+{
+	int iter;
+	ui_widget_body_t *curr_widget;
+	ui_widget_body_t *child;
+
+	ui_widget_queue_init();
+	ui_widget_queue_enqueue(widget);
+
+	while (!ui_widget_is_queue_empty()) {
+		curr_widget = ui_widget_queue_dequeue();
+		if (!curr_widget) {
+			break;
+		}
+
+		if (curr_widget->update_flag) {
+			return true;
+		}
+
+		vec_foreach(&curr_widget->children, child, iter) {
+			ui_widget_queue_enqueue(child);
+		}
+	}
+
+	return false;
+}
+
+static uint32_t _ui_core_elapsed_ms(struct timespec *from, struct timespec *to)
+{
+	return ((to->tv_sec - from->tv_sec) * 1000) + ((to->tv_nsec - from->tv_nsec) / 1000000);
+}
+
+static void _ui_core_update_frame_stats(uint32_t frame_time, uint32_t ms_per_frame)
+{
+	g_core.stats.frame_count++;
+	g_core.stats.last_frame_time = frame_time;
+	if (frame_time > g_core.stats.max_frame_time) {
+		g_core.stats.max_frame_time = frame_time;
+	}
+
+	// A frame which took longer than a frame period hides the periods it covered
+	if (ms_per_frame && frame_time > ms_per_frame) {
+		g_core.stats.dropped_count += (frame_time - 1) / ms_per_frame;
+	}
+}
+
 static void *_ui_core_thread_loop(void *param)
 {
 	ui_widget_body_t *root;
 	ui_window_body_t *window;
 	struct timespec before;
 	struct timespec now;
+	struct timespec end;
 	uint32_t dt;
+	uint32_t frame_time;
+	bool need_frame = true;
 
 #if (CONFIG_UI_MAXIMUM_FPS > 0)
 	const uint32_t ms_per_frame = 1000 / CONFIG_UI_MAXIMUM_FPS;
+#else
+	const uint32_t ms_per_frame = 0;
 #endif
 
 	memset(&before, 0, sizeof(struct timespec));
 	memset(&now, 0, sizeof(struct timespec));
+	memset(&end, 0, sizeof(struct timespec));
 
 	clock_gettime(CLOCK_MONOTONIC, &before);
 
 	while (g_core.state == UI_CORE_STATE_RUNNING) {
+		if (!need_frame) {
+			// Nothing is dirty and nothing animates, so the widget tree is not traversed.
+			// Sleep until a request arrives, touch events are polled on every timeout.
+			ui_request_callback_wait(CONFIG_UI_IDLE_POLL_INTERVAL);
+
+#if defined(CONFIG_UI_ENABLE_TOUCH)
+			need_frame = _ui_core_dispatch_touch_event();
+#endif
+			if (ui_process_all_requests()) {
+				need_frame = true;
+			}
+
+			// The idle time is not delivered to the widgets as a huge dt
+			clock_gettime(CLOCK_MONOTONIC, &before);
+			continue;
+		}
+
 		ui_dal_clear();
 
 		clock_gettime(CLOCK_MONOTONIC, &now);
 
-		dt = ((now.tv_sec - before.tv_sec) * 1000) + ((now.tv_nsec - before.tv_nsec) / 1000000);
+		dt = _ui_core_elapsed_ms(&before, &now);
 		before = now;
 
-#if (CONFIG_UI_MAXIMUM_FPS > 0)
-		if (dt < ms_per_frame) {
-			usleep((ms_per_frame - dt) * 1000);
-		}
-#endif
+		g_core.active = false;
 
+		// Every animation is advanced once per frame by the same paced dt
 		window = ui_window_get_current();
 		if (window) {
 			root = window->root;
@@ -486,11 +584,34 @@ static void *_ui_core_thread_loop(void *param)
 
 		_ui_redraw(dt);
 
+		need_frame = g_core.active;
+		if (!need_frame && window) {
+			need_frame = _ui_core_has_pending_update(window->root);
+		}
+		if (!need_frame && _ui_core_quick_panel_visible()) {
+			need_frame = _ui_core_has_pending_update(g_quick_panel_info[g_core.visible_event_type]);
+		}
+
 #if defined(CONFIG_UI_ENABLE_TOUCH)
-		_ui_core_dispatch_touch_event();
+		if (_ui_core_dispatch_touch_event()) {
+			need_frame = true;
+		}
 #endif
 
-		ui_process_all_requests();
+		if (ui_process_all_requests()) {
+			need_frame = true;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		frame_time = _ui_core_elapsed_ms(&now, &end);
+		_ui_core_update_frame_stats(frame_time, ms_per_frame);
+
+#if (CONFIG_UI_MAXIMUM_FPS > 0)
+		// Sleep for the rest of the frame period only, not a whole period
+		if (frame_time < ms_per_frame) {
+			usleep((ms_per_frame - frame_time) * 1000);
+		}
+#endif
 	}
 
 	g_core.state = UI_CORE_STATE_STOP;
@@ -500,6 +621,21 @@ static void *_ui_core_thread_loop(void *param)
 	return NULL;
 }
 
+ui_error_t ui_core_get_frame_stats(ui_frame_stats_t *stats)
+{
+	if (!ui_is_running()) {
+		return UI_NOT_RUNNING;
+	}
+
+	if (!stats) {
+		return UI_INVALID_PARAM;
+	}
+
+	*stats = g_core.stats;
+
+	return UI_OK;
+}
+
 bool ui_is_running(void)
 {
 	return (g_core.state != UI_CORE_STATE_STOP);
@@ -646,12 +782,15 @@ static void _ui_core_handle_touch_event(ui_touch_event_t touch_event, ui_coord_t
 	}
 }
 
-static void _ui_core_dispatch_touch_event(void)
+static bool _ui_core_dispatch_touch_event(void)
 {
 	static ui_touch_state_t before = {false, };
 	static ui_touch_state_t cur = {false, };
+	bool dispatched = false;
 
 	while (ui_dal_get_touch(&cur.pressed, &cur.coord)) {
+		dispatched = true;
+
 		if (cur.pressed != before.pressed) {
 			if (cur.pressed) {
 				_ui_core_handle_touch_event(UI_TOUCH_EVENT_DOWN, cur.coord);
@@ -664,6 +803,8 @@ static void _ui_core_dispatch_touch_event(void)
 
 		before = cur;
 	}
+
+	return dispatched;
 }
 
 void ui_core_lock_touch_event_target(ui_widget_body_t *target)
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <araui/ui_commons.h>
+#include "ui_debug.h"
+#include "dal/ui_dal.h"
+#include "dal/ui_dal_batch.h"
+
+static ui_dal_blit_cmd_t g_blit_queue[CONFIG_UI_DAL_BATCH_SIZE];
+static int g_blit_queue_num = 0;
+
+static void _ui_dal_batch_draw(const ui_dal_blit_cmd_t *cmd);
+
+void ui_dal_batch_blit(const ui_dal_blit_cmd_t *cmd)
+{
+	if (!cmd || cmd->width <= 0 || cmd->height <= 0) {
+		return;
+	}
+
+	if (g_blit_queue_num >= CONFIG_UI_DAL_BATCH_SIZE) {
+		ui_dal_batch_flush();
+	}
+
+	g_blit_queue[g_blit_queue_num++] = *cmd;
+}
+
+void ui_dal_batch_flush(void)
+{
+	int idx;
+
+	for (idx = 0; idx < g_blit_queue_num; idx++) {
+		_ui_dal_batch_draw(&g_blit_queue[idx]);
+	}
+
+	g_blit_queue_num = 0;
+}
+
+static void _ui_dal_batch_draw(const ui_dal_blit_cmd_t *cmd)
+{
+	const uint8_t *src = cmd->src;
+	int32_t y = cmd->y;
+	int32_t row;
+
+#if defined(CONFIG_UI_ENABLE_HW_ACC_CHROM_ART)
+	// DMA2D takes a whole bitmap, so the source rows must be contiguous
+	if (cmd->pf == UI_PIXEL_FORMAT_RGB888 && cmd->stride == cmd->width * 3) {
+		ui_dal_draw_bitmap_dma2d(cmd->x, cmd->y, (uint8_t *)cmd->src, cmd->width, cmd->height, cmd->pf);
+		return;
+	}
+	if (cmd->pf == UI_PIXEL_FORMAT_RGBA8888 && cmd->stride == cmd->width * 4) {
+		ui_dal_draw_bitmap_dma2d(cmd->x, cmd->y, (uint8_t *)cmd->src, cmd->width, cmd->height, cmd->pf);
+		return;
+	}
+#endif
+
+	for (row = 0; row < cmd->height; row++) {
+		if (cmd->pf == UI_PIXEL_FORMAT_A8) {
+			ui_dal_blit_span_a8(cmd->x, y++, cmd->width, src, cmd->color);
+		} else {
+			ui_dal_blit_span(cmd->x, y++, cmd->width, src, cmd->pf);
+		}
+		src += cmd->stride;
+	}
+}
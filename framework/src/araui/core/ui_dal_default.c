@@ -17,8 +17,14 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
+#include <tinyara/config.h>
 #include "dal/ui_dal.h"
 
+//!< Span primitives below can be overridden by the DAL implementation
+#define UI_DAL_WEAK __attribute__((weak))
+
+#if !defined(CONFIG_UI_USE_EXTERNAL_DAL_IMPL)
+
 UI_DAL ui_error_t ui_dal_init(void)
 {
 	return UI_OK;
@@ -67,3 +73,50 @@ UI_DAL bool ui_dal_get_touch(bool *pressed, ui_coord_t *coord)
 }
 
 #endif // CONFIG_UI_ENABLE_TOUCH
+
+#endif // !CONFIG_UI_USE_EXTERNAL_DAL_IMPL
+
+/****************************************************************************
+ * Software fallback of the span primitives
+ ****************************************************************************/
+UI_DAL_WEAK void ui_dal_fill_span(int32_t x, int32_t y, int32_t width, ui_color_t color)
+{
+	while (width-- > 0) {
+		ui_dal_put_pixel_rgba8888(x++, y, color);
+	}
+}
+
+UI_DAL_WEAK void ui_dal_blit_span(int32_t x, int32_t y, int32_t width, const uint8_t *src, ui_pixel_format_t pf)
+{
+	if (pf == UI_PIXEL_FORMAT_RGB888) {
+		while (width-- > 0) {
+			ui_dal_put_pixel_rgb888(x++, y, UI_COLOR_RGB888(src[0], src[1], src[2]));
+			src += 3;
+		}
+	} else if (pf == UI_PIXEL_FORMAT_RGBA8888) {
+		while (width-- > 0) {
+			ui_dal_put_pixel_rgba8888(x++, y, UI_COLOR_RGBA8888(src[0], src[1], src[2], src[3]));
+			src += 4;
+		}
+	}
+}
+
+UI_DAL_WEAK void ui_dal_blit_span_a8(int32_t x, int32_t y, int32_t width, const uint8_t *alpha, ui_color_t color)
+{
+	color &= 0x00ffffff;
+
+	while (width-- > 0) {
+		if (*alpha) {
+			ui_dal_put_pixel_rgba8888(x, y, color | ((ui_color_t)*alpha << 24));
+		}
+		x++;
+		alpha++;
+	}
+}
+
+UI_DAL_WEAK void ui_dal_fill_rect(int32_t x, int32_t y, int32_t width, int32_t height, ui_color_t color)
+{
+	while (height-- > 0) {
+		ui_dal_fill_span(x, y++, width, color);
+	}
+}
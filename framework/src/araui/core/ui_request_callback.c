@@ -18,6 +18,7 @@
 
 
 #include <pthread.h>
+#include <time.h>
 #include <vec/vec.h>
 #include <araui/ui_commons.h>
 #include "ui_request_callback.h"
@@ -29,6 +30,8 @@ typedef struct {
 
 static vec_void_t g_reqcb_list;
 static pthread_mutex_t g_mutex;
+static pthread_cond_t g_cond;
+static bool g_wakeup;
 
 ui_error_t ui_request_callback_init(void)
 {
@@ -36,8 +39,14 @@ ui_error_t ui_request_callback_init(void)
 		return UI_INIT_FAILURE;
 	}
 
+	if (pthread_cond_init(&g_cond, NULL)) {
+		pthread_mutex_destroy(&g_mutex);
+		return UI_INIT_FAILURE;
+	}
+
 	pthread_mutex_lock(&g_mutex);
 	vec_init(&g_reqcb_list);
+	g_wakeup = false;
 	pthread_mutex_unlock(&g_mutex);
 
 	return UI_OK;
@@ -48,6 +57,7 @@ ui_error_t ui_request_callback_deinit(void)
 	pthread_mutex_lock(&g_mutex);
 	vec_deinit(&g_reqcb_list);
 	pthread_mutex_unlock(&g_mutex);
+	pthread_cond_destroy(&g_cond);
 	pthread_mutex_destroy(&g_mutex);
 
 	return UI_OK;
@@ -76,18 +86,23 @@ ui_error_t ui_request_callback(request_callback request_cb, void *userdata)
 		return UI_OPERATION_FAIL;
 	}
 
+	// Wake up the core thread if it is sleeping on the idle screen
+	pthread_cond_signal(&g_cond);
 	pthread_mutex_unlock(&g_mutex);
 
 	return UI_OK;
 }
 
-void ui_process_all_requests(void)
+bool ui_process_all_requests(void)
 {
 	request_item_t *item;
 	int iter;
+	bool processed;
 
 	pthread_mutex_lock(&g_mutex);
 
+	processed = (g_reqcb_list.length > 0);
+
 	// Below logic will work correctly.
 	// Actually, in the request_cb function, a new request callback can be added.
 	// But it will be added only at the end of the vector.
@@ -101,4 +116,39 @@ void ui_process_all_requests(void)
 
 	vec_clear(&g_reqcb_list);
 	pthread_mutex_unlock(&g_mutex);
+
+	return processed;
+}
+
+void ui_request_callback_wait(uint32_t timeout_ms)
+{
+	struct timespec abstime;
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec += timeout_ms / 1000;
+	abstime.tv_nsec += (timeout_ms % 1000) * 1000000;
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&g_mutex);
+
+	// Sleep until a request arrives, someone wakes us up, or the timeout expires
+	while (!g_reqcb_list.length && !g_wakeup) {
+		if (pthread_cond_timedwait(&g_cond, &g_mutex, &abstime) != 0) {
+			break;
+		}
+	}
+	g_wakeup = false;
+
+	pthread_mutex_unlock(&g_mutex);
+}
+
+void ui_request_callback_wakeup(void)
+{
+	pthread_mutex_lock(&g_mutex);
+	g_wakeup = true;
+	pthread_cond_signal(&g_cond);
+	pthread_mutex_unlock(&g_mutex);
 }
@@ -31,15 +31,30 @@
 static vec_void_t g_window_list;
 static ui_window_body_t *g_current_window = UI_NULL;
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
+/**
+ * @brief Damage is tracked on a grid of tiles, one bit per tile.
+ * Every row of tiles is a bitmap of UI_TILE_WORDS words.
+ */
+#define UI_TILE_SIZE (CONFIG_UI_PARTIAL_UPDATE_TILE_SIZE)
+#define UI_TILE_COLS ((CONFIG_UI_DISPLAY_WIDTH + UI_TILE_SIZE - 1) / UI_TILE_SIZE)
+#define UI_TILE_ROWS ((CONFIG_UI_DISPLAY_HEIGHT + UI_TILE_SIZE - 1) / UI_TILE_SIZE)
+#define UI_TILE_NUM  (UI_TILE_COLS * UI_TILE_ROWS)
+#define UI_TILE_WORDS ((UI_TILE_COLS + 31) / 32)
+
+#define UI_TILE_IS_DIRTY(bits, col) ((bits)[(col) >> 5] & ((uint32_t)1 << ((col) & 31)))
+
+static uint32_t g_dirty_tiles[UI_TILE_ROWS][UI_TILE_WORDS];
+static bool g_dirty_tiles_changed = false;
 static vec_void_t g_window_redraw_list;
-static ui_rect_t g_rect_mempool[CONFIG_UI_UPDATE_MEMPOOL_SIZE];
-static int g_rect_mempool_idx = 0;
+static ui_rect_t g_redraw_rects[UI_TILE_NUM];
 #endif
 
 static void _ui_window_create_func(void *userdata);
 static void _ui_window_destroy_func(void *userdata);
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
-static ui_rect_t *_ui_window_get_mempool_rect(void);
+static void _ui_window_build_redraw_list(void);
+static void _ui_window_set_tiles(uint32_t *bits, int32_t col, int32_t len, bool dirty);
+static bool _ui_window_tiles_dirty(const uint32_t *bits, int32_t col, int32_t len);
 #endif
 
 ui_error_t ui_window_list_init(void)
@@ -66,6 +81,8 @@ ui_error_t ui_window_list_deinit(void)
 ui_error_t ui_window_redraw_list_init(void)
 {
 	vec_init(&g_window_redraw_list);
+	memset(g_dirty_tiles, 0, sizeof(g_dirty_tiles));
+	g_dirty_tiles_changed = false;
 
 	return UI_OK;
 }
@@ -251,78 +268,39 @@ ui_error_t ui_window_add_widget(ui_window_t window, ui_widget_t widget, int32_t
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
 vec_void_t *ui_window_get_redraw_list(void)
 {
+	if (g_dirty_tiles_changed) {
+		_ui_window_build_redraw_list();
+		g_dirty_tiles_changed = false;
+	}
+
 	return &g_window_redraw_list;
 }
 
 ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 {
-	ui_rect_t *window;
-	ui_rect_t *new_area;
-	ui_rect_t previous;
-	ui_rect_t ret;
-	int iter;
-
-	if (redraw_rect.x < 0) {
-		redraw_rect.width += redraw_rect.x;
-		redraw_rect.x = 0;
-	} else if (redraw_rect.x >= CONFIG_UI_DISPLAY_WIDTH) {
+	int32_t x2;
+	int32_t y2;
+	int32_t col1;
+	int32_t col2;
+	int32_t row;
+
+	x2 = UI_MIN(redraw_rect.x + redraw_rect.width, CONFIG_UI_DISPLAY_WIDTH);
+	y2 = UI_MIN(redraw_rect.y + redraw_rect.height, CONFIG_UI_DISPLAY_HEIGHT);
+	redraw_rect.x = UI_MAX(redraw_rect.x, 0);
+	redraw_rect.y = UI_MAX(redraw_rect.y, 0);
+
+	if (redraw_rect.x >= x2 || redraw_rect.y >= y2) {
 		return UI_OK;
 	}
 
-	if (redraw_rect.y < 0) {
-		redraw_rect.height += redraw_rect.y;
-		redraw_rect.y = 0;
-	} else if (redraw_rect.y >= CONFIG_UI_DISPLAY_HEIGHT) {
-		return UI_OK;
-	}
+	col1 = redraw_rect.x / UI_TILE_SIZE;
+	col2 = (x2 - 1) / UI_TILE_SIZE;
 
-	if (redraw_rect.width <= 0 || redraw_rect.height <= 0) {
-		return UI_OK;
+	for (row = redraw_rect.y / UI_TILE_SIZE; row <= (y2 - 1) / UI_TILE_SIZE; row++) {
+		_ui_window_set_tiles(g_dirty_tiles[row], col1, col2 - col1 + 1, true);
 	}
 
-	new_area = _ui_window_get_mempool_rect();
-
-	new_area->x = redraw_rect.x;
-	new_area->y = redraw_rect.y;
-	new_area->width = redraw_rect.width;
-	new_area->height = redraw_rect.height;
-
-	if (new_area->x + new_area->width >= CONFIG_UI_DISPLAY_WIDTH) {
-		new_area->width = CONFIG_UI_DISPLAY_WIDTH - new_area->x;
-	}
-	if (new_area->y + new_area->height >= CONFIG_UI_DISPLAY_HEIGHT) {
-		new_area->height = CONFIG_UI_DISPLAY_HEIGHT - new_area->y;
-	}
-
-	vec_foreach(&g_window_redraw_list, window, iter) {
-		// window is whole screen case
-		if ((window->x == 0) && (window->y == 0) &&
-			(window->width == CONFIG_UI_DISPLAY_WIDTH) &&
-			(window->height == CONFIG_UI_DISPLAY_HEIGHT)) {
-			return UI_OK;
-		}
-
-		previous.x = window->x;
-		previous.y = window->y;
-		previous.width = window->width;
-		previous.height = window->height;
-
-		ret = ui_rect_intersect(previous, *new_area);
-		if (ret.x == 0 && ret.y == 0 && ret.width == 0 && ret.height == 0) {
-			continue;
-		}
-
-		ret = ui_get_contain_rect(previous, *new_area);
-		new_area->x = ret.x;
-		new_area->y = ret.y;
-		new_area->width = ret.width;
-		new_area->height = ret.height;
-
-		vec_remove(&g_window_redraw_list, window);
-		iter--;
-	}
-
-	vec_push(&g_window_redraw_list, new_area);
+	g_dirty_tiles_changed = true;
 
 	return UI_OK;
 }
@@ -330,20 +308,116 @@ ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 ui_error_t ui_window_redraw_list_clear(void)
 {
 	vec_clear(&g_window_redraw_list);
+	memset(g_dirty_tiles, 0, sizeof(g_dirty_tiles));
+	g_dirty_tiles_changed = false;
 
 	return UI_OK;
 }
 
-static ui_rect_t *_ui_window_get_mempool_rect(void)
+/**
+ * @brief Mark the run of len tiles from col as dirty or clean.
+ */
+static void _ui_window_set_tiles(uint32_t *bits, int32_t col, int32_t len, bool dirty)
 {
-	int alloc_idx = g_rect_mempool_idx;
+	int32_t word;
+	int32_t first;
+	int32_t n;
+	uint32_t mask;
+
+	while (len > 0) {
+		word = col >> 5;
+		first = col & 31;
+		n = UI_MIN(len, 32 - first);
+		mask = (uint32_t)((((uint64_t)1 << n) - 1) << first);
+		if (dirty) {
+			bits[word] |= mask;
+		} else {
+			bits[word] &= ~mask;
+		}
+		col += n;
+		len -= n;
+	}
+}
 
-	g_rect_mempool_idx++;
-	if (g_rect_mempool_idx >= CONFIG_UI_UPDATE_MEMPOOL_SIZE) {
-		g_rect_mempool_idx = 0;
+/**
+ * @brief Check whether every tile of the run of len tiles from col is dirty.
+ */
+static bool _ui_window_tiles_dirty(const uint32_t *bits, int32_t col, int32_t len)
+{
+	int32_t word;
+	int32_t first;
+	int32_t n;
+	uint32_t mask;
+
+	while (len > 0) {
+		word = col >> 5;
+		first = col & 31;
+		n = UI_MIN(len, 32 - first);
+		mask = (uint32_t)((((uint64_t)1 << n) - 1) << first);
+		if ((bits[word] & mask) != mask) {
+			return false;
+		}
+		col += n;
+		len -= n;
 	}
 
-	return &g_rect_mempool[alloc_idx];
+	return true;
+}
+
+/**
+ * @brief Coalesce the dirty tiles into disjoint rectangles.
+ *
+ * A run of adjacent dirty tiles in a row is grown downwards as long as the
+ * next rows have the same run dirty. Every dirty tile ends up in exactly one
+ * rectangle, so it is rendered only once per frame.
+ */
+static void _ui_window_build_redraw_list(void)
+{
+	uint32_t tiles[UI_TILE_ROWS][UI_TILE_WORDS];
+	int32_t row;
+	int32_t last_row;
+	int32_t col;
+	int32_t len;
+	int rect_num = 0;
+	ui_rect_t *rect;
+
+	memcpy(tiles, g_dirty_tiles, sizeof(tiles));
+	vec_clear(&g_window_redraw_list);
+
+	for (row = 0; row < UI_TILE_ROWS; row++) {
+		col = 0;
+		while (col < UI_TILE_COLS) {
+			if (!tiles[row][col >> 5]) {
+				col = (col | 31) + 1;
+				continue;
+			}
+			if (!UI_TILE_IS_DIRTY(tiles[row], col)) {
+				col++;
+				continue;
+			}
+			len = 1;
+			while ((col + len) < UI_TILE_COLS && UI_TILE_IS_DIRTY(tiles[row], col + len)) {
+				len++;
+			}
+
+			last_row = row;
+			while ((last_row + 1) < UI_TILE_ROWS && _ui_window_tiles_dirty(tiles[last_row + 1], col, len)) {
+				last_row++;
+				_ui_window_set_tiles(tiles[last_row], col, len, false);
+			}
+			_ui_window_set_tiles(tiles[row], col, len, false);
+
+			rect = &g_redraw_rects[rect_num++];
+			rect->x = col * UI_TILE_SIZE;
+			rect->y = row * UI_TILE_SIZE;
+			rect->width = UI_MIN((col + len) * UI_TILE_SIZE, CONFIG_UI_DISPLAY_WIDTH) - rect->x;
+			rect->height = UI_MIN((last_row + 1) * UI_TILE_SIZE, CONFIG_UI_DISPLAY_HEIGHT) - rect->y;
+
+			vec_push(&g_window_redraw_list, rect);
+
+			col += len;
+		}
+	}
 }
 #endif // CONFIG_UI_PARTIAL_UPDATE
 
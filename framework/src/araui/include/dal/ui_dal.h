@@ -95,6 +95,65 @@ UI_DAL void ui_dal_put_pixel_rgba8888(int32_t x, int32_t y, ui_color_t color);
  */
 UI_DAL void ui_dal_put_pixel_rgb888(int32_t x, int32_t y, ui_color_t color);
 
+/**
+ * @brief ui_dal_fill_span()
+ *
+ * Blend a horizontal run of pixels starting from (x, y) with the given color.
+ * The span and rectangle functions have a weak software fallback built on top of
+ * ui_dal_put_pixel_*(). A DAL implementation can override them to write whole rows at once.
+ *
+ * @param[in] x x coordinate of the first pixel
+ * @param[in] y y coordinate of the span
+ * @param[in] width Number of pixels of the span
+ * @param[in] color Color of the span (RGBA8888, alpha is used for blending)
+ *
+ */
+UI_DAL void ui_dal_fill_span(int32_t x, int32_t y, int32_t width, ui_color_t color);
+
+/**
+ * @brief ui_dal_blit_span()
+ *
+ * Put a horizontal run of pixels starting from (x, y).
+ * RGB888 pixels are copied as they are, RGBA8888 pixels are blended with their alpha.
+ *
+ * @param[in] x x coordinate of the first pixel
+ * @param[in] y y coordinate of the span
+ * @param[in] width Number of pixels of the span
+ * @param[in] src Packed pixels of the span
+ * @param[in] pf Pixel format of src (UI_PIXEL_FORMAT_RGB888 or UI_PIXEL_FORMAT_RGBA8888)
+ *
+ */
+UI_DAL void ui_dal_blit_span(int32_t x, int32_t y, int32_t width, const uint8_t *src, ui_pixel_format_t pf);
+
+/**
+ * @brief ui_dal_blit_span_a8()
+ *
+ * Blend a horizontal run of pixels starting from (x, y) with the given color,
+ * using a per-pixel alpha value. It is used to draw glyphs of the text.
+ *
+ * @param[in] x x coordinate of the first pixel
+ * @param[in] y y coordinate of the span
+ * @param[in] width Number of pixels of the span
+ * @param[in] alpha Alpha value of each pixel
+ * @param[in] color Color of the span (RGBA8888, its alpha is replaced by the alpha values)
+ *
+ */
+UI_DAL void ui_dal_blit_span_a8(int32_t x, int32_t y, int32_t width, const uint8_t *alpha, ui_color_t color);
+
+/**
+ * @brief ui_dal_fill_rect()
+ *
+ * Blend a rectangular region with the given color.
+ *
+ * @param[in] x x coordinate of the rectangular region
+ * @param[in] y y coordinate of the rectangular region
+ * @param[in] width Width of the rectangular region
+ * @param[in] height Height of the rectangular region
+ * @param[in] color Color of the region (RGBA8888, alpha is used for blending)
+ *
+ */
+UI_DAL void ui_dal_fill_rect(int32_t x, int32_t y, int32_t width, int32_t height, ui_color_t color);
+
 /**
  * @brief ui_dal_set_viewport()
  *
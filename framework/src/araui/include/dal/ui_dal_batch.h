@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __UI_DAL_BATCH_H__
+#define __UI_DAL_BATCH_H__
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <araui/ui_commons.h>
+
+/**
+ * @brief Rectangular copy of texels to the screen.
+ * The destination is already clipped and src points the first texel to copy.
+ */
+typedef struct {
+	int32_t x;              //!< x coordinate of the destination
+	int32_t y;              //!< y coordinate of the destination
+	int32_t width;          //!< width of the copy in pixels
+	int32_t height;         //!< height of the copy in pixels
+	const uint8_t *src;     //!< first texel of the source
+	int32_t stride;         //!< bytes per row of the source
+	ui_pixel_format_t pf;   //!< pixel format of the source (RGB888, RGBA8888 or A8)
+	ui_color_t color;       //!< color of A8 source (RGBA8888)
+} ui_dal_blit_cmd_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief ui_dal_batch_blit()
+ *
+ * Queue a blit command. The source memory must stay valid and unchanged
+ * until ui_dal_batch_flush() is called.
+ * If the queue is full, queued commands are flushed first.
+ *
+ * @param[in] cmd Blit command to queue
+ *
+ */
+void ui_dal_batch_blit(const ui_dal_blit_cmd_t *cmd);
+
+/**
+ * @brief ui_dal_batch_flush()
+ *
+ * Submit all queued blit commands in order.
+ * Commands are handed to DMA2D when it is enabled and the source can be used as is,
+ * otherwise they are drawn row by row through ui_dal_blit_span().
+ * It must be called before drawing anything else on the screen, and before ui_dal_redraw().
+ *
+ */
+void ui_dal_batch_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UI_DAL_BATCH_H__
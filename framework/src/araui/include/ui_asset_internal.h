@@ -62,6 +62,19 @@ typedef struct {
 	uint8_t *ttf_buf;
 } ui_font_asset_body_t;
 
+/**
+ * @brief Rasterized glyph kept in the glyph cache.
+ * The bitmap is A8 and its stride is the width.
+ */
+typedef struct {
+	int32_t x_offset;  //!< offset of the bitmap from the pen position
+	int32_t y_offset;  //!< offset of the bitmap from the baseline
+	int32_t width;
+	int32_t height;
+	int32_t advance;   //!< horizontal advance without kerning
+	uint8_t *bitmap;
+} ui_glyph_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -69,6 +82,10 @@ extern "C" {
 bool ui_asset_check_type(ui_asset_t asset, ui_asset_type_t type);
 bool ui_image_asset_has_alpha(ui_pixel_format_t format);
 
+const ui_glyph_t *ui_glyph_cache_get(ui_font_asset_body_t *font, size_t font_size, uint32_t codepoint);
+void ui_glyph_cache_remove_font(ui_font_asset_body_t *font);
+void ui_glyph_cache_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
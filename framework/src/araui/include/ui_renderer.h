@@ -76,6 +76,14 @@ void ui_renderer_scale(ui_mat3_t *mat, float x, float y);
 void ui_renderer_set_texture(uint8_t *bitmap, int32_t width, int32_t height, ui_pixel_format_t pf);
 void ui_renderer_set_fill_color(ui_color_t color);
 
+/**
+ * @brief Submit the queued blits to the DAL.
+ *
+ * Unrotated and unscaled quads are queued instead of being drawn immediately,
+ * so their texture must not be modified or freed until this function is called.
+ */
+void ui_renderer_flush(void);
+
 /**
  * @brief Rendering geometry functions
  * 
@@ -125,6 +125,12 @@ typedef struct {
 	ui_uv_t uv[4]; // top-left, bottom-left, bottom-right, top-right
 } ui_image_widget_body_t;
 
+typedef struct {
+	int32_t x;
+	int32_t y;
+	uint32_t code;
+} ui_text_run_t;
+
 typedef struct {
 	ui_widget_body_t base;
 	ui_font_asset_body_t *font;
@@ -136,6 +142,14 @@ typedef struct {
 	size_t line_num;
 	ui_align_t align;
 	bool word_wrap;
+
+	// Positioned glyphs, rebuilt only when the text or its layout changes
+	ui_text_run_t *runs;
+	size_t run_num;
+	int32_t ascent;
+	int32_t layout_width;
+	int32_t layout_height;
+	bool layout_valid;
 } ui_text_widget_body_t;
 
 typedef struct {
@@ -30,20 +30,39 @@
 #include "ui_math.h"
 #include "ui_debug.h"
 #include "dal/ui_dal.h"
+#include "dal/ui_dal_batch.h"
 
 #define MAX_RENDERER_MATRIX_STACK (256)
 #define UI_TM (g_rc.tm_stack[g_rc.sp])
 
-#define UI_SUB_DIVIDE_SHIFT (4)
-#define UI_SUB_DIVIDE_SIZE (1 << UI_SUB_DIVIDE_SHIFT)
 #define UI_SUB_PIX(a) (ceilf(a) - (a))
 
+/**
+ * @brief 16.16 fixed-point helpers used by the span rasterizer.
+ * Texture coordinates are kept in texel space so that the inner loop
+ * only needs a shift to get the texel index.
+ */
+#define UI_FIXED_SHIFT (16)
+#define UI_FIXED_ONE   (1 << UI_FIXED_SHIFT)
+#define UI_FIXED_HALF  (1 << (UI_FIXED_SHIFT - 1))
+#define UI_FLOAT_TO_FIXED(a) ((int32_t)((a) * (float)UI_FIXED_ONE))
+#define UI_FIXED_TO_TEXEL(a, max) (((a) < 0) ? 0 : ((((a) >> UI_FIXED_SHIFT) > (max)) ? (max) : ((a) >> UI_FIXED_SHIFT)))
+
+//!< Allowed difference between the quad size and the texel size to take the blit path
+#define UI_BLIT_EPSILON (0.01f)
+
 #define CONFIG_UI_DEFAULT_FILL_COLOR 0x000000
 
 /****************************************************************************
  * Private function declaration
  ****************************************************************************/
+static void ui_update_clip_rect(void);
+static bool ui_render_quad_blit(ui_mat3_t *trans_mat, ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4);
+static void ui_draw_triangle_uv(ui_mat3_t *trans_mat, ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3);
 static void ui_draw_triangle_segment(int32_t y1, int32_t y2);
+static void ui_draw_span(int32_t x, int32_t y, int32_t width, int32_t u, int32_t v);
 
 /****************************************************************************
  * Private types
@@ -54,33 +73,35 @@ typedef struct {
 	int32_t           tex_height;
 	ui_pixel_format_t tex_pf;
 	ui_color_t        fill_color;
+	ui_rect_t         clip;
 } ui_render_context_t;
 
 //!< Render context (global instance)
-ui_render_context_t g_rc = {
+static ui_render_context_t g_rc = {
 	.texture = NULL,
 	.tex_width = 0,
 	.tex_height = 0,
 	.tex_pf = UI_PIXEL_FORMAT_UNKNOWN,
-	.fill_color = CONFIG_UI_DEFAULT_FILL_COLOR
+	.fill_color = CONFIG_UI_DEFAULT_FILL_COLOR,
+	.clip = { 0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT }
 };
 
-float g_left_dxdy;
-float g_right_dxdy;
-float g_leftx;
-float g_rightx;
-float g_left_dudy;
-float g_leftu;
-float g_left_dvdy;
-float g_leftv;
-float g_left_dzdy;
-float g_leftz;
-float g_pk_dudx;
-float g_pk_dvdx;
-float g_pk_dzdx;
-float g_pk_dudx_;
-float g_pk_dvdx_;
-float g_pk_dzdx_;
+//!< Edge walking state of the triangle segment being rasterized (u, v are in texel space)
+static float g_left_dxdy;
+static float g_right_dxdy;
+static float g_leftx;
+static float g_rightx;
+static float g_left_dudy;
+static float g_leftu;
+static float g_left_dvdy;
+static float g_leftv;
+static float g_pk_dudx;
+static float g_pk_dvdx;
+static int32_t g_pk_dudx_fixed;
+static int32_t g_pk_dvdx_fixed;
+
+//!< A row of pixels is composed here (in the DAL span format) and then handed to the DAL at once
+static uint8_t g_span_buf[CONFIG_UI_DISPLAY_WIDTH * 4];
 
 /****************************************************************************
  * Public function implementation
@@ -190,19 +211,185 @@ void ui_renderer_set_fill_color(ui_color_t color)
 	g_rc.fill_color = color;
 }
 
+void ui_renderer_flush(void)
+{
+	ui_dal_batch_flush();
+}
+
 void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3,
 	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3)
+{
+	ui_update_clip_rect();
+	ui_draw_triangle_uv(trans_mat, v1, v2, v3, uv1, uv2, uv3);
+}
+
+void ui_render_quad_uv(ui_mat3_t *trans_mat,
+	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4)
+{
+	ui_update_clip_rect();
+
+	if (ui_render_quad_blit(trans_mat, v1, v2, v3, v4, uv1, uv2, uv3, uv4)) {
+		return;
+	}
+
+	ui_draw_triangle_uv(trans_mat, v1, v2, v3, uv1, uv2, uv3);
+	ui_draw_triangle_uv(trans_mat, v1, v3, v4, uv1, uv3, uv4);
+}
+
+/****************************************************************************
+ * Private function implementation
+ ****************************************************************************/
+static void ui_update_clip_rect(void)
+{
+	ui_rect_t vp;
+	int32_t x2;
+	int32_t y2;
+
+	g_rc.clip.x = 0;
+	g_rc.clip.y = 0;
+	g_rc.clip.width = CONFIG_UI_DISPLAY_WIDTH;
+	g_rc.clip.height = CONFIG_UI_DISPLAY_HEIGHT;
+
+	vp = ui_dal_get_viewport();
+	if (vp.width <= 0 || vp.height <= 0) {
+		return;
+	}
+
+	x2 = UI_MIN(vp.x + vp.width, CONFIG_UI_DISPLAY_WIDTH);
+	y2 = UI_MIN(vp.y + vp.height, CONFIG_UI_DISPLAY_HEIGHT);
+
+	g_rc.clip.x = UI_MAX(vp.x, 0);
+	g_rc.clip.y = UI_MAX(vp.y, 0);
+	g_rc.clip.width = UI_MAX(x2 - g_rc.clip.x, 0);
+	g_rc.clip.height = UI_MAX(y2 - g_rc.clip.y, 0);
+}
+
+/**
+ * @brief Draw the quad by copying texel rows directly.
+ *
+ * Image and text widgets without rotation and scaling end up here,
+ * which is the common case. The quad must be axis-aligned and map
+ * exactly one texel to one pixel, otherwise false is returned and
+ * the caller falls back to the triangle rasterizer.
+ * The copy is queued to the DAL batcher, see ui_renderer_flush().
+ */
+static bool ui_render_quad_blit(ui_mat3_t *trans_mat, ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4)
+{
+	int32_t x1;
+	int32_t y1;
+	int32_t x2;
+	int32_t y2;
+	int32_t tu;
+	int32_t tv;
+	ui_dal_blit_cmd_t cmd;
+
+	if (!g_rc.texture) {
+		return false;
+	}
+
+	if (trans_mat->m[0][0] != 1.0f || trans_mat->m[0][1] != 0.0f ||
+		trans_mat->m[1][0] != 0.0f || trans_mat->m[1][1] != 1.0f ||
+		trans_mat->m[2][0] != 0.0f || trans_mat->m[2][1] != 0.0f || trans_mat->m[2][2] != 1.0f) {
+		return false;
+	}
+
+	// v1: top-left, v2: bottom-left, v3: bottom-right, v4: top-right
+	if (v1.x != v2.x || v3.x != v4.x || v1.y != v4.y || v2.y != v3.y ||
+		uv1.u != uv2.u || uv3.u != uv4.u || uv1.v != uv4.v || uv2.v != uv3.v) {
+		return false;
+	}
+
+	if (v3.x <= v1.x || v3.y <= v1.y || uv3.u <= uv1.u || uv3.v <= uv1.v) {
+		return false;
+	}
+
+	// uv outside of the texture is left to the triangle path, which clamps every texel
+	if (uv1.u < 0.0f || uv1.v < 0.0f || uv3.u > 1.0f || uv3.v > 1.0f) {
+		return false;
+	}
+
+	if (fabsf((v3.x - v1.x) - ((uv3.u - uv1.u) * g_rc.tex_width)) > UI_BLIT_EPSILON ||
+		fabsf((v3.y - v1.y) - ((uv3.v - uv1.v) * g_rc.tex_height)) > UI_BLIT_EPSILON) {
+		return false;
+	}
+
+	x1 = (int32_t)ceilf(v1.x + trans_mat->m[0][2]);
+	y1 = (int32_t)ceilf(v1.y + trans_mat->m[1][2]);
+	x2 = (int32_t)ceilf(v3.x + trans_mat->m[0][2]);
+	y2 = (int32_t)ceilf(v3.y + trans_mat->m[1][2]);
+	// Same uv to texel scaling as the triangle path
+	tu = (int32_t)((uv1.u * (g_rc.tex_width - 1)) + 0.5f);
+	tv = (int32_t)((uv1.v * (g_rc.tex_height - 1)) + 0.5f);
+	tu = UI_MAX(0, UI_MIN(tu, g_rc.tex_width - 1));
+	tv = UI_MAX(0, UI_MIN(tv, g_rc.tex_height - 1));
+
+	if (x2 - x1 > g_rc.tex_width - tu) {
+		x2 = x1 + g_rc.tex_width - tu;
+	}
+	if (y2 - y1 > g_rc.tex_height - tv) {
+		y2 = y1 + g_rc.tex_height - tv;
+	}
+
+	if (x1 < g_rc.clip.x) {
+		tu += g_rc.clip.x - x1;
+		x1 = g_rc.clip.x;
+	}
+	if (y1 < g_rc.clip.y) {
+		tv += g_rc.clip.y - y1;
+		y1 = g_rc.clip.y;
+	}
+	x2 = UI_MIN(x2, g_rc.clip.x + g_rc.clip.width);
+	y2 = UI_MIN(y2, g_rc.clip.y + g_rc.clip.height);
+
+	if (x1 >= x2 || y1 >= y2) {
+		return true;
+	}
+
+	cmd.x = x1;
+	cmd.y = y1;
+	cmd.width = x2 - x1;
+	cmd.height = y2 - y1;
+	cmd.pf = g_rc.tex_pf;
+	cmd.color = UI_COLOR_RGBA8888((g_rc.fill_color & 0xff0000) >> 16, (g_rc.fill_color & 0x00ff00) >> 8, (g_rc.fill_color & 0x0000ff), 0);
+
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGBA8888:
+		cmd.stride = g_rc.tex_width * 4;
+		cmd.src = g_rc.texture + (tv * cmd.stride) + (tu * 4);
+		break;
+
+	case UI_PIXEL_FORMAT_RGB888:
+		cmd.stride = g_rc.tex_width * 3;
+		cmd.src = g_rc.texture + (tv * cmd.stride) + (tu * 3);
+		break;
+
+	case UI_PIXEL_FORMAT_A8:
+		cmd.stride = g_rc.tex_width;
+		cmd.src = g_rc.texture + (tv * cmd.stride) + tu;
+		break;
+
+	default:
+		return true;
+	}
+
+	ui_dal_batch_blit(&cmd);
+
+	return true;
+}
+
+static void ui_draw_triangle_uv(ui_mat3_t *trans_mat,
+	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3)
 {
 	float u_a;
 	float v_a;
-	float z_a;
 	float u_b;
 	float v_b;
-	float z_b;
 	float u_c;
 	float v_c;
-	float z_c;
 	int32_t y1i;
 	int32_t y2i;
 	int32_t y3i;
@@ -216,11 +403,15 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	float dVdY_V1V3;
 	float dVdY_V2V3;
 	float dVdY_V1V2;
-	float dZdY_V1V3;
-	float dZdY_V2V3;
-	float dZdY_V1V2;
 	float denom;
 
+	if (!g_rc.texture) {
+		return;
+	}
+
+	// Spans are drawn immediately, queued blits must land on the screen first
+	ui_dal_batch_flush();
+
 	v1 = ui_mat3_vec3_multiply(trans_mat, &v1);
 	v2 = ui_mat3_vec3_multiply(trans_mat, &v2);
 	v3 = ui_mat3_vec3_multiply(trans_mat, &v3);
@@ -246,15 +437,13 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 		return;
 	}
 
-	u_a = uv1.u;
-	u_b = uv2.u;
-	u_c = uv3.u;
-	v_a = uv1.v;
-	v_b = uv2.v;
-	v_c = uv3.v;
-	z_a = 1.0f;
-	z_b = 1.0f;
-	z_c = 1.0f;
+	// Work in texel space, so that the span loop does not need to scale uv per pixel
+	u_a = uv1.u * (g_rc.tex_width - 1);
+	u_b = uv2.u * (g_rc.tex_width - 1);
+	u_c = uv3.u * (g_rc.tex_width - 1);
+	v_a = uv1.v * (g_rc.tex_height - 1);
+	v_b = uv2.v * (g_rc.tex_height - 1);
+	v_c = uv3.v * (g_rc.tex_height - 1);
 
 	dXdY_V1V3 = (v3.x - v1.x) / (v3.y - v1.y);
 	dXdY_V2V3 = (v3.x - v2.x) / (v3.y - v2.y);
@@ -268,10 +457,6 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	dVdY_V2V3 = (v_c - v_b) / (v3.y - v2.y);
 	dVdY_V1V2 = (v_b - v_a) / (v2.y - v1.y);
 
-	dZdY_V1V3 = (z_c - z_a) / (v3.y - v1.y);
-	dZdY_V2V3 = (z_c - z_b) / (v3.y - v2.y);
-	dZdY_V1V2 = (z_b - z_a) / (v2.y - v1.y);
-
 	denom = ((v3.x - v1.x) * (v2.y - v1.y) - (v2.x - v1.x) * (v3.y - v1.y));
 
 	if (!denom) {
@@ -282,11 +467,9 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 
 	g_pk_dudx = ((u_c - u_a) * (v2.y - v1.y) - (u_b - u_a) * (v3.y - v1.y)) * denom;
 	g_pk_dvdx = ((v_c - v_a) * (v2.y - v1.y) - (v_b - v_a) * (v3.y - v1.y)) * denom;
-	g_pk_dzdx = ((z_c - z_a) * (v2.y - v1.y) - (z_b - z_a) * (v3.y - v1.y)) * denom;
 
-	g_pk_dudx_ = g_pk_dudx * UI_SUB_DIVIDE_SIZE;
-	g_pk_dvdx_ = g_pk_dvdx * UI_SUB_DIVIDE_SIZE;
-	g_pk_dzdx_ = g_pk_dzdx * UI_SUB_DIVIDE_SIZE;
+	g_pk_dudx_fixed = UI_FLOAT_TO_FIXED(g_pk_dudx);
+	g_pk_dvdx_fixed = UI_FLOAT_TO_FIXED(g_pk_dvdx);
 
 	bool mid = dXdY_V1V3 < dXdY_V1V2;
 	if (!mid) {
@@ -295,13 +478,11 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 
 			g_left_dudy = dUdY_V2V3;
 			g_left_dvdy = dVdY_V2V3;
-			g_left_dzdy = dZdY_V2V3;
 			g_left_dxdy = dXdY_V2V3;
 			g_right_dxdy = dXdY_V1V3;
 
 			g_leftu = u_b + UI_SUB_PIX(v2.y) * g_left_dudy;
 			g_leftv = v_b + UI_SUB_PIX(v2.y) * g_left_dvdy;
-			g_leftz = z_b + UI_SUB_PIX(v2.y) * g_left_dzdy;
 			g_leftx = v2.x + UI_SUB_PIX(v2.y) * g_left_dxdy;
 			g_rightx = v1.x + prestep * g_right_dxdy;
 
@@ -316,12 +497,10 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 
 			g_left_dudy = dUdY_V1V2;
 			g_left_dvdy = dVdY_V1V2;
-			g_left_dzdy = dZdY_V1V2;
 			g_left_dxdy = dXdY_V1V2;
 
 			g_leftu = u_a + prestep * g_left_dudy;
 			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
 			g_leftx = v1.x + prestep * g_left_dxdy;
 			g_rightx = v1.x + prestep * g_right_dxdy;
 
@@ -333,11 +512,9 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 			g_left_dxdy = dXdY_V2V3;
 			g_left_dudy = dUdY_V2V3;
 			g_left_dvdy = dVdY_V2V3;
-			g_left_dzdy = dZdY_V2V3;
 
 			g_leftu = u_b + UI_SUB_PIX(v2.y) * g_left_dudy;
 			g_leftv = v_b + UI_SUB_PIX(v2.y) * g_left_dvdy;
-			g_leftz = z_b + UI_SUB_PIX(v2.y) * g_left_dzdy;
 			g_leftx = v2.x + UI_SUB_PIX(v2.y) * g_left_dxdy;
 
 			ui_draw_triangle_segment(y2i, y3i);
@@ -350,13 +527,11 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 
 			g_left_dudy = dUdY_V1V3;
 			g_left_dvdy = dVdY_V1V3;
-			g_left_dzdy = dZdY_V1V3;
 			g_left_dxdy = dXdY_V1V3;
 			g_right_dxdy = dXdY_V2V3;
 
 			g_leftu = u_a + prestep * g_left_dudy;
 			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
 			g_leftx = v1.x + prestep * g_left_dxdy;
 			g_rightx = v2.x + UI_SUB_PIX(v2.y) * g_right_dxdy;
 
@@ -367,7 +542,6 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 		g_left_dxdy = dXdY_V1V3;
 		g_left_dudy = dUdY_V1V3;
 		g_left_dvdy = dVdY_V1V3;
-		g_left_dzdy = dZdY_V1V3;
 
 		if (y1i < y2i) {
 
@@ -375,7 +549,6 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 
 			g_leftu = u_a + prestep * g_left_dudy;
 			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
 			g_leftx = v1.x + prestep * g_left_dxdy;
 			g_rightx = v1.x + prestep * g_right_dxdy;
 
@@ -391,166 +564,94 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	}
 }
 
-void ui_render_quad_uv(ui_mat3_t *trans_mat,
-	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
-	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4)
-{
-	ui_render_triangle_uv(trans_mat, v1, v2, v3, uv1, uv2, uv3);
-	ui_render_triangle_uv(trans_mat, v1, v3, v4, uv1, uv3, uv4);
-}
-
-/****************************************************************************
- * Private function implementation
- ****************************************************************************/
 static void ui_draw_triangle_segment(int32_t y1, int32_t y2)
 {
-	float u;
-	float v;
-	float z;
-	float Z;
-	int32_t du;
-	int32_t dv;
-	int32_t width;
-	int32_t U;
-	int32_t V;
-	int32_t U1;
-	int32_t V1;
-	int32_t U2;
-	int32_t V2;
+	float prestep;
 	int32_t x1;
 	int32_t x2;
 	int32_t y;
-	int32_t x;
-	int32_t iu;
-	int32_t iv;
-	int32_t uv_offset;
+	int32_t clip_x2;
+	int32_t clip_y2;
 
-	for (y = y1; y < y2; y++) {
+	clip_x2 = g_rc.clip.x + g_rc.clip.width;
+	clip_y2 = g_rc.clip.y + g_rc.clip.height;
 
-		x1 = ceilf(g_leftx);
-		x2 = ceilf(g_rightx);
-
-		u = g_leftu + UI_SUB_PIX(g_leftx) * g_pk_dudx;
-		v = g_leftv + UI_SUB_PIX(g_leftx) * g_pk_dvdx;
-		z = g_leftz + UI_SUB_PIX(g_leftx) * g_pk_dzdx;
-
-		Z = 65536.0f;
-		U2 = u * Z;
-		V2 = v * Z;
-		width = x2 - x1;
-
-		while (width >= UI_SUB_DIVIDE_SIZE) {
-
-			u += g_pk_dudx_;
-			v += g_pk_dvdx_;
-			z += g_pk_dzdx_;
-
-			U1 = U2;
-			V1 = V2;
-
-			Z = 65536.0f;
-			U2 = u * Z;
-			V2 = v * Z;
-
-			du = (U2 - U1) >> UI_SUB_DIVIDE_SHIFT;
-			dv = (V2 - V1) >> UI_SUB_DIVIDE_SHIFT;
-			U = U1;
-			V = V1;
-			x = UI_SUB_DIVIDE_SIZE;
-
-			while (x--) {
-				iu = (int32_t)((U / 65536.0f) * (g_rc.tex_width - 1) + 0.5f);
-				iv = (int32_t)((V / 65536.0f) * (g_rc.tex_height - 1) + 0.5f);
-
-				if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGBA8888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 4;
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2],
-						g_rc.texture[uv_offset + 3]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGB888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 3;
-					ui_dal_put_pixel_rgb888(x1++, y, UI_COLOR_RGB888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_A8) {
-					uv_offset = ((iv * g_rc.tex_width) + iu);
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						(g_rc.fill_color & 0xff0000) >> 16,
-						(g_rc.fill_color & 0x00ff00) >> 8,
-						(g_rc.fill_color & 0x0000ff) >> 0,
-						g_rc.texture[uv_offset]
-					));
-				}
-
-				U += du;
-				V += dv;
+	for (y = y1; y < y2; y++) {
+		if (y >= g_rc.clip.y && y < clip_y2) {
+			x1 = (int32_t)ceilf(g_leftx);
+			x2 = (int32_t)ceilf(g_rightx);
+			prestep = UI_SUB_PIX(g_leftx);
+
+			if (x1 < g_rc.clip.x) {
+				prestep += (float)(g_rc.clip.x - x1);
+				x1 = g_rc.clip.x;
+			}
+			if (x2 > clip_x2) {
+				x2 = clip_x2;
 			}
 
-			width -= UI_SUB_DIVIDE_SIZE;
-		}
-
-		if (width > 0) {
-
-			U1 = U2;
-			V1 = V2;
-
-			u += (g_pk_dudx * width);
-			v += (g_pk_dvdx * width);
-			z += (g_pk_dzdx * width);
-
-			Z = 65536.0f;
-			U2 = u * Z;
-			V2 = v * Z;
-
-			du = (U2 - U1) / width;
-			dv = (V2 - V1) / width;
-			U = U1;
-			V = V1;
-
-			while (width--) {
-				iu = (int32_t)((U / 65536.0f) * (g_rc.tex_width - 1) + 0.5f);
-				iv = (int32_t)((V / 65536.0f) * (g_rc.tex_height - 1) + 0.5f);
-
-				if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGBA8888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 4;
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2],
-						g_rc.texture[uv_offset + 3]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGB888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 3;
-					ui_dal_put_pixel_rgb888(x1++, y, UI_COLOR_RGB888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_A8) {
-					uv_offset = ((iv * g_rc.tex_width) + iu);
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						(g_rc.fill_color & 0xff0000) >> 16,
-						(g_rc.fill_color & 0x00ff00) >> 8,
-						(g_rc.fill_color & 0x0000ff) >> 0,
-						g_rc.texture[uv_offset]
-					));
-				}
-
-				U += du;
-				V += dv;
+			if (x1 < x2) {
+				// Only one float to fixed conversion per row, the span is walked in 16.16
+				ui_draw_span(x1, y, x2 - x1,
+					UI_FLOAT_TO_FIXED(g_leftu + prestep * g_pk_dudx) + UI_FIXED_HALF,
+					UI_FLOAT_TO_FIXED(g_leftv + prestep * g_pk_dvdx) + UI_FIXED_HALF);
 			}
 		}
 
 		g_leftu += g_left_dudy;
 		g_leftv += g_left_dvdy;
-		g_leftz += g_left_dzdy;
 		g_leftx += g_left_dxdy;
 		g_rightx += g_right_dxdy;
 	}
 }
 
+static void ui_draw_span(int32_t x, int32_t y, int32_t width, int32_t u, int32_t v)
+{
+	const uint8_t *texel;
+	uint8_t *dst = g_span_buf;
+	const int32_t du = g_pk_dudx_fixed;
+	const int32_t dv = g_pk_dvdx_fixed;
+	const int32_t max_u = g_rc.tex_width - 1;
+	const int32_t max_v = g_rc.tex_height - 1;
+	int32_t n = width;
+
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGBA8888:
+		while (n--) {
+			texel = g_rc.texture + (((UI_FIXED_TO_TEXEL(v, max_v) * g_rc.tex_width) + UI_FIXED_TO_TEXEL(u, max_u)) << 2);
+			*dst++ = texel[0];
+			*dst++ = texel[1];
+			*dst++ = texel[2];
+			*dst++ = texel[3];
+			u += du;
+			v += dv;
+		}
+		ui_dal_blit_span(x, y, width, g_span_buf, UI_PIXEL_FORMAT_RGBA8888);
+		break;
+
+	case UI_PIXEL_FORMAT_RGB888:
+		while (n--) {
+			texel = g_rc.texture + (((UI_FIXED_TO_TEXEL(v, max_v) * g_rc.tex_width) + UI_FIXED_TO_TEXEL(u, max_u)) * 3);
+			*dst++ = texel[0];
+			*dst++ = texel[1];
+			*dst++ = texel[2];
+			u += du;
+			v += dv;
+		}
+		ui_dal_blit_span(x, y, width, g_span_buf, UI_PIXEL_FORMAT_RGB888);
+		break;
+
+	case UI_PIXEL_FORMAT_A8:
+		while (n--) {
+			*dst++ = g_rc.texture[(UI_FIXED_TO_TEXEL(v, max_v) * g_rc.tex_width) + UI_FIXED_TO_TEXEL(u, max_u)];
+			u += du;
+			v += dv;
+		}
+		ui_dal_blit_span_a8(x, y, width, g_span_buf,
+			UI_COLOR_RGBA8888((g_rc.fill_color & 0xff0000) >> 16, (g_rc.fill_color & 0x00ff00) >> 8, (g_rc.fill_color & 0x0000ff), 0));
+		break;
+
+	default:
+		break;
+	}
+}
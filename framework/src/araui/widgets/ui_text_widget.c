@@ -64,8 +64,6 @@ typedef struct {
 } ui_set_font_size_info_t;
 
 #define CONFIG_UI_TEXT_FORMAT_MAX_LENGTH  512
-#define CONFIG_UI_GLYPH_BITMAP_WIDTH      256
-#define CONFIG_UI_GLYPH_BITMAP_HEIGHT     256
 #define CONFIG_UI_DEFAULT_FILL_COLOR      0x000000
 
 static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const char *text);
@@ -77,8 +75,8 @@ static void _ui_text_widget_set_color(void *userdata);
 static void _ui_text_widget_set_word_wrap_func(void *userdata);
 static void _ui_text_widget_set_font_size_func(void *userdata);
 static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body);
-
-static uint8_t g_glyph_bitmap[CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT];
+static uint32_t _ui_text_widget_char_width(ui_text_widget_body_t *body, float scale, size_t utf_idx);
+static ui_error_t _ui_text_widget_layout(ui_text_widget_body_t *body);
 
 ui_widget_t ui_text_widget_create(int32_t width, int32_t height, ui_asset_t font, const char *text, size_t font_size)
 {
@@ -215,6 +213,7 @@ static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const ch
 
 	body->text_length = utf_idx;
 	_ui_text_widget_calculate_line_num(body);
+	body->layout_valid = false;
 
 	return UI_OK;
 }
@@ -378,6 +377,7 @@ static void _ui_text_widget_set_align_func(void *userdata)
 	info = (ui_set_align_info_t *)userdata;
 
 	info->body->align = info->align;
+	info->body->layout_valid = false;
 	info->body->base.update_flag = true;
 
 	UI_FREE(info);
@@ -426,61 +426,32 @@ static void _ui_text_widget_set_color(void *userdata)
 	UI_FREE(info);
 }
 
-static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
+static ui_error_t _ui_text_widget_layout(ui_text_widget_body_t *body)
 {
-	ui_text_widget_body_t *body;
 	float scale;
 	int ascent;
 	int i;
-	int c_x1;
-	int c_y1;
-	int c_x2;
-	int c_y2;
-	int out_w;
-	int out_h;
-	int x;
-	int y;
+	int32_t x;
+	int32_t y;
 	int32_t text_width;
 	size_t utf_idx = 0;
 	size_t draw_idx = 0;
-#if defined(CONFIG_UI_DISPLAY_RGB888)
-	uint8_t r = 0;
-	uint8_t g = 0;
-	uint8_t b = 0;
-	uint8_t a = 0;
-#endif
-	ui_vec3_t v1;
-	ui_vec3_t v2;
-	ui_vec3_t v3;
-	ui_vec3_t v4;
-	ui_mat3_t text_mat;
 
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-	ui_bitmap_data_t *emoji_bitmap;
-	ui_vec3_t emoji_v1;
-	ui_vec3_t emoji_v2;
-	ui_vec3_t emoji_v3;
-	ui_vec3_t emoji_v4;
-#endif
-
-	if (!widget) {
-		UI_LOGE("error: Invalid Parameter!\n");
-		return;
-	}
+	UI_FREE(body->runs);
+	body->runs = NULL;
+	body->run_num = 0;
 
-	body = (ui_text_widget_body_t *)widget;
-
-	if (!body->text_length) {
-		UI_LOGD("Empty text widget!\n");
-		return;
+	if (body->text_length) {
+		body->runs = (ui_text_run_t *)UI_ALLOC(body->text_length * sizeof(ui_text_run_t));
+		if (!body->runs) {
+			return UI_NOT_ENOUGH_MEMORY;
+		}
 	}
 
-	memset(g_glyph_bitmap, 0, CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT);
-
 	scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
 
 	stbtt_GetFontVMetrics(&(body->font->ttf_info), &ascent, NULL, NULL);
-	ascent *= scale;
+	body->ascent = ascent * scale;
 
 	x = 0;
 	y = 0;
@@ -491,7 +462,7 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 		y = (body->base.global_rect.height - ((int32_t)body->line_num * body->font_size));
 	}
 
-	for (i = 0; i < body->line_num; i++) {
+	for (i = 0; i < body->line_num && body->text_length; i++) {
 		// Calculate the width of text
 		text_width = 0;
 		while (body->utf_code[utf_idx] != '\n') {
@@ -525,103 +496,143 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 			x = (body->base.global_rect.width - text_width);
 		}
 
-#if defined(CONFIG_UI_DISPLAY_RGB888)
-		a = ((ui_color_argb8888_t *)&(body->font_color))->a;
-		r = ((ui_color_argb8888_t *)&(body->font_color))->r;
-		g = ((ui_color_argb8888_t *)&(body->font_color))->g;
-		b = ((ui_color_argb8888_t *)&(body->font_color))->b;
-#endif
-
 		while (draw_idx < utf_idx) {
 			if (body->utf_code[draw_idx] == '\n') {
 				draw_idx++;
 				continue;
 			}
 
+			body->runs[body->run_num].x = x;
+			body->runs[body->run_num].y = y;
+			body->runs[body->run_num].code = body->utf_code[draw_idx];
+			body->run_num++;
+
+			x += body->width_array[draw_idx];
+			draw_idx++;
+		}
+
+		y += body->font_size;
+	}
+
+	body->layout_width = body->base.global_rect.width;
+	body->layout_height = body->base.global_rect.height;
+	body->layout_valid = true;
+
+	return UI_OK;
+}
+
+static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
+{
+	ui_text_widget_body_t *body;
+	const ui_glyph_t *glyph;
+	ui_text_run_t *run;
+	size_t run_idx;
+	ui_vec3_t v1;
+	ui_vec3_t v2;
+	ui_vec3_t v3;
+	ui_vec3_t v4;
+	ui_mat3_t text_mat;
+
 #if defined(CONFIG_UI_ENABLE_EMOJI)
-			// If the code is emoji
-			if (is_emoji(body->utf_code[draw_idx])) {
-				emoji_bitmap = emoji_get_bitmap(body->utf_code[draw_idx]);
-				if (emoji_bitmap) {
-					ui_renderer_set_texture(
-						((uint8_t *)emoji_bitmap) + sizeof(ui_bitmap_data_t),
-						emoji_bitmap->width,
-						emoji_bitmap->height,
-						emoji_bitmap->pf);
-
-						emoji_v1 = (ui_vec3_t){ .x = x - body->base.global_rect.x, .y = y - body->base.global_rect.y, .w = 1.0f };
-						emoji_v2 = (ui_vec3_t){ .x = x - body->base.global_rect.x, .y = y - body->base.global_rect.y + body->font_size, .w = 1.0f };
-						emoji_v3 = (ui_vec3_t){ .x = x - body->base.global_rect.x + body->font_size, .y = y - body->base.global_rect.y + body->font_size, .w = 1.0f };
-						emoji_v4 = (ui_vec3_t){ .x = x - body->base.global_rect.x + body->font_size, .y = y - body->base.global_rect.y, .w = 1.0f };
-
-						ui_render_quad_uv(&body->base.trans_mat, emoji_v1, emoji_v2, emoji_v3, emoji_v4,
-							(ui_uv_t){ 0.0f, 0.0f },
-							(ui_uv_t){ 0.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 0.0f });
-
-						ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
-				}
-				x += body->font_size;
-			} else {
+	ui_bitmap_data_t *emoji_bitmap;
+	ui_vec3_t emoji_v1;
+	ui_vec3_t emoji_v2;
+	ui_vec3_t emoji_v3;
+	ui_vec3_t emoji_v4;
 #endif
-				/* get bounding box for character (may be offset to account for chars that dip above or below the line */
-				stbtt_GetCodepointBitmapBox(&(body->font->ttf_info), body->utf_code[draw_idx],
-					scale, scale, &c_x1, &c_y1, &c_x2, &c_y2);
-
-				out_w = c_x2 - c_x1;
-				out_h = c_y2 - c_y1;
-
-				/* render character (stride and offset is important here) */
-				stbtt_MakeCodepointBitmap(&(body->font->ttf_info), g_glyph_bitmap,
-					out_w, out_h,
-					out_w,
-					scale, scale,
-					body->utf_code[draw_idx]);
-
-				ui_renderer_translate(&body->base.trans_mat, &text_mat, (float)x, (float)(y + ascent + c_y1));
-				ui_renderer_set_texture(g_glyph_bitmap, out_w, out_h, UI_PIXEL_FORMAT_A8);
-				ui_renderer_set_fill_color(body->font_color);
-
-				v1 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = 0.0f,
-					1.0f
-				};
-				v2 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = out_h,
-					1.0f
-				};
-				v3 = (ui_vec3_t){
-					.x = out_w,
-					.y = out_h,
-					1.0f
-				};
-				v4 = (ui_vec3_t){
-					.x = out_w,
-					.y = 0.0f,
-					1.0f
-				};
-
-				ui_render_quad_uv(&text_mat, v1, v2, v3, v4,
-							(ui_uv_t){ 0.0f, 0.0f },
-							(ui_uv_t){ 0.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 0.0f });
 
-				ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
-				ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
-				memset(g_glyph_bitmap, 0, out_w * out_h);
+	if (!widget) {
+		UI_LOGE("error: Invalid Parameter!\n");
+		return;
+	}
+
+	body = (ui_text_widget_body_t *)widget;
+
+	if (!body->text_length) {
+		UI_LOGD("Empty text widget!\n");
+		return;
+	}
+
+	// Alignment depends on the widget size, so a resized widget is laid out again
+	if (!body->layout_valid ||
+		body->layout_width != body->base.global_rect.width ||
+		body->layout_height != body->base.global_rect.height) {
+		if (_ui_text_widget_layout(body) != UI_OK) {
+			UI_LOGE("error: out of memory!\n");
+			return;
+		}
+	}
+
+	for (run_idx = 0; run_idx < body->run_num; run_idx++) {
+		run = &body->runs[run_idx];
 
-				x += body->width_array[draw_idx];
 #if defined(CONFIG_UI_ENABLE_EMOJI)
+		// If the code is emoji
+		if (is_emoji(run->code)) {
+			emoji_bitmap = emoji_get_bitmap(run->code);
+			if (emoji_bitmap) {
+				ui_renderer_set_texture(
+					((uint8_t *)emoji_bitmap) + sizeof(ui_bitmap_data_t),
+					emoji_bitmap->width,
+					emoji_bitmap->height,
+					emoji_bitmap->pf);
+
+				emoji_v1 = (ui_vec3_t){ .x = run->x - body->base.global_rect.x, .y = run->y - body->base.global_rect.y, .w = 1.0f };
+				emoji_v2 = (ui_vec3_t){ .x = run->x - body->base.global_rect.x, .y = run->y - body->base.global_rect.y + body->font_size, .w = 1.0f };
+				emoji_v3 = (ui_vec3_t){ .x = run->x - body->base.global_rect.x + body->font_size, .y = run->y - body->base.global_rect.y + body->font_size, .w = 1.0f };
+				emoji_v4 = (ui_vec3_t){ .x = run->x - body->base.global_rect.x + body->font_size, .y = run->y - body->base.global_rect.y, .w = 1.0f };
+
+				ui_render_quad_uv(&body->base.trans_mat, emoji_v1, emoji_v2, emoji_v3, emoji_v4,
+					(ui_uv_t){ 0.0f, 0.0f },
+					(ui_uv_t){ 0.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 0.0f });
+
+				ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
 			}
+			continue;
+		}
 #endif
-			draw_idx++;
+
+		// Glyphs are rasterized once and reused from the glyph cache
+		glyph = ui_glyph_cache_get(body->font, body->font_size, run->code);
+		if (!glyph || !glyph->bitmap) {
+			continue;
 		}
 
-		y += body->font_size;
+		ui_renderer_translate(&body->base.trans_mat, &text_mat, (float)run->x, (float)(run->y + body->ascent + glyph->y_offset));
+		ui_renderer_set_texture(glyph->bitmap, glyph->width, glyph->height, UI_PIXEL_FORMAT_A8);
+		ui_renderer_set_fill_color(body->font_color);
+
+		v1 = (ui_vec3_t){
+			.x = 0.0f,
+			.y = 0.0f,
+			1.0f
+		};
+		v2 = (ui_vec3_t){
+			.x = 0.0f,
+			.y = glyph->height,
+			1.0f
+		};
+		v3 = (ui_vec3_t){
+			.x = glyph->width,
+			.y = glyph->height,
+			1.0f
+		};
+		v4 = (ui_vec3_t){
+			.x = glyph->width,
+			.y = 0.0f,
+			1.0f
+		};
+
+		ui_render_quad_uv(&text_mat, v1, v2, v3, v4,
+					(ui_uv_t){ 0.0f, 0.0f },
+					(ui_uv_t){ 0.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 0.0f });
+
+		ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+		ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
 	}
 }
 
@@ -638,6 +649,7 @@ static void _ui_text_widget_removed_func(ui_widget_t widget)
 
 	UI_FREE(body->utf_code);
 	UI_FREE(body->width_array);
+	UI_FREE(body->runs);
 }
 
 ui_error_t ui_text_widget_set_word_wrap(ui_widget_t widget, bool word_wrap)
@@ -694,6 +706,7 @@ static void _ui_text_widget_set_word_wrap_func(void *userdata)
 	// According to the text wrap option, a line number of the text widget can be differ from the current one.
 	// Therefore, this value should be recalculated.
 	_ui_text_widget_calculate_line_num(body);
+	body->layout_valid = false;
 	body->base.update_flag = true;
 
 	UI_FREE(info);
@@ -753,19 +766,48 @@ static void _ui_text_widget_set_font_size_func(void *userdata)
 	// According to the text wrap option, a line number of the text widget can be differ from the current one.
 	// Therefore, this value should be recalculated.
 	_ui_text_widget_calculate_line_num(body);
+	body->layout_valid = false;
 	body->base.update_flag = true;
 
 	UI_FREE(info);
 }
 
+/**
+ * @brief Width of the character at utf_idx including the kerning to the next one.
+ * The advance is read from the font metrics, the same way the glyph cache computes it.
+ * It does not use the glyph cache itself, which is only touched by the UI core thread
+ * while this also runs on the app thread from ui_text_widget_create().
+ */
+static uint32_t _ui_text_widget_char_width(ui_text_widget_body_t *body, float scale, size_t utf_idx)
+{
+	uint32_t width;
+	int ax;
+	int kern;
+
+#if defined(CONFIG_UI_ENABLE_EMOJI)
+	if (is_emoji(body->utf_code[utf_idx])) {
+		return body->font_size;
+	}
+#endif
+
+	stbtt_GetCodepointHMetrics(&(body->font->ttf_info), body->utf_code[utf_idx], &ax, 0);
+	width = ax * scale;
+
+	if (utf_idx < body->text_length - 1) {
+		kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info), body->utf_code[utf_idx + 1],
+			stbtt_FindGlyphIndex(&(body->font->ttf_info), body->utf_code[utf_idx + 1]));
+		width += kern * scale;
+	}
+
+	return width;
+}
+
 static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body)
 {
 	size_t utf_idx = 0;
 	size_t text_width = 0;
 	size_t line_num = 1;
 	float scale;
-	int ax;
-	int kern;
 
 	if (!body) {
 		UI_LOGE("error: invalid parameter!\n");
@@ -781,22 +823,7 @@ static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body)
 				text_width = 0;
 				body->width_array[utf_idx] = 0;
 			} else {
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-				if (is_emoji(body->utf_code[utf_idx])) {
-					body->width_array[utf_idx] = body->font_size;
-				} else {
-#endif
-					stbtt_GetCodepointHMetrics(&(body->font->ttf_info),  body->utf_code[utf_idx], &ax, 0);
-					body->width_array[utf_idx] = ax * scale;
-
-					if (utf_idx < body->text_length - 1) {
-						kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info), body->utf_code[utf_idx + 1],
-							stbtt_FindGlyphIndex(&(body->font->ttf_info), body->utf_code[utf_idx + 1]));
-						body->width_array[utf_idx] += kern * scale;
-					}
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-				}
-#endif
+				body->width_array[utf_idx] = _ui_text_widget_char_width(body, scale, utf_idx);
 
 				text_width += body->width_array[utf_idx];
 				if (text_width > body->base.local_rect.width) {
@@ -814,22 +841,7 @@ static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body)
 				line_num++;
 			}
 
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-			if (is_emoji(body->utf_code[utf_idx])) {
-				body->width_array[utf_idx] = body->font_size;
-			} else {
-#endif
-				stbtt_GetCodepointHMetrics(&(body->font->ttf_info),  body->utf_code[utf_idx], &ax, 0);
-				body->width_array[utf_idx] = ax * scale;
-
-				if (utf_idx < body->text_length - 1) {
-					kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info), body->utf_code[utf_idx + 1],
-						stbtt_FindGlyphIndex(&(body->font->ttf_info), body->utf_code[utf_idx + 1]));
-					body->width_array[utf_idx] += kern * scale;
-				}
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-			}
-#endif
+			body->width_array[utf_idx] = _ui_text_widget_char_width(body, scale, utf_idx);
 			utf_idx++;
 		}
 		body->line_num = line_num;
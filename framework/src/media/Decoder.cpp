@@ -135,6 +135,26 @@ bool Decoder::getFrame(unsigned char *buf, size_t *size, unsigned int *sampleRat
 #endif
 }
 
+#ifdef CONFIG_MEDIA_STATISTICS
+/**
+ * @brief   Get the frame resyncs done since the last call
+ * @param   count: number of resyncs
+ * @param   time:  time spent in them, in microseconds
+ */
+void Decoder::takeResyncStatistics(unsigned int *count, unsigned int *time)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	*count = mDecoder.resyncs;
+	*time = mDecoder.resync_time;
+	mDecoder.resyncs = 0;
+	mDecoder.resync_time = 0;
+#else
+	*count = 0;
+	*time = 0;
+#endif
+}
+#endif
+
 bool Decoder::empty()
 {
 #ifdef CONFIG_AUDIO_CODEC
@@ -43,6 +43,9 @@ public:
 	bool getFrame(unsigned char *buf, size_t *size, unsigned int *sampleRate, unsigned short *channels);
 	bool empty();
 	size_t getAvailSpace();
+#ifdef CONFIG_MEDIA_STATISTICS
+	void takeResyncStatistics(unsigned int *count, unsigned int *time);
+#endif
 
 private:
 #ifdef CONFIG_AUDIO_CODEC
@@ -104,6 +104,17 @@ public:
 	 *         DEMUXER_ERROR_WANT_DATA means demuxer expect more input data.
 	 */
 	virtual ssize_t pullData(unsigned char *buf, size_t size, void *param = nullptr) = 0;
+	/**
+	 * @brief Pull audio elementary stream data from demuxer without copying it
+	 *        Derived class should implement it
+	 * @param[out] buf: set to the data kept by demuxer, it stays valid until
+	 *             the next call of pullData() or pullDataRef()
+	 * @param[in] size: maximum number of bytes wanted
+	 * @return number of bytes of data referred by `buf` on success,
+	 *         negative value (see demuxer_error_t) on failure,
+	 *         DEMUXER_ERROR_WANT_DATA means demuxer expect more input data.
+	 */
+	virtual ssize_t pullDataRef(unsigned char **buf, size_t size, void *param = nullptr) = 0;
 	/**
 	 * @brief Get size in bytes that demuxer can accept equivalent input stream data surely
 	 *        Derived class should implement it
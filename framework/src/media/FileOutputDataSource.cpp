@@ -19,9 +19,12 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <debug.h>
 #include <media/FileOutputDataSource.h>
 #include <media/MediaUtils.h>
+#include "MediaRecorderImpl.h"
 
 #ifndef CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE 4096
@@ -31,21 +34,42 @@
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD 2048
 #endif
 
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+#ifndef CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE
+#define CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE 4096
+#endif
+
+#ifndef CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT
+#define CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT 3
+#endif
+
+#ifndef CONFIG_FILE_OUTPUT_DATASOURCE_SYNC_SIZE
+#define CONFIG_FILE_OUTPUT_DATASOURCE_SYNC_SIZE 65536
+#endif
+
+#ifndef CONFIG_FILE_OUTPUT_DATASOURCE_STACKSIZE
+#define CONFIG_FILE_OUTPUT_DATASOURCE_STACKSIZE 4096
+#endif
+#endif
+
 namespace media {
 namespace stream {
 
 FileOutputDataSource::FileOutputDataSource(const std::string& dataPath)
-	: OutputDataSource(), mDataPath(dataPath), mFp(nullptr)
+	: OutputDataSource(), mDataPath(dataPath), mFp(nullptr), mWriter((pthread_t)0), mPool(nullptr), mLengths(nullptr),
+	mFill(0), mFillLen(0), mFillLimit(0), mPending(0), mUnsynced(0), mWriterRunning(false), mWriterError(false)
 {
 }
 
 FileOutputDataSource::FileOutputDataSource(unsigned int channels, unsigned int sampleRate, audio_format_type_t pcmFormat, const std::string& dataPath)
-	: OutputDataSource(channels, sampleRate, pcmFormat), mDataPath(dataPath), mFp(nullptr)
+	: OutputDataSource(channels, sampleRate, pcmFormat), mDataPath(dataPath), mFp(nullptr), mWriter((pthread_t)0), mPool(nullptr), mLengths(nullptr),
+	mFill(0), mFillLen(0), mFillLimit(0), mPending(0), mUnsynced(0), mWriterRunning(false), mWriterError(false)
 {
 }
 
 FileOutputDataSource::FileOutputDataSource(const FileOutputDataSource& source) :
-	OutputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp)
+	OutputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp), mWriter((pthread_t)0), mPool(nullptr), mLengths(nullptr),
+	mFill(0), mFillLen(0), mFillLimit(0), mPending(0), mUnsynced(0), mWriterRunning(false), mWriterError(false)
 {
 }
 
@@ -63,6 +87,10 @@ bool FileOutputDataSource::open()
 			meddbg("file open failed error : %d\n", errno);
 			return false;
 		}
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+		/* The writer hands whole buffers to the file system, stdio buffering would only add a copy */
+		setvbuf(mFp, NULL, _IONBF, 0);
+#endif
 
 		setAudioType(utils::getAudioTypeFromPath(mDataPath));
 		switch (getAudioType()) {
@@ -81,6 +109,17 @@ bool FileOutputDataSource::open()
 			/* Don't set any encoder for unsupported formats */
 			break;
 		}
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+		if (!startWriter()) {
+			meddbg("start writer failed\n");
+			if (fclose(mFp) == OK) {
+				mFp = nullptr;
+			} else {
+				meddbg("file close failed error : %d\n", errno);
+			}
+			return false;
+		}
+#endif
 	} else {
 		medvdbg("file already exists\n");
 		/** return true if mFp is not null, because it means it using now */
@@ -90,6 +129,11 @@ bool FileOutputDataSource::open()
 
 bool FileOutputDataSource::close()
 {
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	/* Write out the queued data before the header is updated */
+	stopWriter();
+#endif
+
 	switch (getAudioType()) {
 	case AUDIO_TYPE_WAVE: {
 		fflush(mFp);
@@ -146,7 +190,182 @@ ssize_t FileOutputDataSource::write(unsigned char *buf, size_t size)
 		return EOF;
 	}
 
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t wlen = 0;
+	while (wlen < size) {
+		if (mWriterError) {
+			meddbg("writer failed, written : %u\n", wlen);
+			return wlen > 0 ? (ssize_t)wlen : EOF;
+		}
+
+		size_t len = mFillLimit - mFillLen;
+		if (len > size - wlen) {
+			len = size - wlen;
+		}
+		memcpy(mPool + mFill * CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE + mFillLen, buf + wlen, len);
+		mFillLen += len;
+		wlen += len;
+
+		if (mFillLen == mFillLimit) {
+			submitBuffer(lock);
+		}
+	}
+
+	return (ssize_t)wlen;
+#else
 	return fwrite(buf, sizeof(unsigned char), size, mFp);
+#endif
+}
+
+bool FileOutputDataSource::startWriter()
+{
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	mPool = new unsigned char[CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE * CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT];
+	mLengths = new size_t[CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT];
+	if (!mPool || !mLengths) {
+		meddbg("Out of memory\n");
+		delete[] mPool;
+		delete[] mLengths;
+		mPool = nullptr;
+		mLengths = nullptr;
+		return false;
+	}
+
+	/* Fill the first buffer up to a buffer boundary of the file, so that the following
+	 * writes stay aligned to the flash pages whatever header was written before.
+	 */
+	long offset = ftell(mFp);
+	if (offset < 0) {
+		offset = 0;
+	}
+	mFill = 0;
+	mFillLen = 0;
+	mFillLimit = CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE - ((size_t)offset % CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE);
+	mPending = 0;
+	mUnsynced = 0;
+	mWriterError = false;
+	mWriterRunning = true;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_FILE_OUTPUT_DATASOURCE_STACKSIZE);
+	int ret = pthread_create(&mWriter, &attr, static_cast<pthread_startroutine_t>(FileOutputDataSource::writerMain), this);
+	if (ret != OK) {
+		meddbg("Fail to create writer thread, return value : %d\n", ret);
+		mWriterRunning = false;
+		mWriter = (pthread_t)0;
+		delete[] mPool;
+		delete[] mLengths;
+		mPool = nullptr;
+		mLengths = nullptr;
+		return false;
+	}
+	pthread_setname_np(mWriter, "FileOutputWriter");
+#endif
+	return true;
+}
+
+void FileOutputDataSource::stopWriter()
+{
+	if (mWriter == (pthread_t)0) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mFillLen > 0) {
+			submitBuffer(lock, true);
+		}
+		mWriterRunning = false;
+		mCondv.notify_all();
+	}
+
+	pthread_join(mWriter, NULL);
+	mWriter = (pthread_t)0;
+
+	delete[] mPool;
+	delete[] mLengths;
+	mPool = nullptr;
+	mLengths = nullptr;
+}
+
+void FileOutputDataSource::submitBuffer(std::unique_lock<std::mutex> &lock, bool closing)
+{
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	mLengths[mFill] = mFillLen;
+	mPending++;
+	mFill = (mFill + 1) % CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT;
+	mFillLen = 0;
+	mFillLimit = CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE;
+	mCondv.notify_all();
+
+	/* On close the writer is joined right after and drains every buffer, the recording
+	 * is not held up then.
+	 */
+	if (closing || mPending < CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT) {
+		return;
+	}
+
+	/* Every buffer is waiting for the file system, let the recorder know it is being held up */
+	lock.unlock();
+	auto recorder = getRecorder();
+	if (recorder) {
+		recorder->notifyObserver(RECORDER_OBSERVER_COMMAND_BUFFER_OVERRUN);
+	}
+	lock.lock();
+
+	mCondv.wait(lock, [this]() {
+		return mPending < CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT || mWriterError;
+	});
+#endif
+}
+
+void *FileOutputDataSource::writerMain(void *arg)
+{
+#ifdef CONFIG_FILE_OUTPUT_DATASOURCE_ASYNC
+	auto source = static_cast<FileOutputDataSource *>(arg);
+	std::unique_lock<std::mutex> lock(source->mMutex);
+
+	while (true) {
+		source->mCondv.wait(lock, [source]() {
+			return source->mPending > 0 || !source->mWriterRunning;
+		});
+		if (source->mPending == 0) {
+			/* Stopped, and nothing is left to write */
+			break;
+		}
+
+		int index = (source->mFill + CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT - source->mPending) % CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_COUNT;
+		size_t len = source->mLengths[index];
+		lock.unlock();
+
+		bool ok = !source->mWriterError;
+		if (ok && fwrite(source->mPool + index * CONFIG_FILE_OUTPUT_DATASOURCE_BUFFER_SIZE, sizeof(unsigned char), len, source->mFp) != len) {
+			meddbg("write failed, len : %u error : %d\n", len, errno);
+			ok = false;
+		}
+#if CONFIG_FILE_OUTPUT_DATASOURCE_SYNC_SIZE > 0
+		/* Batch the syncs, committing the file system metadata per buffer costs more than the data */
+		source->mUnsynced += len;
+		if (ok && source->mUnsynced >= CONFIG_FILE_OUTPUT_DATASOURCE_SYNC_SIZE) {
+			if (fsync(fileno(source->mFp)) != OK) {
+				meddbg("fsync failed, error : %d\n", errno);
+				ok = false;
+			}
+			source->mUnsynced = 0;
+		}
+#endif
+
+		lock.lock();
+		if (!ok) {
+			source->mWriterError = true;
+		}
+		source->mPending--;
+		source->mCondv.notify_all();
+	}
+#endif
+	return NULL;
 }
 
 FileOutputDataSource::~FileOutputDataSource()
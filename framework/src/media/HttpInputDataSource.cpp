@@ -50,18 +50,22 @@ namespace stream {
 
 // Content-Type tag
 static const std::string TAG_CONTENT_TYPE = "Content-Type:";
+// Status line tag
+static const std::string TAG_STATUS_LINE = "HTTP/";
+// Status code of a range response
+static const long HTTP_PARTIAL_CONTENT = 206;
 
 static const std::chrono::seconds WAIT_HEADER_TIMEOUT = std::chrono::seconds(3);
 static const std::chrono::seconds WAIT_DATA_TIMEOUT = std::chrono::seconds(3);
 
 HttpInputDataSource::HttpInputDataSource(const std::string &url)
-	: InputDataSource(), mUrl(url), mThread((pthread_t)0), mIsHeaderReceived(false), mIsDataReceived(false)
+	: InputDataSource(), mUrl(url), mOffset(0), mStatusCode(0), mThread((pthread_t)0), mIsHeaderReceived(false), mIsDataReceived(false)
 {
 	medvdbg("url: %s\n", mUrl.c_str());
 }
 
 HttpInputDataSource::HttpInputDataSource(const HttpInputDataSource &source)
-	: InputDataSource(source), mUrl(source.mUrl), mThread((pthread_t)0), mIsHeaderReceived(source.mIsHeaderReceived), mIsDataReceived(source.mIsDataReceived)
+	: InputDataSource(source), mUrl(source.mUrl), mOffset(source.mOffset), mStatusCode(0), mThread((pthread_t)0), mIsHeaderReceived(source.mIsHeaderReceived), mIsDataReceived(source.mIsDataReceived)
 {
 }
 
@@ -108,19 +112,9 @@ bool HttpInputDataSource::open()
 	mIsHeaderReceived = false;
 	mIsDataReceived = false;
 
-	pthread_attr_t attr;
-	pthread_attr_init(&attr);
-	pthread_attr_setstacksize(&attr, CONFIG_HTTPSOURCE_DOWNLOAD_STACKSIZE);
-	struct sched_param sparam;
-	sparam.sched_priority = 100;
-	pthread_attr_setschedparam(&attr, &sparam);
-
-	int iRet = pthread_create(&mThread, &attr, static_cast<pthread_startroutine_t>(workerMain), this);
-	if (iRet != OK) {
-		meddbg("Fail to create download thread, err:%d\n", iRet);
+	if (!startDownload()) {
 		return false;
 	}
-	pthread_setname_np(mThread, "HttpSourceDownloader");
 
 	// wait for Content-Type header
 	if (!mCondv.wait_for(lock, WAIT_HEADER_TIMEOUT, [=]{ return mIsHeaderReceived; })) {
@@ -129,6 +123,12 @@ bool HttpInputDataSource::open()
 		return false;
 	}
 
+	if (mOffset > 0 && mStatusCode != HTTP_PARTIAL_CONTENT) {
+		meddbg("download:: range is not supported, status %ld\n", mStatusCode);
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+
 	auto audioType = utils::getAudioTypeFromMimeType(mContentType);
 
 	switch (audioType) {
@@ -182,14 +182,7 @@ bool HttpInputDataSource::open()
 bool HttpInputDataSource::close()
 {
 	medvdbg("HttpInputDataSource::close enter\n");
-	if (mBufferWriter) {
-		mBufferWriter->setEndOfStream();
-	}
-
-	if (mThread != (pthread_t)0) {
-		pthread_join(mThread, NULL);
-		mThread = (pthread_t)0;
-	}
+	stopDownload();
 
 	mHttpStream = nullptr;
 	mStreamBuffer = nullptr;
@@ -200,6 +193,81 @@ bool HttpInputDataSource::close()
 	return true;
 }
 
+bool HttpInputDataSource::seek(off_t offset)
+{
+	medvdbg("HttpInputDataSource::seek offset %ld\n", (long)offset);
+
+	if (!isPrepared()) {
+		// Applied by open()
+		mOffset = offset;
+		return true;
+	}
+
+	// Stop the current download, then drop the data it left
+	stopDownload();
+	{
+		std::lock_guard<std::mutex> lock(mStreamBuffer->getMutex());
+		mStreamBuffer->reset();
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mOffset = offset;
+	mStatusCode = 0;
+	mIsHeaderReceived = false;
+	mIsDataReceived = false;
+
+	if (!startDownload()) {
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+
+	if (!mCondv.wait_for(lock, WAIT_HEADER_TIMEOUT, [=]{ return mIsHeaderReceived; })) {
+		meddbg("seek:: wait header timeout!\n");
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+
+	// The whole resource is sent again if the server ignores the range
+	if (offset > 0 && mStatusCode != HTTP_PARTIAL_CONTENT) {
+		meddbg("seek:: range is not supported, status %ld\n", mStatusCode);
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+
+	return true;
+}
+
+bool HttpInputDataSource::startDownload()
+{
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_HTTPSOURCE_DOWNLOAD_STACKSIZE);
+	struct sched_param sparam;
+	sparam.sched_priority = 100;
+	pthread_attr_setschedparam(&attr, &sparam);
+
+	int iRet = pthread_create(&mThread, &attr, static_cast<pthread_startroutine_t>(workerMain), this);
+	if (iRet != OK) {
+		meddbg("Fail to create download thread, err:%d\n", iRet);
+		mThread = (pthread_t)0;
+		return false;
+	}
+	pthread_setname_np(mThread, "HttpSourceDownloader");
+	return true;
+}
+
+void HttpInputDataSource::stopDownload()
+{
+	if (mBufferWriter) {
+		mBufferWriter->setEndOfStream();
+	}
+
+	if (mThread != (pthread_t)0) {
+		pthread_join(mThread, NULL);
+		mThread = (pthread_t)0;
+	}
+}
+
 bool HttpInputDataSource::isPrepared()
 {
 	return ((mStreamBuffer != nullptr) && (mHttpStream != nullptr) && (getAudioType() != AUDIO_TYPE_UNKNOWN));
@@ -257,6 +325,15 @@ size_t HttpInputDataSource::HeaderCallback(char *data, size_t size, size_t nmemb
 	size_t totalsize = size * nmemb;
 	std::string header(data, totalsize);
 	medvdbg("%s\n", header.c_str());
+	if (header.compare(0, TAG_STATUS_LINE.length(), TAG_STATUS_LINE) == 0) {
+		// e.g. "HTTP/1.1 206 Partial Content"
+		auto code = header.find(' ');
+		if (code != std::string::npos) {
+			source->mStatusCode = strtol(header.c_str() + code + 1, NULL, 10);
+		}
+		return totalsize;
+	}
+
 	auto pos = header.find(TAG_CONTENT_TYPE);
 	if (pos != std::string::npos) {
 		pos = header.find_first_not_of(' ', pos + TAG_CONTENT_TYPE.length());
@@ -287,7 +364,7 @@ void *HttpInputDataSource::workerMain(void *arg)
 	//mHttpStream->addHeader("Icy-MetaData:1"); // not support now
 	source->mHttpStream->setHeaderCallback(HeaderCallback, arg);
 	source->mHttpStream->setWriteCallback(WriteCallback, arg);
-	if (!source->mHttpStream->download(source->mUrl)) {
+	if (!source->mHttpStream->download(source->mUrl, source->mOffset)) {
 		medwdbg("download failed or terminated!\n");
 		// TODO: send network error code to upper layer later
 	}
@@ -0,0 +1,235 @@
+/* ****************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <debug.h>
+#include <media/HttpOutputDataSource.h>
+
+#include "HttpStream.h"
+#include "StreamBuffer.h"
+#include "StreamBufferReader.h"
+#include "StreamBufferWriter.h"
+
+#ifndef CONFIG_HTTP_OUTPUT_DATASOURCE_BUFFER_SIZE
+#define CONFIG_HTTP_OUTPUT_DATASOURCE_BUFFER_SIZE 4096
+#endif
+
+#ifndef CONFIG_HTTP_OUTPUT_DATASOURCE_STACKSIZE
+#define CONFIG_HTTP_OUTPUT_DATASOURCE_STACKSIZE 8192
+#endif
+
+namespace media {
+namespace stream {
+
+HttpOutputDataSource::HttpOutputDataSource(const std::string &url)
+	: OutputDataSource(), mUrl(url), mThread((pthread_t)0), mUploadResult(false)
+{
+	medvdbg("url: %s\n", mUrl.c_str());
+}
+
+HttpOutputDataSource::HttpOutputDataSource(unsigned int channels, unsigned int sampleRate, audio_format_type_t pcmFormat, const std::string &url)
+	: OutputDataSource(channels, sampleRate, pcmFormat), mUrl(url), mThread((pthread_t)0), mUploadResult(false)
+{
+	medvdbg("url: %s\n", mUrl.c_str());
+}
+
+HttpOutputDataSource::HttpOutputDataSource(const HttpOutputDataSource &source)
+	: OutputDataSource(source), mUrl(source.mUrl), mHeaders(source.mHeaders), mThread((pthread_t)0), mUploadResult(false)
+{
+}
+
+HttpOutputDataSource &HttpOutputDataSource::operator=(const HttpOutputDataSource &source)
+{
+	OutputDataSource::operator=(source);
+	return *this;
+}
+
+void HttpOutputDataSource::addHeader(const std::string &header)
+{
+	mHeaders.push_back(header);
+}
+
+bool HttpOutputDataSource::open()
+{
+	medvdbg("HttpOutputDataSource::open!\n");
+
+	if (isPrepared()) {
+		medvdbg("HttpOutputDataSource is already opened!\n");
+		return true;
+	}
+
+	mStreamBuffer = StreamBuffer::Builder()
+							.setBufferSize(CONFIG_HTTP_OUTPUT_DATASOURCE_BUFFER_SIZE)
+							.setThreshold(1)
+							.build();
+	if (mStreamBuffer == nullptr) {
+		meddbg("mStreamBuffer is nullptr!\n");
+		return false;
+	}
+
+	mBufferReader = std::make_shared<StreamBufferReader>(mStreamBuffer);
+	mBufferWriter = std::make_shared<StreamBufferWriter>(mStreamBuffer);
+
+	mHttpStream = HttpStream::create();
+	if (mHttpStream == nullptr) {
+		meddbg("mHttpStream is nullptr!\n");
+		close();
+		return false;
+	}
+
+	for (auto &header : mHeaders) {
+		if (!mHttpStream->addHeader(header)) {
+			close();
+			return false;
+		}
+	}
+
+	if (!mHttpStream->setReadCallback(ReadCallback, this)) {
+		close();
+		return false;
+	}
+
+	mUploadResult = false;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_HTTP_OUTPUT_DATASOURCE_STACKSIZE);
+	struct sched_param sparam;
+	sparam.sched_priority = 100;
+	pthread_attr_setschedparam(&attr, &sparam);
+
+	int iRet = pthread_create(&mThread, &attr, static_cast<pthread_startroutine_t>(workerMain), this);
+	if (iRet != OK) {
+		meddbg("Fail to create upload thread, err:%d\n", iRet);
+		mThread = (pthread_t)0;
+		close();
+		return false;
+	}
+	pthread_setname_np(mThread, "HttpSinkUploader");
+
+	medvdbg("HttpOutputDataSource::open! exit\n");
+	return true;
+}
+
+bool HttpOutputDataSource::close()
+{
+	medvdbg("HttpOutputDataSource::close enter\n");
+
+	// The uploader sends what is left in the buffer, then ends the upload
+	if (mBufferWriter) {
+		mBufferWriter->setEndOfStream();
+	}
+
+	bool ret = false;
+	if (mThread != (pthread_t)0) {
+		pthread_join(mThread, NULL);
+		mThread = (pthread_t)0;
+		ret = mUploadResult;
+	}
+
+	mHttpStream = nullptr;
+	mStreamBuffer = nullptr;
+	mBufferReader = nullptr;
+	mBufferWriter = nullptr;
+	medvdbg("HttpOutputDataSource::close exit!\n");
+	return ret;
+}
+
+bool HttpOutputDataSource::isPrepared()
+{
+	return ((mStreamBuffer != nullptr) && (mHttpStream != nullptr) && (mThread != (pthread_t)0));
+}
+
+ssize_t HttpOutputDataSource::write(unsigned char *buf, size_t size)
+{
+	if (size == 0) {
+		return 0;
+	}
+
+	if (!isPrepared()) {
+		return EOF;
+	}
+
+	if (buf == nullptr) {
+		return EOF;
+	}
+
+	// The upload is over, by an error or by the server
+	if (mBufferReader->isEndOfStream()) {
+		meddbg("upload is already finished\n");
+		return EOF;
+	}
+
+	size_t wlen = mBufferWriter->write(buf, size);
+	if (wlen < size) {
+		meddbg("upload is finished, written %u/%u\n", wlen, size);
+		return EOF;
+	}
+
+	return wlen;
+}
+
+size_t HttpOutputDataSource::ReadCallback(char *data, size_t size, size_t nmemb, void *userp)
+{
+	auto source = static_cast<HttpOutputDataSource *>(userp);
+	size_t totalsize = size * nmemb;
+	if (totalsize == 0) {
+		return 0;
+	}
+
+	// Wait until there is any data, so a chunk is sent as soon as it is recorded.
+	// Nothing read means end-of-stream, which ends the upload.
+	size_t rlen = source->mBufferReader->read((unsigned char *)data, 1);
+	if (rlen == 0) {
+		medvdbg("end-of-stream, upload done\n");
+		return 0;
+	}
+
+	rlen += source->mBufferReader->read((unsigned char *)data + 1, totalsize - 1, false);
+	return rlen;
+}
+
+void *HttpOutputDataSource::workerMain(void *arg)
+{
+	medvdbg("upload thread enter!\n");
+	auto source = static_cast<HttpOutputDataSource *>(arg);
+
+	bool ret = source->mHttpStream->uploadChunked(source->mUrl);
+	long code = source->mHttpStream->getResponseCode();
+	if (!ret || code / 100 != 2) {
+		meddbg("upload failed! response %ld\n", code);
+		ret = false;
+	}
+	source->mUploadResult = ret;
+
+	// Let write() fail from now on, instead of waiting for a reader
+	source->mBufferWriter->setEndOfStream();
+	medvdbg("upload thread exit!\n");
+	return NULL;
+}
+
+HttpOutputDataSource::~HttpOutputDataSource()
+{
+	if (isPrepared()) {
+		close();
+	}
+}
+
+} // namespace stream
+} // namespace media
@@ -36,6 +36,11 @@ namespace stream {
 
 int HttpStream::mInitializeCount = 0;
 
+#ifdef CONFIG_HTTPSTREAM_CONNECTION_REUSE
+CURLSH *HttpStream::mShare = nullptr;
+pthread_mutex_t HttpStream::mShareLock[CURL_LOCK_DATA_LAST];
+#endif
+
 std::shared_ptr<HttpStream> HttpStream::create()
 {
 	std::shared_ptr<HttpStream> stream(new HttpStream());
@@ -48,7 +53,7 @@ std::shared_ptr<HttpStream> HttpStream::create()
 }
 
 HttpStream::HttpStream() :
-	mCurl(nullptr), mHttpHeaders(nullptr), mInitializeFlag(false)
+	mCurl(nullptr), mHttpHeaders(nullptr), mResponseCode(0), mChunkedHeader(false), mInitializeFlag(false)
 {
 }
 
@@ -105,9 +110,59 @@ bool HttpStream::init()
 		return false;
 	}
 
+#ifdef CONFIG_HTTPSTREAM_CONNECTION_REUSE
+	if (!initShare()) {
+		return false;
+	}
+	SET_OPTION(mCurl, CURLOPT_SHARE, mShare);
+	// Keep idle connections in the cache alive between transfers
+	SET_OPTION(mCurl, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+
+	return true;
+}
+
+#ifdef CONFIG_HTTPSTREAM_CONNECTION_REUSE
+bool HttpStream::initShare()
+{
+	if (mShare != nullptr) {
+		return true;
+	}
+
+	mShare = curl_share_init();
+	if (mShare == nullptr) {
+		meddbg("curl_share_init failed\n");
+		return false;
+	}
+
+	for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+		pthread_mutex_init(&mShareLock[i], NULL);
+	}
+
+	curl_share_setopt(mShare, CURLSHOPT_LOCKFUNC, lockShare);
+	curl_share_setopt(mShare, CURLSHOPT_UNLOCKFUNC, unlockShare);
+	curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+	curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+	// The share lives as long as the program, so that a connection left by one
+	// HttpStream is still there for the next one. It holds a reference of the
+	// curl global initialization for that.
+	mInitializeCount++;
 	return true;
 }
 
+void HttpStream::lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+	pthread_mutex_lock(&mShareLock[data]);
+}
+
+void HttpStream::unlockShare(CURL *handle, curl_lock_data data, void *userptr)
+{
+	pthread_mutex_unlock(&mShareLock[data]);
+}
+#endif
+
 void HttpStream::cleanup()
 {
 	if (mHttpHeaders) {
@@ -141,22 +196,30 @@ bool HttpStream::perform()
 		return false;
 	}
 
-	long response_code = 0;
-	result = curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &response_code);
+	mResponseCode = 0;
+	result = curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &mResponseCode);
 	if (result != CURLE_OK) {
-		meddbg("Get response failed! result[%d] response[%ld]\n", result, response_code);
+		meddbg("Get response failed! result[%d] response[%ld]\n", result, mResponseCode);
 		return false;
 	}
 
 	return true;
 }
 
-bool HttpStream::download(const std::string &url)
+long HttpStream::getResponseCode()
+{
+	return mResponseCode;
+}
+
+bool HttpStream::download(const std::string &url, off_t offset)
 {
 	SET_OPTION(mCurl, CURLOPT_HTTPGET, 1L);
 
 	SET_OPTION(mCurl, CURLOPT_URL, url.c_str());
 
+	// "Range: bytes=offset-" is sent for non-zero offset
+	SET_OPTION(mCurl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset);
+
 	SET_OPTION(mCurl, CURLOPT_SSL_VERIFYPEER, 0L);
 
 	SET_OPTION(mCurl, CURLOPT_SSL_VERIFYHOST, 0L);
@@ -183,5 +246,33 @@ bool HttpStream::upload(const std::string &url)
 	return true;
 }
 
+bool HttpStream::uploadChunked(const std::string &url)
+{
+	if (!mChunkedHeader) {
+		// Without "Expect:", curl waits for "100 Continue" before sending the body
+		if (!addHeader("Transfer-Encoding: chunked") || !addHeader("Expect:")) {
+			return false;
+		}
+		mChunkedHeader = true;
+	}
+
+	SET_OPTION(mCurl, CURLOPT_UPLOAD, 0L);
+
+	SET_OPTION(mCurl, CURLOPT_POST, 1L);
+
+	SET_OPTION(mCurl, CURLOPT_URL, url.c_str());
+
+	SET_OPTION(mCurl, CURLOPT_SSL_VERIFYPEER, 0L);
+
+	SET_OPTION(mCurl, CURLOPT_SSL_VERIFYHOST, 0L);
+
+	if (!perform()) {
+		meddbg("chunked upload failed!\n");
+		return false;
+	}
+
+	return true;
+}
+
 } // namespace stream
 } // namespace media
@@ -21,6 +21,8 @@
 
 #include <chrono>
 #include <string>
+#include <sys/types.h>
+#include <pthread.h>
 #include <curl/curl.h>
 #include <debug.h>
 
@@ -66,15 +68,28 @@ public:
 	bool setReadCallback(CallbackFunc callback, void *userdata);
 
 	/*
-	 * Sets the callback for uploading local data
+	 * Downloads the resource, starting from the given byte offset.
+	 * A non-zero offset is sent as a range request.
 	 */
-	bool download(const std::string &url);
+	bool download(const std::string &url, off_t offset = 0);
 
 	/*
-	 * Sets the callback for uploading local data
+	 * Uploads the data given by the read callback
 	 */
 	bool upload(const std::string &url);
 
+	/*
+	 * Posts the data given by the read callback with chunked transfer encoding,
+	 * the length does not have to be known in advance.
+	 * The upload ends when the read callback returns 0.
+	 */
+	bool uploadChunked(const std::string &url);
+
+	/*
+	 * Gets the response code of the last transfer
+	 */
+	long getResponseCode();
+
 private:
 	HttpStream();
 	bool init();
@@ -85,9 +100,23 @@ private:
 	CURL *mCurl;
 	// http level headers
 	curl_slist *mHttpHeaders;
+	// response code of the last transfer
+	long mResponseCode;
+	// chunked upload headers are added
+	bool mChunkedHeader;
 
 	bool mInitializeFlag;
 	static int mInitializeCount;
+
+#ifdef CONFIG_HTTPSTREAM_CONNECTION_REUSE
+	static bool initShare();
+	static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+	static void unlockShare(CURL *handle, curl_lock_data data, void *userptr);
+
+	// connections, dns and ssl sessions shared by every HttpStream
+	static CURLSH *mShare;
+	static pthread_mutex_t mShareLock[CURL_LOCK_DATA_LAST];
+#endif
 };
 
 } // namespace stream
@@ -80,11 +80,11 @@ bool InputHandler::open()
 		return false;
 	}
 
-	// Wait buffering done
+	// Wait buffering done, or the worker stopped by close()
 	std::unique_lock<std::mutex> lock(mMutex);
 	if (mState < BUFFER_STATE_BUFFERED) {
 		medvdbg("PCM buffering...\n");
-		mCondv.wait(lock);
+		mCondv.wait(lock, [this] { return mState >= BUFFER_STATE_BUFFERED || !mIsWorkerAlive; });
 		medvdbg("PCM buffering done!\n");
 	}
 
@@ -111,6 +111,17 @@ ssize_t InputHandler::read(unsigned char *buf, size_t size)
 	return (ssize_t)rlen;
 }
 
+void InputHandler::setPlayer(std::shared_ptr<MediaPlayerImpl> mp)
+{
+#ifdef CONFIG_MEDIA_STATISTICS
+	if (mp) {
+		// Data buffered before the player is attached (e.g. next track) is not traced
+		mp->getMediaStatistics().restartFlow(mBufferReader ? mBufferReader->sizeOfData() : 0);
+	}
+#endif
+	mPlayer = mp;
+}
+
 void InputHandler::resetWorker()
 {
 	mState = BUFFER_STATE_EMPTY;
@@ -127,6 +138,10 @@ bool InputHandler::processWorker()
 			return false;
 		}
 
+#ifdef CONFIG_MEDIA_STATISTICS
+		auto mp = getPlayer();
+		uint64_t start = MediaStatistics::now();
+#endif
 		ssize_t readLen = readFromSource(buf, size);
 		if (readLen <= 0) {
 			// Error occurred, or inputting finished
@@ -134,6 +149,11 @@ bool InputHandler::processWorker()
 			delete[] buf;
 			return false;
 		}
+#ifdef CONFIG_MEDIA_STATISTICS
+		if (mp) {
+			mp->getMediaStatistics().addInput((size_t)readLen, start);
+		}
+#endif
 
 		ssize_t writeLen = writeToStreamBuffer(buf, (size_t)readLen);
 		delete[] buf;
@@ -142,6 +162,12 @@ bool InputHandler::processWorker()
 			mBufferWriter->setEndOfStream();
 			return false;
 		}
+#ifdef CONFIG_MEDIA_STATISTICS
+		if (mp) {
+			// The pcm of this read is in the buffer now, trace it to the output
+			mp->getMediaStatistics().markInput(start);
+		}
+#endif
 	}
 
 	return true;
@@ -186,12 +212,22 @@ void InputHandler::onBufferUnderrun()
 {
 	auto mp = getPlayer();
 	if (mp) {
+#ifdef CONFIG_MEDIA_STATISTICS
+		mp->getMediaStatistics().addUnderrun();
+#endif
 		mp->notifyObserver(PLAYER_OBSERVER_COMMAND_BUFFER_UNDERRUN);
 	}
 }
 
 void InputHandler::onBufferUpdated(ssize_t change, size_t current)
 {
+#ifdef CONFIG_MEDIA_STATISTICS
+	auto statsPlayer = getPlayer();
+	if (statsPlayer) {
+		statsPlayer->getMediaStatistics().updateBuffer(change, current, mStreamBuffer->getBufferSize());
+	}
+#endif
+
 	if (change < 0) {
 		// Reading wake worker up
 		wakenWorker();
@@ -366,7 +402,22 @@ size_t InputHandler::getDecodeFrames(unsigned char *buf, size_t *size)
 	unsigned int sampleRate = 0;
 	unsigned short channels = 0;
 
-	if (mDecoder->getFrame(buf, size, &sampleRate, &channels)) {
+#ifdef CONFIG_MEDIA_STATISTICS
+	uint64_t start = MediaStatistics::now();
+#endif
+	bool ret = mDecoder->getFrame(buf, size, &sampleRate, &channels);
+#ifdef CONFIG_MEDIA_STATISTICS
+	auto mp = getPlayer();
+	if (mp) {
+		unsigned int resyncs;
+		unsigned int resyncTime;
+		mDecoder->takeResyncStatistics(&resyncs, &resyncTime);
+		mp->getMediaStatistics().addDecode(ret, start);
+		mp->getMediaStatistics().addResync(resyncs, resyncTime);
+	}
+#endif
+
+	if (ret) {
 		medvdbg("size : %u samplerate : %d channels : %d\n", *size, sampleRate, channels);
 		return *size;
 	}
@@ -378,6 +429,9 @@ ssize_t InputHandler::getElementaryStream(unsigned char *buf, size_t size, size_
 {
 	if (mDemuxer) {
 		ssize_t ret;
+#ifdef CONFIG_MEDIA_STATISTICS
+		uint64_t start = MediaStatistics::now();
+#endif
 		if (*used < size) {
 			ret = mDemuxer->pushData(buf + *used, size - *used);
 			if (ret <= 0) {
@@ -388,13 +442,17 @@ ssize_t InputHandler::getElementaryStream(unsigned char *buf, size_t size, size_
 		}
 
 		if (*out == nullptr) {
-			*out = buf;
-			if (*expect > *used) {
-				*expect = *used;
-			}
+			// Point to ES data kept by demuxer, it's valid until the next pulling
+			ret = mDemuxer->pullDataRef(out, *expect);
+		} else {
+			ret = mDemuxer->pullData(*out, *expect);
 		}
-
-		ret = mDemuxer->pullData(*out, *expect);
+#ifdef CONFIG_MEDIA_STATISTICS
+		auto mp = getPlayer();
+		if (mp) {
+			mp->getMediaStatistics().addDemux(ret > 0 ? (size_t)ret : 0, start);
+		}
+#endif
 		if (ret < 0) {
 			if (ret == DEMUXER_ERROR_WANT_DATA) {
 				// normal case: demuxer want more data
@@ -56,7 +56,7 @@ public:
 	virtual void onBufferUnderrun() override;
 	virtual void onBufferUpdated(ssize_t change, size_t current) override;
 
-	void setPlayer(std::shared_ptr<MediaPlayerImpl> mp) { mPlayer = mp; }
+	void setPlayer(std::shared_ptr<MediaPlayerImpl> mp);
 	std::shared_ptr<MediaPlayerImpl> getPlayer() { return mPlayer.lock(); }
 
 	size_t getAvailSpace();
@@ -23,6 +23,9 @@
 #include <debug.h>
 #include <errno.h>
 #include "audio/audio_manager.h"
+#ifdef CONFIG_AUDIO_MIXER
+#include "audio/audio_mixer.h"
+#endif
 
 namespace media {
 
@@ -35,6 +38,14 @@ MediaPlayerImpl::MediaPlayerImpl(MediaPlayer &player) : mPlayer(player)
 	mCurState = PLAYER_STATE_NONE;
 	mBuffer = nullptr;
 	mBufSize = 0;
+#ifdef CONFIG_AUDIO_MIXER
+	mMixerStream = -1;
+	mBufOffset = 0;
+	mBufLen = 0;
+#endif
+	mInputHandler = std::make_shared<stream::InputHandler>();
+	mNextPrepared = false;
+	mNextDone = false;
 }
 
 player_result_t MediaPlayerImpl::create()
@@ -146,37 +157,15 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 		return notifySync();
 	}
 
-	if (!mInputHandler.open()) {
+	if (!mInputHandler->open()) {
 		meddbg("MediaPlayer prepare fail : open fail\n");
 		ret = PLAYER_ERROR_FILE_OPEN_FAILED;
 		return notifySync();
 	}
 
-	auto source = mInputHandler.getDataSource();
-	if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-							 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-		meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
-		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
-		return notifySync();
-	}
-
-	mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
-	if (mBufSize < 0) {
-		meddbg("MediaPlayer prepare fail : get_output_frames_byte_size fail\n");
-		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
-		return notifySync();
-	}
-
-	medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
-
-	mBuffer = new unsigned char[mBufSize];
-	if (!mBuffer) {
-		meddbg("MediaPlayer prepare fail : mBuffer allocation fail\n");
-		if (get_errno() == ENOMEM) {
-			ret = PLAYER_ERROR_OUT_OF_MEMORY;
-		} else {
-			ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
-		}
+	ret = setupAudioOutput();
+	if (ret != PLAYER_OK) {
+		meddbg("MediaPlayer prepare fail : setupAudioOutput fail\n");
 		return notifySync();
 	}
 
@@ -213,7 +202,7 @@ void MediaPlayerImpl::prepareAsyncPlayer()
 
 	mCurState = PLAYER_STATE_PREPARING;
 
-	if (!mInputHandler.doStandBy()) {
+	if (!mInputHandler->doStandBy()) {
 		meddbg("MediaPlayer prepare fail : doStandBy fail\n");
 		notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		return;
@@ -250,19 +239,34 @@ void MediaPlayerImpl::unpreparePlayer(player_result_t &ret)
 		return notifySync();
 	}
 
+	cancelNextSource();
+
 	if (mBuffer) {
 		delete[] mBuffer;
 		mBuffer = nullptr;
 	}
 	mBufSize = 0;
 
+#ifdef CONFIG_AUDIO_MIXER
+	mBufOffset = 0;
+	mBufLen = 0;
+	PlayerWorker::getWorker().removePlayer(shared_from_this());
+	audio_manager_result_t result = audio_mixer_close_stream(mMixerStream);
+	mMixerStream = -1;
+	if (result != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer unprepare fail : audio_mixer_close_stream fail\n");
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+#else
 	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
 		meddbg("MediaPlayer unprepare fail : reset_audio_stream_out fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 		return notifySync();
 	}
+#endif
 
-	mInputHandler.close();
+	mInputHandler->close();
 
 	mCurState = PLAYER_STATE_IDLE;
 	return notifySync();
@@ -296,8 +300,17 @@ void MediaPlayerImpl::startPlayer()
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	/* Other players keep playing, the mixer shares the output among them */
+	if (audio_mixer_pause_stream(mMixerStream, false) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer startPlayer fail : audio_mixer_pause_stream fail\n");
+		notifyObserver(PLAYER_OBSERVER_COMMAND_START_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		return;
+	}
+	mpw.addPlayer(shared_from_this());
+#else
 	if (mCurState == PLAYER_STATE_PAUSED) {
-		auto source = mInputHandler.getDataSource();
+		auto source = mInputHandler->getDataSource();
 		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
 								 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
 			meddbg("MediaPlayer startPlayer fail : set_audio_stream_out fail\n");
@@ -315,6 +328,7 @@ void MediaPlayerImpl::startPlayer()
 		}
 		mpw.setPlayer(curPlayer);
 	}
+#endif
 
 	mCurState = PLAYER_STATE_PLAYING;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_STARTED);
@@ -357,10 +371,25 @@ player_result_t MediaPlayerImpl::stopPlayback()
 		return PLAYER_ERROR_INVALID_STATE;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+	mBufOffset = 0;
+	mBufLen = 0;
+
+	/* Frames queued while playing are left to play out, like the drain below */
+	audio_manager_result_t result;
+	if (mCurState == PLAYER_STATE_PAUSED) {
+		result = audio_mixer_flush_stream(mMixerStream);
+	} else {
+		result = audio_mixer_drain_stream(mMixerStream);
+	}
+	mCurState = PLAYER_STATE_READY;
+#else
 	mCurState = PLAYER_STATE_READY;
 	mpw.setPlayer(nullptr);
 
 	audio_manager_result_t result = stop_audio_stream_out();
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("stop_audio_stream_out failed ret : %d\n", result);
 		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
@@ -397,18 +426,26 @@ void MediaPlayerImpl::pausePlayer()
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	audio_manager_result_t result = audio_mixer_pause_stream(mMixerStream, true);
+#else
 	audio_manager_result_t result = pause_audio_stream_out();
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("pause_audio_stream_in failed ret : %d\n", result);
 		notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSE_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer == curPlayer) {
 		mpw.setPlayer(nullptr);
 	}
+#endif
 	mCurState = PLAYER_STATE_PAUSED;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSED);
 }
@@ -558,13 +595,191 @@ void MediaPlayerImpl::setPlayerDataSource(std::shared_ptr<stream::InputDataSourc
 		return notifySync();
 	}
 
-	mInputHandler.setPlayer(shared_from_this());
-	mInputHandler.setInputDataSource(source);
+#ifdef CONFIG_MEDIA_STATISTICS
+	mStatistics.reset();
+#endif
+	mInputHandler->setPlayer(shared_from_this());
+	mInputHandler->setInputDataSource(source);
 	mCurState = PLAYER_STATE_CONFIGURED;
 
 	return notifySync();
 }
 
+player_result_t MediaPlayerImpl::setNextDataSource(std::unique_ptr<stream::InputDataSource> source)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer setNextDataSource\n");
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	std::shared_ptr<stream::InputDataSource> sharedDataSource = std::move(source);
+	mpw.enQueue(&MediaPlayerImpl::setPlayerNextDataSource, shared_from_this(), sharedDataSource, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::setPlayerNextDataSource(std::shared_ptr<stream::InputDataSource> source, player_result_t &ret)
+{
+	LOG_STATE_INFO(mCurState);
+
+	if (mCurState != PLAYER_STATE_READY && mCurState != PLAYER_STATE_PLAYING && mCurState != PLAYER_STATE_PAUSED) {
+		meddbg("%s Fail : invalid state\n", __func__);
+		LOG_STATE_DEBUG(mCurState);
+		ret = PLAYER_ERROR_INVALID_STATE;
+		return notifySync();
+	}
+
+	/* A pending source is replaced, or just dropped when source is nullptr */
+	cancelNextSource();
+	if (!source) {
+		return notifySync();
+	}
+
+	/* Open and buffer the next source apart from the worker, which keeps playing the current one.
+	 * The player is attached to the handler only once it becomes the current one, so buffer
+	 * events of the next source are not reported as the ones of the current source.
+	 */
+	auto next = std::make_shared<stream::InputHandler>();
+	next->setInputDataSource(source);
+	mNextInputHandler = next;
+	mNextPrepared = false;
+	mNextDone = false;
+	mNextWorker = std::thread([this, next]() {
+		medvdbg("MediaPlayer next source prefetch enter\n");
+		mNextPrepared = next->open();
+		medvdbg("MediaPlayer next source prefetch exit, prepared : %d\n", mNextPrepared);
+		mNextDone = true;
+	});
+
+	return notifySync();
+}
+
+player_result_t MediaPlayerImpl::setupAudioOutput()
+{
+	auto source = mInputHandler->getDataSource();
+	int bufSize;
+
+#ifdef CONFIG_AUDIO_MIXER
+	int stream;
+	if (audio_mixer_open_stream(source->getChannels(), source->getSampleRate(),
+								source->getPcmFormat(), &stream) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer setupAudioOutput fail : audio_mixer_open_stream fail\n");
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	/* The previous stream is closed only now, so the mixer keeps running across tracks,
+	 * and only once the end of the previous track queued to it has been played out.
+	 */
+	if (mMixerStream >= 0) {
+		audio_mixer_close_stream_drained(mMixerStream);
+	}
+	mMixerStream = stream;
+
+	bufSize = audio_mixer_frames_to_byte(mMixerStream, audio_mixer_get_frame_count());
+#else
+	if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
+							 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer setupAudioOutput fail : set_audio_stream_out fail\n");
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	bufSize = get_user_output_frames_to_byte(get_output_frame_count());
+#endif
+	if (bufSize < 0) {
+		meddbg("MediaPlayer setupAudioOutput fail : get_output_frames_byte_size fail\n");
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	medvdbg("MediaPlayer mBuffer size : %d\n", bufSize);
+
+	if (mBuffer && bufSize == mBufSize) {
+		return PLAYER_OK;
+	}
+
+	delete[] mBuffer;
+	mBufSize = bufSize;
+	mBuffer = new unsigned char[mBufSize];
+	if (!mBuffer) {
+		meddbg("MediaPlayer setupAudioOutput fail : mBuffer allocation fail\n");
+		if (get_errno() == ENOMEM) {
+			return PLAYER_ERROR_OUT_OF_MEMORY;
+		}
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+
+	return PLAYER_OK;
+}
+
+player_result_t MediaPlayerImpl::switchToNextSource()
+{
+	/* Called once the prefetch is done, so this does not wait */
+	if (mNextWorker.joinable()) {
+		mNextWorker.join();
+	}
+
+	auto next = mNextInputHandler;
+	mNextInputHandler = nullptr;
+	if (!mNextPrepared) {
+		meddbg("MediaPlayer switchToNextSource fail : next source open fail\n");
+		next->close();
+		return PLAYER_ERROR_FILE_OPEN_FAILED;
+	}
+
+	auto prev = mInputHandler->getDataSource();
+	auto source = next->getDataSource();
+	bool reconfigure = (prev->getChannels() != source->getChannels()) ||
+					   (prev->getSampleRate() != source->getSampleRate()) ||
+					   (prev->getPcmFormat() != source->getPcmFormat());
+
+	mInputHandler->close();
+	mInputHandler = next;
+	mInputHandler->setPlayer(shared_from_this());
+
+	if (!reconfigure) {
+		/* Same format, keep writing to the running output so that there is no gap between tracks */
+		return PLAYER_OK;
+	}
+
+	medvdbg("MediaPlayer next source has another format, reconfigure audio output\n");
+#ifndef CONFIG_AUDIO_MIXER
+	/* Play out the previous track before the output is reopened */
+	stop_audio_stream_out();
+	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer switchToNextSource fail : reset_audio_stream_out fail\n");
+		return PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+	}
+#endif
+
+	return setupAudioOutput();
+}
+
+void MediaPlayerImpl::cancelNextSource()
+{
+	/* Close first so that a prefetch still waiting on buffering wakes up and can be joined */
+	if (mNextInputHandler) {
+		mNextInputHandler->close();
+	}
+
+	if (mNextWorker.joinable()) {
+		mNextWorker.join();
+	}
+
+	if (mNextInputHandler) {
+		/* The prefetch may have opened the source after it was closed above */
+		if (mNextPrepared) {
+			mNextInputHandler->close();
+		}
+		mNextInputHandler = nullptr;
+	}
+}
+
 player_result_t MediaPlayerImpl::setObserver(std::shared_ptr<MediaPlayerObserverInterface> observer)
 {
 	std::unique_lock<std::mutex> lock(mCmdMtx);
@@ -620,6 +835,25 @@ bool MediaPlayerImpl::isPlaying()
 	return ret;
 }
 
+player_result_t MediaPlayerImpl::getStatistics(player_statistics_t *stats)
+{
+	medvdbg("MediaPlayer getStatistics\n");
+
+	if (stats == nullptr) {
+		meddbg("The given argument is invalid.\n");
+		return PLAYER_ERROR_INVALID_PARAMETER;
+	}
+
+#ifdef CONFIG_MEDIA_STATISTICS
+	/* The measurements are kept consistent by MediaStatistics, no need to go through the worker */
+	mStatistics.get(stats);
+	return PLAYER_OK;
+#else
+	meddbg("MediaPlayer getStatistics fail : CONFIG_MEDIA_STATISTICS is not enabled\n");
+	return PLAYER_ERROR_INVALID_OPERATION;
+#endif
+}
+
 player_state_t MediaPlayerImpl::getState()
 {
 	medvdbg("MediaPlayer getState\n");
@@ -646,6 +880,9 @@ void MediaPlayerImpl::notifyObserver(player_observer_command_t cmd, ...)
 		case PLAYER_OBSERVER_COMMAND_FINISHIED:
 			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackFinished, mPlayerObserver, mPlayer);
 			break;
+		case PLAYER_OBSERVER_COMMAND_TRACK_CHANGED:
+			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackTrackChanged, mPlayerObserver, mPlayer);
+			break;
 		case PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR:
 			pow.enQueue(&MediaPlayerObserverInterface::onPlaybackError, mPlayerObserver, mPlayer, (player_error_t)va_arg(ap, int));
 			break;
@@ -711,28 +948,10 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 	case PLAYER_EVENT_SOURCE_PREPARED: {
 		// Input handler has been opened successfully by InputHandler::doStandBy().
 		// Now setup audio manager and notify player observer the result.
-		auto source = mInputHandler.getDataSource();
-		if (set_audio_stream_out(source->getChannels(), source->getSampleRate(),
-								 source->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
-			meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
-			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-		}
-
-		mBufSize = get_user_output_frames_to_byte(get_output_frame_count());
-		if (mBufSize < 0) {
-			meddbg("MediaPlayer prepare fail : get_user_output_frames_to_byte fail\n");
-			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
-		}
-
-		medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
-
-		mBuffer = new unsigned char[mBufSize];
-		if (!mBuffer) {
-			meddbg("MediaPlayer prepare fail : mBuffer allocation fail\n");
-			if (get_errno() == ENOMEM) {
-				return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_OUT_OF_MEMORY);
-			}
-			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
+		player_result_t ret = setupAudioOutput();
+		if (ret != PLAYER_OK) {
+			meddbg("MediaPlayer prepare fail : setupAudioOutput fail\n");
+			return notifyObserver(PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED, ret);
 		}
 
 		mCurState = PLAYER_STATE_READY;
@@ -744,12 +963,50 @@ void MediaPlayerImpl::notifyAsync(player_event_t event)
 	}
 }
 
-void MediaPlayerImpl::playback()
+bool MediaPlayerImpl::playback()
 {
-	ssize_t num_read = mInputHandler.read(mBuffer, (int)mBufSize);
+	ssize_t num_read;
+	bool progress = true;
+
+#ifdef CONFIG_AUDIO_MIXER
+	/* The mixer never blocks the worker, what it did not take is written before reading more */
+	if (mBufLen > 0) {
+		num_read = (ssize_t)mBufLen;
+	} else {
+		num_read = mInputHandler->read(mBuffer, (int)mBufSize);
+		medvdbg("num_read : %d\n", num_read);
+		if (num_read > 0) {
+			mBufOffset = 0;
+			mBufLen = (unsigned int)num_read;
+		}
+	}
+	if (mBufLen > 0) {
+#else
+	num_read = mInputHandler->read(mBuffer, (int)mBufSize);
 	medvdbg("num_read : %d\n", num_read);
 	if (num_read > 0) {
+#endif
+#ifdef CONFIG_MEDIA_STATISTICS
+		uint64_t start = MediaStatistics::now();
+#endif
+#ifdef CONFIG_AUDIO_MIXER
+		int ret = audio_mixer_write(mMixerStream, mBuffer + mBufOffset, audio_mixer_bytes_to_frame(mMixerStream, mBufLen));
+		progress = (ret != 0);
+		if (ret > 0) {
+			unsigned int len = audio_mixer_frames_to_byte(mMixerStream, (unsigned int)ret);
+			mBufOffset += len;
+			mBufLen -= len;
+		}
+		if (ret < 0 || audio_mixer_bytes_to_frame(mMixerStream, mBufLen) == 0) {
+			/* Less than a frame is left, it is dropped as without the mixer */
+			mBufLen = 0;
+		}
+#else
 		int ret = start_audio_stream_out(mBuffer, get_user_output_bytes_to_frame((unsigned int)num_read));
+#endif
+#ifdef CONFIG_MEDIA_STATISTICS
+		mStatistics.addOutput(start);
+#endif
 		if (ret < 0) {
 			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 			PlayerWorker &mpw = PlayerWorker::getWorker();
@@ -765,6 +1022,19 @@ void MediaPlayerImpl::playback()
 			}
 		}
 	} else if (num_read == 0) {
+		if (mNextInputHandler) {
+			if (!mNextDone) {
+				/* The next track is still buffering, this worker serves the other players meanwhile */
+				return false;
+			}
+			player_result_t result = switchToNextSource();
+			if (result == PLAYER_OK) {
+				notifyObserver(PLAYER_OBSERVER_COMMAND_TRACK_CHANGED);
+				return true;
+			}
+			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, result);
+		}
+
 		player_result_t errcode = stopPlayback();
 		if (errcode != PLAYER_OK) {
 			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, errcode);
@@ -777,6 +1047,8 @@ void MediaPlayerImpl::playback()
 		PlayerWorker &mpw = PlayerWorker::getWorker();
 		mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INVALID_OPERATION);
 	}
+
+	return progress;
 }
 
 MediaPlayerImpl::~MediaPlayerImpl()
@@ -796,5 +1068,7 @@ MediaPlayerImpl::~MediaPlayerImpl()
 			meddbg("~MediaPlayer fail : destroy fail\n");
 		}
 	}
+
+	cancelNextSource();
 }
 } // namespace media
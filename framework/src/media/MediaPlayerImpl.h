@@ -19,6 +19,7 @@
 #ifndef __MEDIA_MEDIAPLAYERIMPL_H
 #define __MEDIA_MEDIAPLAYERIMPL_H
 
+#include <tinyara/config.h>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -29,6 +30,9 @@
 
 #include "PlayerObserverWorker.h"
 #include "InputHandler.h"
+#ifdef CONFIG_MEDIA_STATISTICS
+#include "MediaStatistics.h"
+#endif
 
 namespace media {
 /**
@@ -67,6 +71,7 @@ typedef enum player_observer_command_e {
 	PLAYER_OBSERVER_COMMAND_ASYNC_PREPARED,
 	PLAYER_OBSERVER_COMMAND_STARTED,
 	PLAYER_OBSERVER_COMMAND_FINISHIED,
+	PLAYER_OBSERVER_COMMAND_TRACK_CHANGED,
 	PLAYER_OBSERVER_COMMAND_START_ERROR,
 	PLAYER_OBSERVER_COMMAND_PAUSE_ERROR,
 	PLAYER_OBSERVER_COMMAND_STOP_ERROR,
@@ -105,15 +110,20 @@ public:
 	player_result_t setVolume(uint8_t vol);
 
 	player_result_t setDataSource(std::unique_ptr<stream::InputDataSource>);
+	player_result_t setNextDataSource(std::unique_ptr<stream::InputDataSource>);
 	player_result_t setObserver(std::shared_ptr<MediaPlayerObserverInterface>);
 
 	player_state_t getState();
 	bool isPlaying();
+	player_result_t getStatistics(player_statistics_t *stats);
+#ifdef CONFIG_MEDIA_STATISTICS
+	MediaStatistics &getMediaStatistics() { return mStatistics; }
+#endif
 
 	void notifySync();
 	void notifyObserver(player_observer_command_t cmd, ...);
 	void notifyAsync(player_event_t event);
-	void playback();
+	bool playback();
 
 private:
 	void createPlayer(player_result_t &ret);
@@ -130,17 +140,36 @@ private:
 	void setPlayerVolume(uint8_t vol, player_result_t &ret);
 	void setPlayerObserver(std::shared_ptr<MediaPlayerObserverInterface> observer);
 	void setPlayerDataSource(std::shared_ptr<stream::InputDataSource> dataSource, player_result_t &ret);
+	void setPlayerNextDataSource(std::shared_ptr<stream::InputDataSource> dataSource, player_result_t &ret);
+	player_result_t setupAudioOutput();
+	player_result_t switchToNextSource();
+	void cancelNextSource();
 
 private:
 	MediaPlayer &mPlayer;
 	std::atomic<player_state_t> mCurState;
 	unsigned char *mBuffer;
 	int mBufSize;
+#ifdef CONFIG_AUDIO_MIXER
+	int mMixerStream;
+	/* Bytes of mBuffer the mixer has not taken yet, written on the next playback() */
+	unsigned int mBufOffset;
+	unsigned int mBufLen;
+#endif
 	std::mutex mCmdMtx;
 	std::condition_variable mSyncCv;
 	std::shared_ptr<stream_info_t> mStreamInfo;
 	std::shared_ptr<MediaPlayerObserverInterface> mPlayerObserver;
-	stream::InputHandler mInputHandler;
+	std::shared_ptr<stream::InputHandler> mInputHandler;
+	/* Next track, opened and buffered by mNextWorker while the current one plays */
+	std::shared_ptr<stream::InputHandler> mNextInputHandler;
+	std::thread mNextWorker;
+	bool mNextPrepared;
+	/* Set by mNextWorker when the prefetch is over, the switch waits for it without blocking */
+	std::atomic<bool> mNextDone;
+#ifdef CONFIG_MEDIA_STATISTICS
+	MediaStatistics mStatistics;
+#endif
 };
 } // namespace media
 #endif
@@ -0,0 +1,266 @@
+/******************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <debug.h>
+
+#include "MediaStatistics.h"
+#include "audio/audio_manager.h"
+
+namespace media {
+
+/* Every MediaStatistics alive, for the procfs node */
+static std::mutex gListMutex;
+static MediaStatistics *gListHead = nullptr;
+static unsigned int gNextId = 0;
+
+static void updateTime(uint64_t &total, unsigned int &max, uint64_t elapsed)
+{
+	total += elapsed;
+	if (elapsed > max) {
+		max = (unsigned int)elapsed;
+	}
+}
+
+MediaStatistics::MediaStatistics() : mNext(nullptr)
+{
+	reset();
+
+	std::lock_guard<std::mutex> lock(gListMutex);
+	mId = gNextId++;
+	MediaStatistics **pp = &gListHead;
+	while (*pp) {
+		pp = &(*pp)->mNext;
+	}
+	*pp = this;
+}
+
+MediaStatistics::~MediaStatistics()
+{
+	std::lock_guard<std::mutex> lock(gListMutex);
+	MediaStatistics **pp = &gListHead;
+	while (*pp) {
+		if (*pp == this) {
+			*pp = mNext;
+			break;
+		}
+		pp = &(*pp)->mNext;
+	}
+}
+
+uint64_t MediaStatistics::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void MediaStatistics::reset()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	memset(&mStats, 0, sizeof(mStats));
+	mStats.bufferLevelMin = UINT_MAX;
+	mXrunBase = get_audio_stream_out_xrun_count();
+	mProduced = 0;
+	mConsumed = 0;
+	mLastMarkPos = 0;
+	mPendingStamp = 0;
+	mMarkHead = 0;
+	mMarkCount = 0;
+}
+
+void MediaStatistics::restartFlow(size_t level)
+{
+	// Another StreamBuffer is read from now on, which already holds level bytes of unmarked data
+	std::lock_guard<std::mutex> lock(mMutex);
+	mProduced = mConsumed + (uint32_t)level;
+	mLastMarkPos = mProduced;
+	mPendingStamp = 0;
+	mMarkHead = 0;
+	mMarkCount = 0;
+}
+
+void MediaStatistics::addInput(size_t bytes, uint64_t start)
+{
+	uint64_t elapsed = now() - start;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.inputBytes += (unsigned int)bytes;
+	updateTime(mStats.inputTime, mStats.inputTimeMax, elapsed);
+}
+
+void MediaStatistics::markInput(uint64_t start)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	// Data read earlier but not decoded into pcm yet is carried to the next mark
+	if (mPendingStamp == 0) {
+		mPendingStamp = start;
+	}
+
+	// Nothing decoded since the last mark, or no room for a mark: the next mark takes the stamp
+	if (mProduced == mLastMarkPos || mMarkCount == LATENCY_MARKS) {
+		return;
+	}
+
+	int tail = (mMarkHead + mMarkCount) % LATENCY_MARKS;
+	mMarks[tail].pos = mProduced;
+	mMarks[tail].stamp = mPendingStamp;
+	mMarkCount++;
+	mLastMarkPos = mProduced;
+	mPendingStamp = 0;
+}
+
+void MediaStatistics::addDemux(size_t bytes, uint64_t start)
+{
+	uint64_t elapsed = now() - start;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.demuxedBytes += (unsigned int)bytes;
+	updateTime(mStats.demuxTime, mStats.demuxTimeMax, elapsed);
+}
+
+void MediaStatistics::addDecode(bool frame, uint64_t start)
+{
+	uint64_t elapsed = now() - start;
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (frame) {
+		mStats.decodedFrames++;
+	}
+	updateTime(mStats.decodeTime, mStats.decodeTimeMax, elapsed);
+}
+
+void MediaStatistics::addResync(unsigned int count, unsigned int time)
+{
+	if (count == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.resyncs += count;
+	mStats.resyncTime += time;
+}
+
+void MediaStatistics::updateBuffer(ssize_t change, size_t level, size_t size)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.bufferSize = (unsigned int)size;
+	mStats.bufferLevel = (unsigned int)level;
+	if (change > 0) {
+		mProduced += (uint32_t)change;
+		if (level > mStats.bufferLevelMax) {
+			mStats.bufferLevelMax = (unsigned int)level;
+		}
+	} else if (change < 0) {
+		// The lowest level is the one left to the output after it reads
+		mConsumed += (uint32_t)(-change);
+		if (level < mStats.bufferLevelMin) {
+			mStats.bufferLevelMin = (unsigned int)level;
+		}
+	}
+}
+
+void MediaStatistics::addUnderrun()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.underruns++;
+}
+
+void MediaStatistics::addOutput(uint64_t start)
+{
+	uint64_t end = now();
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStats.outputWrites++;
+	updateTime(mStats.outputTime, mStats.outputTimeMax, end - start);
+
+	// Marks the output went past are done, the latest one gives the latency
+	bool done = false;
+	uint64_t stamp = 0;
+	while (mMarkCount > 0 && (int32_t)(mConsumed - mMarks[mMarkHead].pos) >= 0) {
+		stamp = mMarks[mMarkHead].stamp;
+		mMarkHead = (mMarkHead + 1) % LATENCY_MARKS;
+		mMarkCount--;
+		done = true;
+	}
+
+	if (done) {
+		mStats.latency = (unsigned int)(end - stamp);
+		if (mStats.latency > mStats.latencyMax) {
+			mStats.latencyMax = mStats.latency;
+		}
+	}
+}
+
+void MediaStatistics::get(player_statistics_t *stats)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	*stats = mStats;
+	if (stats->bufferLevelMin == UINT_MAX) {
+		stats->bufferLevelMin = 0;
+	}
+	stats->xruns = get_audio_stream_out_xrun_count() - mXrunBase;
+}
+
+int MediaStatistics::printOne(char *buf, size_t size)
+{
+	player_statistics_t st;
+	get(&st);
+	// Totals are printed in ms, printf may be built without long long support
+	return snprintf(buf, size,
+					"player %u\n"
+					"  input   %u bytes, %u ms (max %u us)\n"
+					"  demux   %u bytes, %u ms (max %u us)\n"
+					"  decode  %u frames, %u ms (max %u us), resyncs %u (%u ms)\n"
+					"  buffer  %u/%u (min %u, max %u), underruns %u\n"
+					"  output  %u writes, %u ms (max %u us), xruns %u (all outputs)\n"
+					"  latency %u us (max %u us)\n",
+					mId,
+					st.inputBytes, (unsigned int)(st.inputTime / 1000), st.inputTimeMax,
+					st.demuxedBytes, (unsigned int)(st.demuxTime / 1000), st.demuxTimeMax,
+					st.decodedFrames, (unsigned int)(st.decodeTime / 1000), st.decodeTimeMax, st.resyncs, (unsigned int)(st.resyncTime / 1000),
+					st.bufferLevel, st.bufferSize, st.bufferLevelMin, st.bufferLevelMax, st.underruns,
+					st.outputWrites, (unsigned int)(st.outputTime / 1000), st.outputTimeMax, st.xruns,
+					st.latency, st.latencyMax);
+}
+
+int MediaStatistics::print(char *buf, size_t size)
+{
+	std::lock_guard<std::mutex> lock(gListMutex);
+	int total = 0;
+	for (MediaStatistics *s = gListHead; s; s = s->mNext) {
+		size_t offset = ((size_t)total < size) ? (size_t)total : size;
+		int len = s->printOne(buf + offset, size - offset);
+		if (len < 0) {
+			return len;
+		}
+		total += len;
+	}
+
+	if (total == 0 && size > 0) {
+		buf[0] = '\0';
+	}
+	return total;
+}
+
+} // namespace media
+
+int media_statistics_read(char *buf, size_t size)
+{
+	return media::MediaStatistics::print(buf, size);
+}
@@ -0,0 +1,113 @@
+/******************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef __MEDIA_MEDIASTATISTICS_H
+#define __MEDIA_MEDIASTATISTICS_H
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+#include <mutex>
+#include <media/MediaPlayer.h>
+
+namespace media {
+
+/* Collects the measurements of one player's pipeline: source read and decoding on
+ * the InputHandler worker, the pcm StreamBuffer, and output writes on the player worker.
+ * The latency is traced by marking the pcm position which the data of each source read
+ * ends up at, and timing when the output goes past that position.
+ */
+class MediaStatistics
+{
+public:
+	MediaStatistics();
+	~MediaStatistics();
+
+	/* Monotonic time in microseconds, used as start time of the measurements */
+	static uint64_t now();
+
+	void reset();
+	void restartFlow(size_t level);
+
+	void addInput(size_t bytes, uint64_t start);
+	void markInput(uint64_t start);
+	void addDemux(size_t bytes, uint64_t start);
+	void addDecode(bool frame, uint64_t start);
+	void addResync(unsigned int count, unsigned int time);
+	void updateBuffer(ssize_t change, size_t level, size_t size);
+	void addUnderrun();
+	void addOutput(uint64_t start);
+
+	void get(player_statistics_t *stats);
+
+	/* Prints the measurements of every player, returns the length like snprintf */
+	static int print(char *buf, size_t size);
+
+private:
+	static const int LATENCY_MARKS = 8;
+
+	struct latency_mark_s {
+		uint32_t pos;
+		uint64_t stamp;
+	};
+
+	int printOne(char *buf, size_t size);
+
+	std::mutex mMutex;
+	unsigned int mId;
+	player_statistics_t mStats;
+	unsigned int mXrunBase;
+	/* pcm positions written to and read from the StreamBuffer, they may wrap */
+	uint32_t mProduced;
+	uint32_t mConsumed;
+	uint32_t mLastMarkPos;
+	uint64_t mPendingStamp;
+	struct latency_mark_s mMarks[LATENCY_MARKS];
+	int mMarkHead;
+	int mMarkCount;
+
+	MediaStatistics *mNext;
+};
+
+} // namespace media
+
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Name: media_statistics_read
+ *
+ * Description:
+ *   Print the measurements of every player, for the media procfs node.
+ *
+ * Input parameters:
+ *   buf: buffer to print to
+ *   size: size of buf
+ *
+ * Return Value:
+ *   The length of the whole text, which is cut at size - 1 like snprintf.
+ ****************************************************************************/
+int media_statistics_read(char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
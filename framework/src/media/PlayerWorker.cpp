@@ -18,14 +18,21 @@
 
 #include <tinyara/config.h>
 #include <debug.h>
+#include <unistd.h>
 
 #include "PlayerWorker.h"
 #include "MediaPlayerImpl.h"
+#ifdef CONFIG_AUDIO_MIXER
+#include "audio/audio_mixer.h"
+#endif
 
 #ifndef CONFIG_MEDIA_PLAYER_STACKSIZE
 #define CONFIG_MEDIA_PLAYER_STACKSIZE 4096
 #endif
 
+/* How long the worker backs off when the player has nothing to play yet */
+#define PLAYER_WORKER_RETRY_USEC 10000
+
 using namespace std;
 
 namespace media {
@@ -47,12 +54,38 @@ PlayerWorker& PlayerWorker::getWorker()
 
 bool PlayerWorker::processLoop()
 {
+#ifdef CONFIG_AUDIO_MIXER
+	bool playing = false;
+	bool progress = false;
+
+	/* playback() removes the player from mPlayers when the stream ends */
+	auto players = mPlayers;
+	for (auto &player : players) {
+		if (player->getState() == PLAYER_STATE_PLAYING) {
+			if (player->playback()) {
+				progress = true;
+			}
+			playing = true;
+		}
+	}
+
+	/* Every mixer stream is full, let the mixer take a period instead of spinning */
+	if (playing && !progress) {
+		audio_mixer_wait_room();
+	}
+
+	return playing;
+#else
 	if (mCurPlayer && (mCurPlayer->getState() == PLAYER_STATE_PLAYING)) {
-		mCurPlayer->playback();
+		if (!mCurPlayer->playback()) {
+			/* Nothing to play until the next track is buffered, let the prefetch run */
+			usleep(PLAYER_WORKER_RETRY_USEC);
+		}
 		return true;
 	}
 
 	return false;
+#endif
 }
 
 void PlayerWorker::setPlayer(std::shared_ptr<MediaPlayerImpl> player)
@@ -65,4 +98,21 @@ std::shared_ptr<MediaPlayerImpl> PlayerWorker::getPlayer()
 	return mCurPlayer;
 }
 
+#ifdef CONFIG_AUDIO_MIXER
+void PlayerWorker::addPlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	for (auto &p : mPlayers) {
+		if (p == player) {
+			return;
+		}
+	}
+	mPlayers.push_back(player);
+}
+
+void PlayerWorker::removePlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	mPlayers.remove(player);
+}
+#endif
+
 } // namespace media
@@ -165,6 +165,11 @@ static audio_card_info_t g_audio_out_cards[CONFIG_AUDIO_MAX_OUTPUT_CARD_NUM];
 static int g_actual_audio_in_card_id = INVALID_ID;
 static int g_actual_audio_out_card_id = INVALID_ID;
 
+/* Number of xruns met while writing the output stream. It is counted for all
+ * output streams together, and only changed with the lock of the output card held.
+ */
+static unsigned int g_audio_out_xruns;
+
 static const struct audio_samprate_map_entry_s g_audio_samprate_entry[] = {
 	{AUDIO_SAMP_RATE_TYPE_8K, AUDIO_SAMP_RATE_8K},
 	{AUDIO_SAMP_RATE_TYPE_11K, AUDIO_SAMP_RATE_11K},
@@ -186,7 +191,7 @@ static audio_manager_result_t get_supported_capability(audio_io_direction_t dire
 static audio_manager_result_t get_supported_process_type(int card_id, int device_id, audio_io_direction_t direct);
 static uint32_t get_closest_samprate(unsigned origin_samprate, audio_io_direction_t direct);
 static unsigned int resample_stream_in(audio_card_info_t *card, void *data, unsigned int frames);
-static unsigned int resample_stream_out(audio_card_info_t *card, void *data, unsigned int frames);
+static int resample_stream_out(audio_card_info_t *card, void *data, unsigned int frames);
 static audio_manager_result_t get_audio_volume(audio_io_direction_t direct);
 static audio_manager_result_t set_audio_volume(audio_io_direction_t direct, uint8_t volume);
 
@@ -456,18 +461,22 @@ static unsigned int resample_stream_in(audio_card_info_t *card, void *data, unsi
 
 /*
  * card: Pointer to audio card information structure
- *       card->resample.buffer retrieves generated frames for output,
- *       card->resample.frames returns the number of frames saved in above buffer.
+ *       Generated frames are written straight into the buffers lent by
+ *       pcm_writei_begin(), so they are not copied again by pcm_writei().
  * data: Pointer to the input buffer contains frames to resample.
  * frames: Gives the number of frames in the input buffer
- * return: On success, returns number of frames generated in resample.buffer,
+ * return: On success, returns number of frames written to the card,
  *         besides, card->resample.frames retrieves the same value.
  *         Otherwise, returns negative error codes on failure.
  */
-static unsigned int resample_stream_out(audio_card_info_t *card, void *data, unsigned int frames)
+static int resample_stream_out(audio_card_info_t *card, void *data, unsigned int frames)
 {
 	unsigned int used_frames = 0;
 	unsigned int resampled_frames = 0;
+	unsigned int out_frames;
+	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+	void *out;
+	int ret;
 	src_data_t srcData = { 0, };
 
 	srcData.origin_channel_num = card->resample.user_channel;
@@ -478,10 +487,24 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
 
 	while (frames > used_frames) {
+		out_frames = pcm_get_buffer_size(card->pcm);
+		ret = pcm_writei_begin(card->pcm, &out, &out_frames);
+		if (ret == -EPIPE) {
+			g_audio_out_xruns++;
+			if (prepare_retry-- > 0 && pcm_prepare(card->pcm) == OK) {
+				continue;
+			}
+			meddbg("Fail to recover from xrun\n");
+			return AUDIO_MANAGER_XRUN_STATE;
+		} else if (ret < 0) {
+			meddbg("pcm_writei_begin failed, ret = %d\n", ret);
+			return (ret == -EINVAL) ? AUDIO_MANAGER_INVALID_PARAM : AUDIO_MANAGER_OPERATION_FAIL;
+		}
+
 		srcData.data_in = (const void *)((char *)data + get_user_output_frames_to_byte(used_frames));
 		srcData.input_frames = frames - used_frames;
-		srcData.data_out = (void *)((char *)card->resample.buffer + get_card_output_frames_to_byte(resampled_frames));
-		srcData.out_buf_length = card->resample.buffer_size - get_card_output_frames_to_byte(resampled_frames);
+		srcData.data_out = out;
+		srcData.out_buf_length = get_card_output_frames_to_byte(out_frames);
 		medvdbg("data_in 0x%x, input_frames %d\n", srcData.data_in, srcData.input_frames);
 		medvdbg("data_out 0x%x, out_buf_length %d\n", srcData.data_out, srcData.out_buf_length);
 
@@ -493,6 +516,11 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 
 		used_frames += srcData.input_frames_used;
 		if (srcData.output_frames_gen > 0) {
+			ret = pcm_writei_commit(card->pcm, srcData.output_frames_gen);
+			if (ret < 0) {
+				meddbg("pcm_writei_commit failed, ret = %d\n", ret);
+				return AUDIO_MANAGER_OPERATION_FAIL;
+			}
 			resampled_frames += srcData.output_frames_gen;
 		} else if (frames != used_frames) {
 			meddbg("Error: output buffer is full, used input frames %d/%d\n", used_frames, frames);
@@ -814,27 +842,13 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 			goto error_with_pcm;
 		}
 
-		// Calculate the buffer size required for resampling.
-		float resample_buffer_frames = (float)get_output_frame_count();
+		// No resampling buffer is needed, frames are resampled straight into the pcm buffers.
+		card->resample.buffer_size = 0;
 		card->resample.ratio = 1;
 		if (config.rate != card->resample.user_sample_rate) {
 			card->resample.ratio = (float)config.rate / (float)card->resample.user_sample_rate; // ratio = card / user
-			resample_buffer_frames *= card->resample.ratio;
-			if (resample_buffer_frames - (int)resample_buffer_frames > 0) {
-				resample_buffer_frames = (int)resample_buffer_frames + 1;
-			}
-			medvdbg("resampling ratio %f, frames %u -> %d\n", card->resample.ratio, get_output_frame_count(), (int)resample_buffer_frames);
-		}
-		card->resample.buffer_size = get_card_output_frames_to_byte((int)resample_buffer_frames);
-		card->resample.buffer = malloc(card->resample.buffer_size);
-		if (!card->resample.buffer) {
-			meddbg("malloc for a resampling buffer(stream_out) is failed, resample_buffer_frames = %d\n", (int)resample_buffer_frames);
-			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
-			src_destroy(card->resample.handle);
-			card->resample.handle = NULL;
-			goto error_with_pcm;
+			medvdbg("resampling ratio %f\n", card->resample.ratio);
 		}
-		medvdbg("resampling buffer 0x%x, buffer_size %u\n", card->resample.buffer, card->resample.buffer_size);
 	}
 
 	card_config->status = AUDIO_CARD_READY;
@@ -953,21 +967,6 @@ int start_audio_stream_out(void *data, unsigned int frames)
 
 	pthread_mutex_lock(&(card->card_mutex));
 
-	if (card->resample.necessary) {
-		if (frames > get_output_frame_count()) {
-			frames = get_output_frame_count();
-		}
-		// Process resampling
-		ret = (int)resample_stream_out(card, data, frames);
-		if (ret < 0) {
-			meddbg("Fail to resample!!\n");
-			goto error_with_lock;
-		}
-		// Redirect `data` to resampling buffer and update `frames`
-		data = card->resample.buffer;
-		frames = card->resample.frames;
-	}
-
 	if (card->config[card->device_id].status == AUDIO_CARD_PAUSE) {
 		ret = ioctl(pcm_get_file_descriptor(card->pcm), AUDIOIOC_RESUME, 0UL);
 		if (ret < 0) {
@@ -979,10 +978,20 @@ int start_audio_stream_out(void *data, unsigned int frames)
 
 	card->config[card->device_id].status = AUDIO_CARD_RUNNING;
 
+	if (card->resample.necessary) {
+		// Process resampling straight into the pcm buffers
+		ret = resample_stream_out(card, data, frames);
+		if (ret < 0) {
+			meddbg("Fail to resample!!\n");
+		}
+		goto error_with_lock;
+	}
+
 	do {
 		ret = pcm_writei(card->pcm, data, frames);
 		if (ret < 0) {
 			if (ret == -EPIPE) {
+				g_audio_out_xruns++;
 				if (prepare_retry > 0) {
 					ret = pcm_prepare(card->pcm);
 					if (ret != OK) {
@@ -1268,6 +1277,11 @@ unsigned int get_output_frame_count(void)
 	return pcm_get_buffer_size(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
 }
 
+unsigned int get_audio_stream_out_xrun_count(void)
+{
+	return g_audio_out_xruns;
+}
+
 unsigned int get_card_output_frames_to_byte(unsigned int frames)
 {
 	if ((g_actual_audio_out_card_id < 0) || (frames == 0)) {
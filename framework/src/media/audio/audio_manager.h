@@ -323,6 +323,19 @@ unsigned int get_user_input_bytes_to_frame(unsigned int bytes);
  ****************************************************************************/
 unsigned int get_output_frame_count(void);
 
+/****************************************************************************
+ * Name: get_audio_stream_out_xrun_count
+ *
+ * Description:
+ *   Get the number of xruns met while writing the output stream, counting
+ *   the ones recovered by preparing the pcm again. The count is global, it
+ *   is not kept per output stream or per player.
+ *
+ * Return Value:
+ *   The number of xruns since the system started.
+ ****************************************************************************/
+unsigned int get_audio_stream_out_xrun_count(void);
+
 /****************************************************************************
  * Name: get_card_output_frames_to_byte
  *
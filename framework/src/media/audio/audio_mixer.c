@@ -0,0 +1,758 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <debug.h>
+#include <tinyalsa/tinyalsa.h>
+
+#include "audio_mixer.h"
+#include "resample/samplerate.h"
+#include "../utils/rb.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#ifndef CONFIG_AUDIO_MIXER_MAX_STREAMS
+#define CONFIG_AUDIO_MIXER_MAX_STREAMS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_CHANNELS
+#define CONFIG_AUDIO_MIXER_CHANNELS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_SAMPLE_RATE
+#define CONFIG_AUDIO_MIXER_SAMPLE_RATE 44100
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STREAM_PERIODS
+#define CONFIG_AUDIO_MIXER_STREAM_PERIODS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STACKSIZE
+#define CONFIG_AUDIO_MIXER_STACKSIZE 4096
+#endif
+
+/* The mixer always works on interleaved signed 16 bit samples */
+#define AUDIO_MIXER_FRAME_BYTES (CONFIG_AUDIO_MIXER_CHANNELS * sizeof(int16_t))
+
+#define AUDIO_MIXER_GAIN_SHIFT 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct audio_mixer_stream_s {
+	bool used;
+	bool paused;
+	bool eos;					/* No more frames follow the queued ones */
+	bool closing;				/* Closed by the owner, released once played out */
+	unsigned int channels;
+	unsigned int sample_rate;
+	unsigned int frame_bytes;	/* Size of a frame in the stream format */
+	src_handle_t src;			/* NULL when the stream matches the mixer */
+	int16_t *convbuf;			/* Converted frames, one mixer period */
+	unsigned int conv_pos;		/* First converted frame not queued yet */
+	unsigned int conv_frames;	/* Converted frames not queued yet */
+	rb_t rb;					/* Frames in the mixer format waiting to be mixed */
+	uint16_t gain;				/* Requested gain, Q8 */
+	uint16_t cur_gain;			/* Gain applied to the last mixed frame */
+	uint16_t ramp_from;			/* Gain the current ramp started from */
+	unsigned int ramp_pos;		/* Frames of the current ramp mixed so far */
+};
+
+struct audio_mixer_s {
+	pthread_mutex_t ctl_lock;	/* Serializes opening and closing of streams */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;		/* Signalled when frames are queued or consumed */
+	pthread_t thread;
+	bool running;
+	int nstreams;
+	unsigned int mixes;			/* Number of periods mixed so far */
+	unsigned int period;		/* Frames mixed and written to the pcm at once */
+	int16_t *outbuf;
+	int32_t *accbuf;
+	struct audio_mixer_stream_s streams[CONFIG_AUDIO_MIXER_MAX_STREAMS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+static struct audio_mixer_s g_mixer = {
+	.ctl_lock = PTHREAD_MUTEX_INITIALIZER,
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static struct audio_mixer_stream_s *audio_mixer_get_stream(int stream_id)
+{
+	if (stream_id < 0 || stream_id >= CONFIG_AUDIO_MIXER_MAX_STREAMS) {
+		return NULL;
+	}
+
+	if (!g_mixer.streams[stream_id].used || g_mixer.streams[stream_id].closing) {
+		return NULL;
+	}
+
+	return &g_mixer.streams[stream_id];
+}
+
+/* Whether a stream is open and not just draining, called with the mixer lock held */
+static bool audio_mixer_has_open_stream(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		if (g_mixer.streams[i].used && !g_mixer.streams[i].closing) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Adds the frames of a stream to the accumulation buffer. The gain moves
+ * linearly from the previous one to the requested one over one period worth
+ * of frames. A ramp which is not done when the frames run out is carried on
+ * by the next call.
+ */
+static void audio_mixer_accumulate(struct audio_mixer_stream_s *stream, const int16_t *in, unsigned int frames)
+{
+	int32_t *acc = g_mixer.accbuf;
+	int32_t from = stream->ramp_from;
+	int32_t to = stream->gain;
+	int32_t gain = stream->cur_gain;
+	unsigned int frame;
+	unsigned int ch;
+
+	for (frame = 0; frame < frames; frame++) {
+		if (stream->ramp_pos < g_mixer.period) {
+			stream->ramp_pos++;
+			gain = from + ((to - from) * (int32_t)stream->ramp_pos) / (int32_t)g_mixer.period;
+		}
+		for (ch = 0; ch < CONFIG_AUDIO_MIXER_CHANNELS; ch++) {
+			*acc++ += ((int32_t)*in++ * gain) >> AUDIO_MIXER_GAIN_SHIFT;
+		}
+	}
+
+	stream->cur_gain = (uint16_t)gain;
+}
+
+static void audio_mixer_saturate(unsigned int frames)
+{
+	unsigned int samples = frames * CONFIG_AUDIO_MIXER_CHANNELS;
+	unsigned int i;
+
+	for (i = 0; i < samples; i++) {
+		int32_t sample = g_mixer.accbuf[i];
+		if (sample > INT16_MAX) {
+			sample = INT16_MAX;
+		} else if (sample < INT16_MIN) {
+			sample = INT16_MIN;
+		}
+		g_mixer.outbuf[i] = (int16_t)sample;
+	}
+}
+
+static void audio_mixer_release_stream(struct audio_mixer_stream_s *stream)
+{
+	if (stream->src) {
+		src_destroy(stream->src);
+		stream->src = NULL;
+	}
+	free(stream->convbuf);
+	stream->convbuf = NULL;
+	rb_free(&stream->rb);
+	stream->used = false;
+}
+
+/*
+ * A period can be mixed once an active stream has a whole period queued or
+ * has reached its end. complete tells whether every other active stream
+ * with frames has a whole period as well; if not, the mixer gives them one
+ * period of time before padding them with silence.
+ */
+static bool audio_mixer_period_ready(bool *complete)
+{
+	size_t period_bytes = g_mixer.period * AUDIO_MIXER_FRAME_BYTES;
+	bool ready = false;
+	size_t used;
+	int i;
+
+	*complete = true;
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		struct audio_mixer_stream_s *stream = &g_mixer.streams[i];
+		if (!stream->used || stream->paused) {
+			continue;
+		}
+
+		used = rb_used(&stream->rb);
+		if (used == 0) {
+			continue;
+		}
+
+		if (used < period_bytes && !stream->eos) {
+			*complete = false;
+		} else {
+			ready = true;
+		}
+	}
+
+	return ready;
+}
+
+/* Absolute time one mixer period from now, for pthread_cond_timedwait() */
+static void audio_mixer_period_deadline(struct timespec *abstime)
+{
+	uint64_t nsec = (uint64_t)g_mixer.period * 1000000000ULL / CONFIG_AUDIO_MIXER_SAMPLE_RATE;
+
+	clock_gettime(CLOCK_REALTIME, abstime);
+	nsec += abstime->tv_nsec;
+	abstime->tv_sec += nsec / 1000000000ULL;
+	abstime->tv_nsec = nsec % 1000000000ULL;
+}
+
+/*
+ * Mixing thread. Every active stream contributes up to one period; the last
+ * frames of a stream which has reached its end, streams which ran dry and
+ * streams still short of a period after waiting one period are padded with
+ * silence, so that the pcm is always fed with whole periods and a stalled
+ * stream never holds the others back.
+ */
+static void *audio_mixer_thread(void *arg)
+{
+	size_t period_bytes = g_mixer.period * AUDIO_MIXER_FRAME_BYTES;
+	struct timespec deadline;
+	bool waiting = false;
+	bool timedout = false;
+	bool complete;
+	int ret;
+	int i;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	while (g_mixer.running) {
+		if (!audio_mixer_period_ready(&complete)) {
+			waiting = false;
+			timedout = false;
+			pthread_cond_wait(&g_mixer.cond, &g_mixer.lock);
+			continue;
+		}
+
+		if (!complete && !timedout) {
+			if (!waiting) {
+				audio_mixer_period_deadline(&deadline);
+				waiting = true;
+			}
+			if (pthread_cond_timedwait(&g_mixer.cond, &g_mixer.lock, &deadline) == ETIMEDOUT) {
+				timedout = true;
+			}
+			continue;
+		}
+		waiting = false;
+		timedout = false;
+
+		memset(g_mixer.accbuf, 0, g_mixer.period * CONFIG_AUDIO_MIXER_CHANNELS * sizeof(int32_t));
+		for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+			struct audio_mixer_stream_s *stream = &g_mixer.streams[i];
+			if (!stream->used || stream->paused) {
+				continue;
+			}
+
+			/* outbuf is free until the mix is saturated into it below */
+			size_t len = rb_read(&stream->rb, g_mixer.outbuf, period_bytes);
+			if (len > 0) {
+				audio_mixer_accumulate(stream, g_mixer.outbuf, len / AUDIO_MIXER_FRAME_BYTES);
+			}
+
+			/* A stream closed after draining goes once its last frames are mixed.
+			 * There is always another stream open while one is closing.
+			 */
+			if (stream->closing && rb_used(&stream->rb) == 0) {
+				audio_mixer_release_stream(stream);
+				g_mixer.nstreams--;
+			}
+		}
+		audio_mixer_saturate(g_mixer.period);
+
+		/* Room has been made in the stream buffers */
+		g_mixer.mixes++;
+		pthread_cond_broadcast(&g_mixer.cond);
+		pthread_mutex_unlock(&g_mixer.lock);
+
+		ret = start_audio_stream_out(g_mixer.outbuf, g_mixer.period);
+		if (ret < 0) {
+			meddbg("start_audio_stream_out failed, ret = %d\n", ret);
+		}
+
+		pthread_mutex_lock(&g_mixer.lock);
+	}
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return NULL;
+}
+
+static void audio_mixer_free_buffers(void)
+{
+	free(g_mixer.outbuf);
+	g_mixer.outbuf = NULL;
+	free(g_mixer.accbuf);
+	g_mixer.accbuf = NULL;
+}
+
+/* Called with the mixer lock held when the first stream is opened */
+static audio_manager_result_t audio_mixer_start(void)
+{
+	audio_manager_result_t res;
+	pthread_attr_t attr;
+	int ret;
+
+	res = set_audio_stream_out(CONFIG_AUDIO_MIXER_CHANNELS, CONFIG_AUDIO_MIXER_SAMPLE_RATE, PCM_FORMAT_S16_LE);
+	if (res != AUDIO_MANAGER_SUCCESS) {
+		meddbg("set_audio_stream_out failed, ret = %d\n", res);
+		return res;
+	}
+
+	g_mixer.period = get_output_frame_count();
+	g_mixer.outbuf = (int16_t *)malloc(g_mixer.period * AUDIO_MIXER_FRAME_BYTES);
+	g_mixer.accbuf = (int32_t *)malloc(g_mixer.period * CONFIG_AUDIO_MIXER_CHANNELS * sizeof(int32_t));
+	if (g_mixer.period == 0 || !g_mixer.outbuf || !g_mixer.accbuf) {
+		meddbg("Fail to allocate mixer buffers, period %u\n", g_mixer.period);
+		res = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout;
+	}
+
+	g_mixer.running = true;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, CONFIG_AUDIO_MIXER_STACKSIZE);
+	ret = pthread_create(&g_mixer.thread, &attr, audio_mixer_thread, NULL);
+	pthread_attr_destroy(&attr);
+	if (ret != 0) {
+		meddbg("Fail to create mixer thread, ret = %d\n", ret);
+		g_mixer.running = false;
+		res = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout;
+	}
+	pthread_setname_np(g_mixer.thread, "AudioMixer");
+
+	return AUDIO_MANAGER_SUCCESS;
+
+errout:
+	audio_mixer_free_buffers();
+	reset_audio_stream_out();
+	return res;
+}
+
+/* Called with only the control lock held when the last stream has been closed */
+static void audio_mixer_stop(void)
+{
+	pthread_join(g_mixer.thread, NULL);
+	audio_mixer_free_buffers();
+
+	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
+		meddbg("reset_audio_stream_out failed\n");
+	}
+}
+
+/* Queues as many frames already in the mixer format as fit, without waiting */
+static unsigned int audio_mixer_push(struct audio_mixer_stream_s *stream, const void *data, unsigned int frames)
+{
+	unsigned int room;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	room = rb_avail(&stream->rb) / AUDIO_MIXER_FRAME_BYTES;
+	if (frames > room) {
+		frames = room;
+	}
+	if (frames > 0) {
+		rb_write(&stream->rb, data, frames * AUDIO_MIXER_FRAME_BYTES);
+		stream->eos = false;
+		pthread_cond_broadcast(&g_mixer.cond);
+	}
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return frames;
+}
+
+/* Queues the converted frames left over by the previous write, true once none is left */
+static bool audio_mixer_push_converted(struct audio_mixer_stream_s *stream)
+{
+	unsigned int frames;
+
+	if (stream->conv_frames > 0) {
+		frames = audio_mixer_push(stream, stream->convbuf + stream->conv_pos * CONFIG_AUDIO_MIXER_CHANNELS, stream->conv_frames);
+		stream->conv_pos += frames;
+		stream->conv_frames -= frames;
+	}
+
+	return stream->conv_frames == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_open_stream(unsigned int channels, unsigned int sample_rate, int format, int *stream_id)
+{
+	audio_manager_result_t res;
+	struct audio_mixer_stream_s *stream = NULL;
+	int i;
+
+	if (channels == 0 || sample_rate == 0 || stream_id == NULL) {
+		meddbg("Invalid stream, channels %u rate %u\n", channels, sample_rate);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	/* The sample rate converter only handles 16 bit samples */
+	if (pcm_format_to_bits((enum pcm_format)format) != 16) {
+		meddbg("Unsupported format %d\n", format);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_mixer.ctl_lock);
+	pthread_mutex_lock(&g_mixer.lock);
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		if (!g_mixer.streams[i].used) {
+			stream = &g_mixer.streams[i];
+			break;
+		}
+	}
+
+	if (!stream) {
+		meddbg("No free mixer stream\n");
+		res = AUDIO_MANAGER_DEVICE_ALREADY_IN_USE;
+		goto errout_with_lock;
+	}
+
+	if (g_mixer.nstreams == 0) {
+		res = audio_mixer_start();
+		if (res != AUDIO_MANAGER_SUCCESS) {
+			goto errout_with_lock;
+		}
+	}
+
+	memset(stream, 0, sizeof(struct audio_mixer_stream_s));
+	stream->used = true;
+	stream->channels = channels;
+	stream->sample_rate = sample_rate;
+	stream->frame_bytes = channels * sizeof(int16_t);
+	stream->gain = AUDIO_MIXER_GAIN_UNITY;
+	stream->cur_gain = AUDIO_MIXER_GAIN_UNITY;
+	stream->ramp_from = AUDIO_MIXER_GAIN_UNITY;
+	stream->ramp_pos = g_mixer.period;
+
+	if (!rb_init(&stream->rb, g_mixer.period * AUDIO_MIXER_FRAME_BYTES * CONFIG_AUDIO_MIXER_STREAM_PERIODS)) {
+		meddbg("Fail to allocate stream buffer\n");
+		res = AUDIO_MANAGER_OPERATION_FAIL;
+		goto errout_with_stream;
+	}
+
+	if (channels != CONFIG_AUDIO_MIXER_CHANNELS || sample_rate != CONFIG_AUDIO_MIXER_SAMPLE_RATE) {
+		stream->src = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		stream->convbuf = (int16_t *)malloc(g_mixer.period * AUDIO_MIXER_FRAME_BYTES);
+		if (!stream->src || !stream->convbuf) {
+			meddbg("Fail to set up conversion, src %p\n", stream->src);
+			res = AUDIO_MANAGER_RESAMPLE_FAIL;
+			goto errout_with_stream;
+		}
+	}
+
+	g_mixer.nstreams++;
+	*stream_id = i;
+	pthread_mutex_unlock(&g_mixer.lock);
+	pthread_mutex_unlock(&g_mixer.ctl_lock);
+
+	medvdbg("Mixer stream %d opened, channels %u rate %u\n", i, channels, sample_rate);
+	return AUDIO_MANAGER_SUCCESS;
+
+errout_with_stream:
+	audio_mixer_release_stream(stream);
+	if (g_mixer.nstreams == 0) {
+		g_mixer.running = false;
+		pthread_cond_broadcast(&g_mixer.cond);
+		pthread_mutex_unlock(&g_mixer.lock);
+		audio_mixer_stop();
+		pthread_mutex_unlock(&g_mixer.ctl_lock);
+		return res;
+	}
+
+errout_with_lock:
+	pthread_mutex_unlock(&g_mixer.lock);
+	pthread_mutex_unlock(&g_mixer.ctl_lock);
+	return res;
+}
+
+int audio_mixer_write(int stream_id, const void *data, unsigned int frames)
+{
+	struct audio_mixer_stream_s *stream;
+	src_data_t srcData = { 0, };
+	unsigned int used_frames = 0;
+	int ret;
+
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream || data == NULL) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (!stream->src) {
+		return (int)audio_mixer_push(stream, data, frames);
+	}
+
+	/* Nothing more is converted until the frames converted last time are queued */
+	if (!audio_mixer_push_converted(stream)) {
+		return 0;
+	}
+
+	srcData.origin_channel_num = stream->channels;
+	srcData.origin_sample_rate = stream->sample_rate;
+	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	srcData.desired_channel_num = CONFIG_AUDIO_MIXER_CHANNELS;
+	srcData.desired_sample_rate = CONFIG_AUDIO_MIXER_SAMPLE_RATE;
+	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (frames > used_frames) {
+		srcData.data_in = (const void *)((const uint8_t *)data + used_frames * stream->frame_bytes);
+		srcData.input_frames = frames - used_frames;
+		srcData.data_out = stream->convbuf;
+		srcData.out_buf_length = g_mixer.period * AUDIO_MIXER_FRAME_BYTES;
+
+		ret = src_simple(stream->src, &srcData);
+		if (ret < 0) {
+			meddbg("Fail to resample in:%u/%u, error %d\n", used_frames, frames, ret);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+
+		used_frames += srcData.input_frames_used;
+		if (srcData.output_frames_gen > 0) {
+			stream->conv_pos = 0;
+			stream->conv_frames = srcData.output_frames_gen;
+			if (!audio_mixer_push_converted(stream)) {
+				/* The input is consumed, the rest of its output is queued by the next write */
+				break;
+			}
+		} else if (frames != used_frames && srcData.input_frames_used == 0) {
+			meddbg("Resampler made no progress, used input frames %u/%u\n", used_frames, frames);
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+	}
+
+	return (int)used_frames;
+}
+
+audio_manager_result_t audio_mixer_set_gain(int stream_id, uint16_t gain)
+{
+	struct audio_mixer_stream_s *stream;
+
+	if (gain > AUDIO_MIXER_GAIN_UNITY) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	/* Ramp from wherever the previous ramp has got to */
+	stream->ramp_from = stream->cur_gain;
+	stream->ramp_pos = 0;
+	stream->gain = gain;
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_pause_stream(int stream_id, bool pause)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	stream->paused = pause;
+	pthread_cond_broadcast(&g_mixer.cond);
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_flush_stream(int stream_id)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	rb_reset(&stream->rb);
+	stream->conv_frames = 0;
+	pthread_cond_broadcast(&g_mixer.cond);
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_drain_stream(int stream_id)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+	stream->eos = true;
+	pthread_cond_broadcast(&g_mixer.cond);
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_close_stream_drained(int stream_id)
+{
+	struct audio_mixer_stream_s *stream;
+
+	pthread_mutex_lock(&g_mixer.ctl_lock);
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		pthread_mutex_unlock(&g_mixer.ctl_lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	stream->closing = true;
+	if (stream->paused || (rb_used(&stream->rb) == 0 && stream->conv_frames == 0) || !audio_mixer_has_open_stream()) {
+		/* Nothing to play out, or nothing would keep the mixer running meanwhile */
+		stream->closing = false;
+		pthread_mutex_unlock(&g_mixer.lock);
+		pthread_mutex_unlock(&g_mixer.ctl_lock);
+		return audio_mixer_close_stream(stream_id);
+	}
+
+	/* Converted frames left over by the last write are dropped, they never made it to the stream */
+	stream->conv_frames = 0;
+	stream->eos = true;
+	pthread_cond_broadcast(&g_mixer.cond);
+	pthread_mutex_unlock(&g_mixer.lock);
+	pthread_mutex_unlock(&g_mixer.ctl_lock);
+
+	medvdbg("Mixer stream %d closing after drain\n", stream_id);
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t audio_mixer_close_stream(int stream_id)
+{
+	struct audio_mixer_stream_s *stream;
+	int i;
+
+	pthread_mutex_lock(&g_mixer.ctl_lock);
+	pthread_mutex_lock(&g_mixer.lock);
+	stream = audio_mixer_get_stream(stream_id);
+	if (!stream) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		pthread_mutex_unlock(&g_mixer.ctl_lock);
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	audio_mixer_release_stream(stream);
+	g_mixer.nstreams--;
+	medvdbg("Mixer stream %d closed\n", stream_id);
+
+	/* Streams still draining do not keep the output open on their own */
+	if (!audio_mixer_has_open_stream()) {
+		for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+			if (g_mixer.streams[i].used) {
+				audio_mixer_release_stream(&g_mixer.streams[i]);
+				g_mixer.nstreams--;
+			}
+		}
+	}
+
+	if (g_mixer.nstreams > 0) {
+		pthread_mutex_unlock(&g_mixer.lock);
+		pthread_mutex_unlock(&g_mixer.ctl_lock);
+		return AUDIO_MANAGER_SUCCESS;
+	}
+
+	g_mixer.running = false;
+	pthread_cond_broadcast(&g_mixer.cond);
+	pthread_mutex_unlock(&g_mixer.lock);
+
+	audio_mixer_stop();
+	pthread_mutex_unlock(&g_mixer.ctl_lock);
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+void audio_mixer_wait_room(void)
+{
+	struct timespec abstime;
+	unsigned int mixes;
+
+	pthread_mutex_lock(&g_mixer.lock);
+	if (g_mixer.running) {
+		mixes = g_mixer.mixes;
+		audio_mixer_period_deadline(&abstime);
+		while (g_mixer.running && mixes == g_mixer.mixes) {
+			if (pthread_cond_timedwait(&g_mixer.cond, &g_mixer.lock, &abstime) == ETIMEDOUT) {
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&g_mixer.lock);
+}
+
+unsigned int audio_mixer_get_frame_count(void)
+{
+	return g_mixer.period;
+}
+
+unsigned int audio_mixer_frames_to_byte(int stream_id, unsigned int frames)
+{
+	struct audio_mixer_stream_s *stream = audio_mixer_get_stream(stream_id);
+
+	if (!stream) {
+		return 0;
+	}
+
+	return frames * stream->frame_bytes;
+}
+
+unsigned int audio_mixer_bytes_to_frame(int stream_id, unsigned int bytes)
+{
+	struct audio_mixer_stream_s *stream = audio_mixer_get_stream(stream_id);
+
+	if (!stream) {
+		return 0;
+	}
+
+	return bytes / stream->frame_bytes;
+}
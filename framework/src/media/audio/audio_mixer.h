@@ -0,0 +1,241 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/**
+ * @file audio_mixer.h
+ * @brief Software mixer which lets several output streams share the single
+ *        output pcm opened by the audio manager.
+ */
+
+#ifndef __AUDIO_MIXER_H
+#define __AUDIO_MIXER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "audio_manager.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/**
+ * @brief Stream gain which leaves the samples untouched (Q8 fixed point).
+ */
+#define AUDIO_MIXER_GAIN_UNITY 256
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+/****************************************************************************
+ * Name: audio_mixer_open_stream
+ *
+ * Description:
+ *   Register a new stream to the mixer. The first stream opens the output
+ *   pcm with the mixer configuration and starts the mixing thread.
+ *   Frames written to a stream whose channels or sample rate differ from the
+ *   mixer configuration are converted when they enter the stream.
+ *
+ * Input parameters:
+ *   channels: number of channels of the stream
+ *   sample_rate: sample rate of the stream
+ *   format: pcm format of the stream, only 16 bit samples are supported
+ *   stream_id: returns the id used by the other mixer APIs
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_open_stream(unsigned int channels, unsigned int sample_rate, int format, int *stream_id);
+
+/****************************************************************************
+ * Name: audio_mixer_write
+ *
+ * Description:
+ *   Queue frames to the stream without waiting. Only the frames which fit
+ *   in the stream buffer are taken, the caller writes the rest later, for
+ *   instance after audio_mixer_wait_room(). Must not be called concurrently
+ *   with audio_mixer_close_stream() for the same stream. A stream short of
+ *   a whole period is padded with silence when the other streams are ready
+ *   and it is still short one period later, or when
+ *   audio_mixer_drain_stream() is called.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *   data: frames in the stream format
+ *   frames: number of frames in data
+ *
+ * Return Value:
+ *   On success, the number of frames taken, 0 when the stream buffer is
+ *   full. Otherwise, a negative value.
+ ****************************************************************************/
+int audio_mixer_write(int stream_id, const void *data, unsigned int frames);
+
+/****************************************************************************
+ * Name: audio_mixer_set_gain
+ *
+ * Description:
+ *   Set the gain of the stream in Q8 fixed point, AUDIO_MIXER_GAIN_UNITY
+ *   keeps the original level. The new gain is ramped in over one mixer
+ *   period worth of frames so that ducking a stream does not click.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *   gain: gain to apply, at most AUDIO_MIXER_GAIN_UNITY
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_set_gain(int stream_id, uint16_t gain);
+
+/****************************************************************************
+ * Name: audio_mixer_pause_stream
+ *
+ * Description:
+ *   Exclude or include the stream in the mix. Queued frames of a paused
+ *   stream are kept and played once the stream is resumed.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *   pause: true to pause, false to resume
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_pause_stream(int stream_id, bool pause);
+
+/****************************************************************************
+ * Name: audio_mixer_flush_stream
+ *
+ * Description:
+ *   Drop the frames queued to the stream which have not been mixed yet.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_flush_stream(int stream_id);
+
+/****************************************************************************
+ * Name: audio_mixer_drain_stream
+ *
+ * Description:
+ *   Mark the end of the frames queued to the stream, so that a last partial
+ *   period is played out padded with silence instead of waiting for more
+ *   frames. Writing to the stream again clears the mark.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_drain_stream(int stream_id);
+
+/****************************************************************************
+ * Name: audio_mixer_close_stream
+ *
+ * Description:
+ *   Remove the stream from the mixer. Closing the last stream stops the
+ *   mixing thread and releases the output pcm.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_close_stream(int stream_id);
+
+/****************************************************************************
+ * Name: audio_mixer_close_stream_drained
+ *
+ * Description:
+ *   Remove the stream from the mixer after the frames queued to it have
+ *   been played out, for instance the end of a track followed by a track
+ *   in another format. Returns at once and the stream id is invalid from
+ *   then on. A paused stream, or one without another stream open besides
+ *   it, is closed at once like audio_mixer_close_stream().
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t audio_mixer_close_stream_drained(int stream_id);
+
+/****************************************************************************
+ * Name: audio_mixer_wait_room
+ *
+ * Description:
+ *   Wait until the mixer has taken a period from the streams, or at most
+ *   one period. Lets a writer whose streams are all full back off instead
+ *   of spinning on audio_mixer_write().
+ ****************************************************************************/
+void audio_mixer_wait_room(void);
+
+/****************************************************************************
+ * Name: audio_mixer_get_frame_count
+ *
+ * Description:
+ *   Get the number of frames mixed per period, in the mixer sample rate.
+ *
+ * Return Value:
+ *   On success, the number of frames. Otherwise, 0.
+ ****************************************************************************/
+unsigned int audio_mixer_get_frame_count(void);
+
+/****************************************************************************
+ * Name: audio_mixer_frames_to_byte
+ *
+ * Description:
+ *   Get the size in bytes of frames in the format of the stream.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *   frames: number of frames
+ *
+ * Return Value:
+ *   On success, the size in bytes. Otherwise, 0.
+ ****************************************************************************/
+unsigned int audio_mixer_frames_to_byte(int stream_id, unsigned int frames);
+
+/****************************************************************************
+ * Name: audio_mixer_bytes_to_frame
+ *
+ * Description:
+ *   Get the number of frames held by bytes in the format of the stream.
+ *
+ * Input parameters:
+ *   stream_id: id returned by audio_mixer_open_stream()
+ *   bytes: size in bytes
+ *
+ * Return Value:
+ *   On success, the number of frames. Otherwise, 0.
+ ****************************************************************************/
+unsigned int audio_mixer_bytes_to_frame(int stream_id, unsigned int bytes);
+
+#if defined(__cplusplus)
+}								/* extern "C" */
+#endif
+
+#endif
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <assert.h>
 #include <pthread.h>
+#include <time.h>
 #include <debug.h>
 #include <media/MediaTypes.h>
 #include "audio_decoder.h"
@@ -107,6 +108,14 @@ using namespace media;
 // Frame Resync, match more frame headers for confirming.
 #define FRAME_MATCH_REQUIRED 2
 
+// Word-at-a-time byte search, a word has a zero byte if the result is non zero.
+#define SYNC_WORD_ONES  0x01010101U
+#define SYNC_WORD_HIGHS 0x80808080U
+#define SYNC_WORD_HAS_ZERO(word) (((word) - SYNC_WORD_ONES) & ~(word) & SYNC_WORD_HIGHS)
+
+// MPEG audio frame sync, 11 bits of '1'.
+#define MP3_FRAME_SYNC_VERIFY(buf) ((buf[0] == 0xff) && ((buf[1] & 0xe0) == 0xe0))
+
 #define U32_LEN_IN_BYTES (sizeof(uint32_t) / sizeof(uint8_t))
 
 // Opus packet header is self-defined, 4 bytes syncword + 4 bytes packet length.
@@ -259,6 +268,154 @@ static ssize_t _source_read_at(rbstream_p fp, ssize_t offset, void *data, size_t
 	return rbs_read(data, 1, size, fp);
 }
 
+/**
+ * @enum    frame_sync_e
+ * @brief   Sync words searched while frame resync.
+ */
+enum frame_sync_e {
+	FRAME_SYNC_MP3,  // 0xFFE
+	FRAME_SYNC_AAC,  // 0xFFF, ADTS
+	FRAME_SYNC_OPUS, // "Opus"
+};
+
+/**
+ * @struct  resync_window_s
+ * @brief   Window of stream data scanned while frame resync. Data is referred
+ *          in ring-buffer directly, and copied to `buf` only in case of it
+ *          wraps around the end of ring-buffer.
+ */
+struct resync_window_s {
+	const uint8_t *ptr;
+	ssize_t pos;
+	size_t len;
+	uint8_t buf[FRAME_RESYNC_READ_BYTES];
+};
+
+// Find the first byte of the given value in data, a word at a time.
+// Return offset of the byte, or len if not found.
+static size_t _find_byte(const uint8_t *data, size_t len, uint8_t value)
+{
+	size_t i = 0;
+
+	while (i < len && ((uintptr_t)(data + i) & (sizeof(uint32_t) - 1)) != 0) {
+		if (data[i] == value) {
+			return i;
+		}
+		i++;
+	}
+
+	uint32_t pattern = SYNC_WORD_ONES * value;
+	while (i + sizeof(uint32_t) <= len) {
+		uint32_t word = *(const uint32_t *)(data + i) ^ pattern;
+		if (SYNC_WORD_HAS_ZERO(word)) {
+			break;
+		}
+		i += sizeof(uint32_t);
+	}
+
+	while (i < len && data[i] != value) {
+		i++;
+	}
+
+	return i;
+}
+
+// Find the first candidate of sync word in data, candidates start within [0, len),
+// and at least 4 bytes should be readable from every candidate.
+// Return offset of the candidate, or len if not found.
+static size_t _find_frame_sync(const uint8_t *data, size_t len, int type)
+{
+	uint8_t lead = (type == FRAME_SYNC_OPUS) ? 'O' : 0xff;
+	size_t i = 0;
+
+	while ((i += _find_byte(data + i, len - i, lead)) < len) {
+		const uint8_t *p = data + i;
+		switch (type) {
+		case FRAME_SYNC_MP3:
+			if (MP3_FRAME_SYNC_VERIFY(p)) {
+				return i;
+			}
+			break;
+		case FRAME_SYNC_AAC:
+			if (AAC_ADTS_SYNC_VERIFY(p)) {
+				return i;
+			}
+			break;
+		case FRAME_SYNC_OPUS:
+			if (OPUS_PACKET_SYNC_VERIFY(p)) {
+				return i;
+			}
+			break;
+		}
+		i++;
+	}
+
+	return len;
+}
+
+// Get stream data at pos from resync window, the window is reloaded if it doesn't
+// hold `least` bytes from pos. Return pointer to the data and number of bytes in *len.
+static const uint8_t *_resync_window_get(rbstream_p fp, struct resync_window_s *win, ssize_t pos, size_t least, size_t *len)
+{
+	if (pos < win->pos || pos + (ssize_t)least > win->pos + (ssize_t)win->len) {
+		const void *ptr;
+		RETURN_VAL_IF_FAIL((rbs_seek(fp, pos, SEEK_SET) == OK), NULL);
+
+		win->pos = pos;
+		win->len = rbs_peek(&ptr, fp);
+		win->ptr = (const uint8_t *)ptr;
+		if (win->len < least) {
+			// data wraps around, or there's not enough data
+			win->len = rbs_read(win->buf, 1, sizeof(win->buf), fp);
+			win->ptr = win->buf;
+			RETURN_VAL_IF_FAIL((win->len >= least), NULL);
+		}
+	}
+
+	*len = (size_t)(win->pos + (ssize_t)win->len - pos);
+	return win->ptr + (pos - win->pos);
+}
+
+// Move pos to the next candidate of sync word, within FRAME_RESYNC_MAX_CHECK_BYTES from start.
+// Return pointer to the candidate, `least` bytes are readable from it.
+static const uint8_t *_resync_next_candidate(rbstream_p fp, struct resync_window_s *win, int type, size_t least, ssize_t start, ssize_t *pos)
+{
+	while (*pos < start + FRAME_RESYNC_MAX_CHECK_BYTES) {
+		size_t len;
+		const uint8_t *data = _resync_window_get(fp, win, *pos, least, &len);
+		if (data == NULL) {
+			return NULL;
+		}
+
+		size_t scan = len - (least - 1);
+		size_t offset = _find_frame_sync(data, scan, type);
+		*pos += offset;
+		if (offset < scan && *pos < start + FRAME_RESYNC_MAX_CHECK_BYTES) {
+			return data + offset;
+		}
+	}
+
+	medvdbg("[%s] resync range < %d\n", __FUNCTION__, FRAME_RESYNC_MAX_CHECK_BYTES);
+	return NULL;
+}
+
+#ifdef CONFIG_MEDIA_STATISTICS
+// Monotonic time in microseconds.
+static uint64_t _resync_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Account a resync done while getting a frame, started at 'start'.
+static void _resync_done(audio_decoder_p decoder, uint64_t start)
+{
+	decoder->resyncs++;
+	decoder->resync_time += (unsigned int)(_resync_now() - start);
+}
+#endif
+
 // Resync to next valid MP3 frame in the file.
 static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos, uint32_t *out_header)
 {
@@ -283,58 +440,20 @@ static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos,
 
 	ssize_t pos = *inout_pos;
 	bool valid = false;
-	uint8_t buf[FRAME_RESYNC_READ_BYTES];
-	ssize_t bytesToRead = FRAME_RESYNC_READ_BYTES;
-	ssize_t totalBytesRead = 0;
-	ssize_t remainingBytes = 0;
-	bool reachEOS = false;
-	uint8_t *buf_ptr = buf;
-
-	do {
-		if (pos >= *inout_pos + FRAME_RESYNC_MAX_CHECK_BYTES) {
-			medvdbg("[%s] resync range < %d\n", __FUNCTION__, FRAME_RESYNC_MAX_CHECK_BYTES);
-			break;
-		}
-
-		if (remainingBytes < (ssize_t)U32_LEN_IN_BYTES) {
-			if (reachEOS) {
-				break;
-			}
+	struct resync_window_s win = { 0, };
+	const uint8_t *candidate;
 
-			memcpy(buf, buf_ptr, remainingBytes);
-			bytesToRead = FRAME_RESYNC_READ_BYTES - remainingBytes;
-
-			/*
-			 * The next read position should start from the end of
-			 * the last buffer, and thus should include the remaining
-			 * bytes in the buffer.
-			 */
-			totalBytesRead = _source_read_at(fp, pos + remainingBytes, buf + remainingBytes, bytesToRead);
-
-			if (totalBytesRead <= 0) {
-				break;
-			}
-
-			reachEOS = (totalBytesRead != bytesToRead);
-			remainingBytes += totalBytesRead;
-			buf_ptr = buf;
-			continue;
-		}
-
-		uint32_t header = _u32_at(buf_ptr);
+	while (!valid && (candidate = _resync_next_candidate(fp, &win, FRAME_SYNC_MP3, U32_LEN_IN_BYTES, *inout_pos, &pos)) != NULL) {
+		uint32_t header = _u32_at(candidate);
 
 		if (match_header != 0 && (header & MP3_FRAME_HEADER_MASK) != (match_header & MP3_FRAME_HEADER_MASK)) {
 			++pos;
-			++buf_ptr;
-			--remainingBytes;
 			continue;
 		}
 
 		size_t frame_size;
 		if (!_parse_header(header, &frame_size)) {
 			++pos;
-			++buf_ptr;
-			--remainingBytes;
 			continue;
 		}
 
@@ -370,6 +489,8 @@ static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos,
 			medvdbg("[%s] Line %d, valid frame at pos %#x + framesize %#x = %#x\n", __FUNCTION__, __LINE__, test_pos, test_frame_size, test_pos + test_frame_size);
 			test_pos += test_frame_size;
 		}
+		// stream has been read for successors, refer it again.
+		win.len = 0;
 
 		if (valid) {
 			*inout_pos = pos;
@@ -379,12 +500,11 @@ static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos,
 			}
 
 			medvdbg("[%s] Line %d, find header %#x at pos %d(%#x)\n", __FUNCTION__, __LINE__, header, pos, pos);
+			break;
 		}
 
 		++pos;
-		++buf_ptr;
-		--remainingBytes;
-	} while (!valid);
+	}
 
 	return valid;
 }
@@ -407,8 +527,9 @@ int mp3_init(audio_decoder_p decoder, void *dec_ext)
 }
 
 // Get the next valid MP3 frame.
-bool mp3_get_frame(rbstream_p mFp, ssize_t *offset, uint32_t *fixed_header, void *buffer, uint32_t *size)
+bool mp3_get_frame(audio_decoder_p decoder, ssize_t *offset, uint32_t *fixed_header, void *buffer, uint32_t *size)
 {
+	rbstream_p mFp = decoder->rbsp;
 	size_t frame_size;
 
 	for (;;) {
@@ -424,7 +545,14 @@ bool mp3_get_frame(rbstream_p mFp, ssize_t *offset, uint32_t *fixed_header, void
 
 		// Lost sync.
 		ssize_t pos = *offset;
-		if (!mp3_resync(mFp, *fixed_header, &pos, fixed_header)) {
+#ifdef CONFIG_MEDIA_STATISTICS
+		uint64_t start = _resync_now();
+#endif
+		bool found = mp3_resync(mFp, *fixed_header, &pos, fixed_header);
+#ifdef CONFIG_MEDIA_STATISTICS
+		_resync_done(decoder, start);
+#endif
+		if (!found) {
 			// Unable to mp3_resync. Signalling end of stream.
 			return false;
 		}
@@ -474,54 +602,14 @@ static bool aac_resync(rbstream_p fp, ssize_t *inout_pos)
 {
 	ssize_t pos = *inout_pos;
 	bool valid = false;
+	struct resync_window_s win = { 0, };
+	const uint8_t *candidate;
 
-	uint8_t buf[FRAME_RESYNC_READ_BYTES];
-	ssize_t bytesToRead = FRAME_RESYNC_READ_BYTES;
-	ssize_t totalBytesRead = 0;
-	ssize_t remainingBytes = 0;
-	bool reachEOS = false;
-	uint8_t *buf_ptr = buf;
-
-	do {
-		if (pos >= *inout_pos + FRAME_RESYNC_MAX_CHECK_BYTES) {
-			break;
-		}
-
-		if (remainingBytes < AAC_ADTS_FRAME_HEADER_LEN) {
-			if (reachEOS) {
-				break;
-			}
-
-			memcpy(buf, buf_ptr, remainingBytes);
-			bytesToRead = FRAME_RESYNC_READ_BYTES - remainingBytes;
-
-			/*
-			 * The next read position should start from the end of
-			 * the last buffer, and thus should include the remaining
-			 * bytes in the buffer.
-			 */
-			totalBytesRead = _source_read_at(fp, pos + remainingBytes, buf + remainingBytes, bytesToRead);
-			if (totalBytesRead <= 0) {
-				break;
-			}
-
-			reachEOS = (totalBytesRead != bytesToRead);
-			remainingBytes += totalBytesRead;
-			buf_ptr = buf;
-			continue;
-		}
-
-		if (!AAC_ADTS_SYNC_VERIFY(buf_ptr)) {
-			++pos;
-			++buf_ptr;
-			--remainingBytes;
-			continue;
-		}
-
+	while (!valid && (candidate = _resync_next_candidate(fp, &win, FRAME_SYNC_AAC, AAC_ADTS_FRAME_HEADER_LEN, *inout_pos, &pos)) != NULL) {
 		// We found what looks like a valid frame,
 		// now find its successors.
 		valid = true;
-		int frame_size = AAC_ADTS_FRAME_GETSIZE(buf_ptr);
+		int frame_size = AAC_ADTS_FRAME_GETSIZE(candidate);
 		ssize_t test_pos = pos + frame_size;
 		int j;
 		for (j = 0; j < FRAME_MATCH_REQUIRED; ++j) {
@@ -540,15 +628,16 @@ static bool aac_resync(rbstream_p fp, ssize_t *inout_pos)
 			int test_frame_size = AAC_ADTS_FRAME_GETSIZE(temp);
 			test_pos += test_frame_size;
 		}
+		// stream has been read for successors, refer it again.
+		win.len = 0;
 
 		if (valid) {
 			*inout_pos = pos;
+			break;
 		}
 
 		++pos;
-		++buf_ptr;
-		--remainingBytes;
-	} while (!valid);
+	}
 
 	return valid;
 }
@@ -572,8 +661,9 @@ int aac_init(audio_decoder_p decoder, void *dec_ext)
 }
 
 // Get the next valid aac frame.
-bool aac_get_frame(rbstream_p mFp, ssize_t *offset, void *buffer, uint32_t *size)
+bool aac_get_frame(audio_decoder_p decoder, ssize_t *offset, void *buffer, uint32_t *size)
 {
+	rbstream_p mFp = decoder->rbsp;
 	size_t frame_size = 0;
 	uint8_t *buf = (uint8_t *) buffer;
 
@@ -588,7 +678,14 @@ bool aac_get_frame(rbstream_p mFp, ssize_t *offset, void *buffer, uint32_t *size
 
 		// Lost sync.
 		ssize_t pos = *offset;
-		RETURN_VAL_IF_FAIL(aac_resync(mFp, &pos), false);
+#ifdef CONFIG_MEDIA_STATISTICS
+		uint64_t start = _resync_now();
+#endif
+		bool found = aac_resync(mFp, &pos);
+#ifdef CONFIG_MEDIA_STATISTICS
+		_resync_done(decoder, start);
+#endif
+		RETURN_VAL_IF_FAIL(found, false);
 
 		*offset = pos;
 		rbs_seek_ext(mFp, *offset, SEEK_SET);
@@ -630,54 +727,14 @@ static bool opus_resync(rbstream_p fp, ssize_t *inout_pos)
 {
 	ssize_t pos = *inout_pos;
 	bool valid = false;
+	struct resync_window_s win = { 0, };
+	const uint8_t *candidate;
 
-	uint8_t buf[FRAME_RESYNC_READ_BYTES];
-	ssize_t bytesToRead = FRAME_RESYNC_READ_BYTES;
-	ssize_t totalBytesRead = 0;
-	ssize_t remainingBytes = 0;
-	bool reachEOS = false;
-	uint8_t *buf_ptr = buf;
-
-	do {
-		if (pos >= *inout_pos + FRAME_RESYNC_MAX_CHECK_BYTES) {
-			break;
-		}
-
-		if (remainingBytes < OPUS_PACKET_HEADER_LEN) {
-			if (reachEOS) {
-				break;
-			}
-
-			memcpy(buf, buf_ptr, remainingBytes);
-			bytesToRead = FRAME_RESYNC_READ_BYTES - remainingBytes;
-
-			/*
-			 * The next read position should start from the end of
-			 * the last buffer, and thus should include the remaining
-			 * bytes in the buffer.
-			 */
-			totalBytesRead = _source_read_at(fp, pos + remainingBytes, buf + remainingBytes, bytesToRead);
-			if (totalBytesRead <= 0) {
-				break;
-			}
-
-			reachEOS = (totalBytesRead != bytesToRead);
-			remainingBytes += totalBytesRead;
-			buf_ptr = buf;
-			continue;
-		}
-
-		if (!OPUS_PACKET_SYNC_VERIFY(buf_ptr)) {
-			++pos;
-			++buf_ptr;
-			--remainingBytes;
-			continue;
-		}
-
+	while (!valid && (candidate = _resync_next_candidate(fp, &win, FRAME_SYNC_OPUS, OPUS_PACKET_HEADER_LEN, *inout_pos, &pos)) != NULL) {
 		// We found what looks like a valid frame,
 		// now find its successors.
 		valid = true;
-		int frame_size = OPUS_PACKET_GETSIZE(buf_ptr);
+		int frame_size = OPUS_PACKET_GETSIZE(candidate);
 		ssize_t test_pos = pos + frame_size;
 		int j;
 		for (j = 0; j < FRAME_MATCH_REQUIRED; ++j) {
@@ -696,15 +753,16 @@ static bool opus_resync(rbstream_p fp, ssize_t *inout_pos)
 			int test_frame_size = OPUS_PACKET_GETSIZE(temp);
 			test_pos += test_frame_size;
 		}
+		// stream has been read for successors, refer it again.
+		win.len = 0;
 
 		if (valid) {
 			*inout_pos = pos;
+			break;
 		}
 
 		++pos;
-		++buf_ptr;
-		--remainingBytes;
-	} while (!valid);
+	}
 
 	return valid;
 }
@@ -728,8 +786,9 @@ int opus_init(audio_decoder_p decoder, void *dec_ext)
 }
 
 // Get the next valid Opus frame.
-bool opus_get_frame(rbstream_p mFp, ssize_t *offset, void *buffer, uint32_t *size)
+bool opus_get_frame(audio_decoder_p decoder, ssize_t *offset, void *buffer, uint32_t *size)
 {
+	rbstream_p mFp = decoder->rbsp;
 	size_t frame_size = 0;
 	uint8_t *buf = (uint8_t *) buffer;
 
@@ -744,7 +803,14 @@ bool opus_get_frame(rbstream_p mFp, ssize_t *offset, void *buffer, uint32_t *siz
 
 		// Lost sync.
 		ssize_t pos = *offset;
-		RETURN_VAL_IF_FAIL(opus_resync(mFp, &pos), false);
+#ifdef CONFIG_MEDIA_STATISTICS
+		uint64_t start = _resync_now();
+#endif
+		bool found = opus_resync(mFp, &pos);
+#ifdef CONFIG_MEDIA_STATISTICS
+		_resync_done(decoder, start);
+#endif
+		RETURN_VAL_IF_FAIL(found, false);
 
 		*offset = pos;
 		rbs_seek_ext(mFp, *offset, SEEK_SET);
@@ -804,12 +870,12 @@ bool _get_frame(audio_decoder_p decoder)
 	switch (decoder->audio_type) {
 	case AUDIO_TYPE_MP3: {
 		tPVMP3DecoderExternal *mp3_ext = (tPVMP3DecoderExternal *) decoder->dec_ext;
-		return mp3_get_frame(decoder->rbsp, &priv->mCurrentPos, &priv->mFixedHeader, (void *)mp3_ext->pInputBuffer, (uint32_t *)&mp3_ext->inputBufferCurrentLength);
+		return mp3_get_frame(decoder, &priv->mCurrentPos, &priv->mFixedHeader, (void *)mp3_ext->pInputBuffer, (uint32_t *)&mp3_ext->inputBufferCurrentLength);
 	}
 
 	case AUDIO_TYPE_AAC: {
 		tPVMP4AudioDecoderExternal *aac_ext = (tPVMP4AudioDecoderExternal *) decoder->dec_ext;
-		return aac_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)aac_ext->pInputBuffer, (uint32_t *)&aac_ext->inputBufferCurrentLength);
+		return aac_get_frame(decoder, &priv->mCurrentPos, (void *)aac_ext->pInputBuffer, (uint32_t *)&aac_ext->inputBufferCurrentLength);
 	}
 
 	case AUDIO_TYPE_WAVE: {
@@ -821,7 +887,7 @@ bool _get_frame(audio_decoder_p decoder)
 #ifdef CONFIG_CODEC_LIBOPUS
 	case AUDIO_TYPE_OPUS: {
 		opus_dec_external_t *opus_ext = (opus_dec_external_t *) decoder->dec_ext;
-		return opus_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)opus_ext->pInputBuffer, (uint32_t *)&opus_ext->inputBufferCurrentLength);
+		return opus_get_frame(decoder, &priv->mCurrentPos, (void *)opus_ext->pInputBuffer, (uint32_t *)&opus_ext->inputBufferCurrentLength);
 	}
 #endif
 
@@ -59,6 +59,12 @@ struct audio_decoder_s {
 
 	// private data
 	void *priv_data;            /* pointer to private data */
+
+#ifdef CONFIG_MEDIA_STATISTICS
+	// statistics, cleared by the user
+	unsigned int resyncs;       /* times the frame sync was lost and searched for again */
+	unsigned int resync_time;   /* time spent searching, in microseconds */
+#endif
 };
 
 /**
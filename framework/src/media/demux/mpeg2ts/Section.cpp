@@ -42,10 +42,18 @@ std::shared_ptr<Section> Section::create(ts_pid_t pid, uint8_t continuityCounter
 bool Section::initialize(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size)
 {
 	mSectionDataLen = parseLengthField(pData, size);
-	mSectionData = new uint8_t[mSectionDataLen];
-	if (!mSectionData) {
-		meddbg("Run out of memory! Allocating %d bytes failed!\n", mSectionDataLen);
-		return false;
+	if (mSectionDataLen > mSectionBufferSize) {
+		if (mSectionData) {
+			delete[] mSectionData;
+		}
+		mSectionBufferSize = 0;
+		mSectionData = new uint8_t[mSectionDataLen];
+		if (!mSectionData) {
+			meddbg("Run out of memory! Allocating %d bytes failed!\n", mSectionDataLen);
+			mSectionDataLen = 0;
+			return false;
+		}
+		mSectionBufferSize = mSectionDataLen;
 	}
 
 	if (mSectionDataLen < size) {
@@ -66,6 +74,7 @@ Section::Section()
 	: mPid(INVALID_PID)
 	, mContinuityCounter(0)
 	, mSectionData(nullptr)
+	, mSectionBufferSize(0)
 	, mSectionDataLen(0)
 	, mPresentDataLen(0)
 {
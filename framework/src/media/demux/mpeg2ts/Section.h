@@ -30,7 +30,8 @@ public:
 	// constructor and destructor
 	Section();
 	virtual ~Section();
-	// initialize section member and allocate data buffer
+	// initialize section member and allocate data buffer,
+	// the buffer is reused if the section has been initialized with a larger one before.
 	bool initialize(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
 	// append new section data from ts packet payload
 	bool appendData(ts_pid_t pid, uint8_t continuityCounter, uint8_t *pData, uint16_t size);
@@ -60,6 +61,8 @@ private:
 	uint8_t mContinuityCounter;
 	// section data buffer allocated
 	uint8_t *mSectionData;
+	// size in bytes of the section data buffer allocated
+	uint16_t mSectionBufferSize;
 	// total data length in bytes of a completed section
 	uint16_t mSectionDataLen;
 	// present data length in section data buffer
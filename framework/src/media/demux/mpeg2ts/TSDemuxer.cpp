@@ -37,6 +37,8 @@
 
 // times to match sync byte for resync
 #define TS_SYNC_COUNT               (3)
+// number of TS packet slots in pool, packets are loaded from stream buffer in batch
+#define TS_PACKET_POOL_SLOTS        (8)
 // threshold is not used, we don't have any buffer observer now.
 #define TS_DEMUX_BUFFER_THRESHOLD   (CONFIG_DEMUX_BUFFER_SIZE / 2)
 
@@ -44,6 +46,10 @@ namespace media {
 
 TSDemuxer::TSDemuxer()
 	: Demuxer(AUDIO_TYPE_MP2T)
+	, mPESPending(false)
+	, mPacketPool(nullptr)
+	, mPoolPackets(0)
+	, mPoolIndex(0)
 	, mPESPid(INVALID_PID)
 	, mPESDataUsed(0)
 {
@@ -51,6 +57,10 @@ TSDemuxer::TSDemuxer()
 
 TSDemuxer::~TSDemuxer()
 {
+	if (mPacketPool) {
+		delete[] mPacketPool;
+		mPacketPool = nullptr;
+	}
 }
 
 std::shared_ptr<TSDemuxer> TSDemuxer::create(void)
@@ -102,6 +112,18 @@ bool TSDemuxer::initialize(void)
 		return false;
 	}
 
+	mPESPacket = std::make_shared<PESPacket>();
+	if (!mPESPacket) {
+		meddbg("mPESPacket is nullptr!\n");
+		return false;
+	}
+
+	mPacketPool = new uint8_t[TS_PACKET_POOL_SLOTS * TSPacket::PACKET_SIZE];
+	if (!mPacketPool) {
+		meddbg("mPacketPool is nullptr!\n");
+		return false;
+	}
+
 	return true;
 }
 
@@ -121,80 +143,107 @@ ssize_t TSDemuxer::pushData(uint8_t *buf, size_t size)
 
 ssize_t TSDemuxer::pullData(uint8_t *buf, size_t size, void *param)
 {
-	if (mPESPid == INVALID_PID) {
-		// setup PES pid
-		prog_num_t progNum;
-		if (param) {
-			progNum = *((prog_num_t *)param);
-		} else {
-			// use default 1st program
-			std::vector<prog_num_t> programs;
-			mParserManager->getPrograms(programs);
-			progNum = programs[0];
-		}
-		uint8_t streamType;
-		if (!mParserManager->getAudioStreamInfo(progNum, streamType, mPESPid)) {
-			meddbg("get audio PES PID failed\n");
-			return DEMUXER_ERROR_NOT_READY;
+	ssize_t ret = DEMUXER_ERROR_NONE;
+	size_t fill = 0;
+	uint8_t *data;
+
+	while (fill < size) {
+		ret = pullDataRef(&data, size - fill, param);
+		if (ret <= 0) {
+			break;
 		}
-		medvdbg("setup audio PES PID: 0x%x\n", mPESPid);
+
+		memcpy(&buf[fill], data, (size_t)ret);
+		fill += (size_t)ret;
+		medvdbg("Got ES data %u(%d)/%u\n", fill, ret, size);
 	}
 
-	int ret = DEMUXER_ERROR_NONE;
-	size_t fill = 0;
-	size_t need;
-	while (fill < size) {
-		need = size - fill;
-		if (mPESParser->getESData() != nullptr) {
-			// get remaining payload in last PES packet
-			if (need > mPESParser->getESDataLen() - mPESDataUsed) {
-				need = mPESParser->getESDataLen() - mPESDataUsed;
+	if (fill == 0) {
+		medvdbg("Got nothing, please check error: %d\n", ret);
+		return ret;
+	}
+
+	return (ssize_t)fill;
+}
+
+ssize_t TSDemuxer::pullDataRef(uint8_t **buf, size_t size, void *param)
+{
+	int ret = setupPESPid(param);
+	if (ret != DEMUXER_ERROR_NONE) {
+		return ret;
+	}
+
+	while (size > 0) {
+		if (mPESParser->getESData() == nullptr) {
+			medvdbg("Need to get new PES packet!\n");
+			// get new PES packet
+			std::shared_ptr<PESPacket> pPESPacket = nullptr;
+			ret = getPESPacket(pPESPacket);
+			if (ret == DEMUXER_ERROR_WANT_DATA) {
+				medvdbg("Push more data to get PES packet\n");
+				return ret;
 			}
 
-			memcpy(&buf[fill], mPESParser->getESData() + mPESDataUsed, need);
-			mPESDataUsed += need;
-			fill += need;
-			medvdbg("Got ES data %u(%u)/%u\n", fill, need, size);
+			if (ret != DEMUXER_ERROR_NONE) {
+				meddbg("Get PES packet failed! error: %d\n", ret);
+				return ret;
+			}
 
-			if (mPESDataUsed == mPESParser->getESDataLen()) {
-				// all ES data in PES parser have been read.
-				medvdbg("All ES data (%u) in PES parser have been read!\n", mPESParser->getESDataLen());
-				mPESParser->reset();
-				mPESDataUsed = 0;
+			// parse PES packet
+			if (!mPESParser->parse(pPESPacket)) {
+				meddbg("PES parse failed!\n");
+				continue;
 			}
-			continue;
-		} else {
-			medvdbg("Need to get new PES packet!\n");
+			mPESDataUsed = 0;
 		}
 
-		// get new PES packet
-		std::shared_ptr<PESPacket> pPESPacket = nullptr;
-		ret = getPESPacket(pPESPacket);
-		if (ret == DEMUXER_ERROR_WANT_DATA) {
-			medvdbg("Push more data to get PES packet\n");
-			break;
+		// get remaining payload in the PES packet
+		size_t len = mPESParser->getESDataLen() - mPESDataUsed;
+		if (len > size) {
+			len = size;
 		}
-
-		if (ret != DEMUXER_ERROR_NONE) {
-			meddbg("Get PES packet failed! error: %d\n", ret);
-			break;
+		*buf = mPESParser->getESData() + mPESDataUsed;
+		mPESDataUsed += len;
+
+		if (mPESDataUsed == mPESParser->getESDataLen()) {
+			// all ES data in PES parser have been referred,
+			// they are kept in reassembly buffer until the next PES packet is loaded.
+			medvdbg("All ES data (%u) in PES parser have been read!\n", mPESParser->getESDataLen());
+			mPESParser->reset();
+			mPESDataUsed = 0;
 		}
 
-		// parse PES packet
-		if (mPESParser->parse(pPESPacket)) {
-			mPESDataUsed = 0;
-		} else {
-			meddbg("PES parse failed!\n");
-			continue;
+		if (len > 0) {
+			return (ssize_t)len;
 		}
-	} // end while
+	}
 
-	if (fill == 0) {
-		medvdbg("Got nothing, please check error: %d\n", ret);
-		return (ssize_t)ret;
+	return DEMUXER_ERROR_NONE;
+}
+
+int TSDemuxer::setupPESPid(void *param)
+{
+	if (mPESPid != INVALID_PID) {
+		return DEMUXER_ERROR_NONE;
 	}
 
-	return (ssize_t)fill;
+	prog_num_t progNum;
+	if (param) {
+		progNum = *((prog_num_t *)param);
+	} else {
+		// use default 1st program
+		std::vector<prog_num_t> programs;
+		mParserManager->getPrograms(programs);
+		progNum = programs[0];
+	}
+	uint8_t streamType;
+	if (!mParserManager->getAudioStreamInfo(progNum, streamType, mPESPid)) {
+		meddbg("get audio PES PID failed\n");
+		mPESPid = INVALID_PID;
+		return DEMUXER_ERROR_NOT_READY;
+	}
+	medvdbg("setup audio PES PID: 0x%x\n", mPESPid);
+	return DEMUXER_ERROR_NONE;
 }
 
 bool TSDemuxer::getPrograms(std::vector<prog_num_t> &progs)
@@ -335,45 +384,37 @@ std::shared_ptr<Section> TSDemuxer::PSIUnpack(std::shared_ptr<TSPacket> pTSPacke
 
 std::shared_ptr<PESPacket> TSDemuxer::PESUnpack(std::shared_ptr<TSPacket> pTSPacket)
 {
-	std::shared_ptr<PESPacket> pPESPacket = nullptr;
 	uint8_t  lenPayload = 0;
 	uint8_t *ptrPayload = pTSPacket->getPayloadData(&lenPayload);
 
 	if (!ptrPayload) {
 		// no payload
-		return pPESPacket;
+		return nullptr;
 	}
 
 	if (pTSPacket->payloadUnitStartIndicator()) {
-		// new PES packet start
+		// new PES packet start, incomplete PES packet in reassembly buffer would be dropped.
 		medvdbg("new PES packet (PID:%u) start...\n", pTSPacket->getPid());
-		auto newPacket = PESPacket::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
-		if (newPacket->isCompleted()) {
-			medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
-			pPESPacket = newPacket;
-		} else {
-			auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-			if (it != mPidPESPacketMap.end()) {
-				// incomplete PES packet with same PID exist, remove it!
-				mPidPESPacketMap.erase(it);
-			}
-			mPidPESPacketMap.insert(std::pair<uint16_t, std::shared_ptr<PESPacket>>(pTSPacket->getPid(), newPacket));
+		mPESPending = false;
+		if (!mPESPacket->initialize(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload)) {
+			meddbg("initialize PES packet failed!\n");
+			return nullptr;
 		}
-	} else {
+		mPESPending = true;
+	} else if (mPESPending) {
 		// PES packet appending
-		auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-		if (it != mPidPESPacketMap.end()) {
-			auto prePacket = it->second;
-			prePacket->appendData(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
-			if (prePacket->isCompleted()) {
-				medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
-				pPESPacket = prePacket;
-				mPidPESPacketMap.erase(it);
-			}
-		}
+		mPESPacket->appendData(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
+	} else {
+		return nullptr;
 	}
 
-	return pPESPacket;
+	if (mPESPacket->isCompleted()) {
+		medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
+		mPESPending = false;
+		return mPESPacket;
+	}
+
+	return nullptr;
 }
 
 bool TSDemuxer::isPsiPid(uint16_t pid)
@@ -431,13 +472,62 @@ int TSDemuxer::loadTSPacket(std::shared_ptr<TSPacket> pTSPacket, bool sync, size
 	return DEMUXER_ERROR_NONE;
 }
 
+// return demuxer_error_e
+int TSDemuxer::loadPacketPool(void)
+{
+	if (mPoolIndex < mPoolPackets) {
+		// there're packets not handled in pool
+		return DEMUXER_ERROR_NONE;
+	}
+
+	mPoolIndex = 0;
+	mPoolPackets = 0;
+
+	size_t size = mBufferReader->copy(mPacketPool, TS_PACKET_POOL_SLOTS * TSPacket::PACKET_SIZE);
+	size_t count = size / TSPacket::PACKET_SIZE;
+	if (count == 0) {
+		// data in buffer is not enough!
+		return DEMUXER_ERROR_WANT_DATA;
+	}
+
+	// only the leading packets in sync are taken into pool
+	size_t synced = 0;
+	while (synced < count && mPacketPool[synced * TSPacket::PACKET_SIZE] == TSPacket::SYNC_BYTE) {
+		synced++;
+	}
+
+	if (synced == 0) {
+		// resync and load one packet, it's not the usual case.
+		int ret = loadTSPacket(mTSPacket);
+		if (ret != DEMUXER_ERROR_NONE) {
+			return ret;
+		}
+		memcpy(mPacketPool, mTSPacket->getPacketBuffer(NULL), TSPacket::PACKET_SIZE);
+		synced = 1;
+	} else {
+		mBufferReader->read(NULL, synced * TSPacket::PACKET_SIZE, false);
+	}
+
+	mPoolPackets = synced;
+	return DEMUXER_ERROR_NONE;
+}
+
 // return demuxer_error_e
 int TSDemuxer::getPESPacket(std::shared_ptr<PESPacket> &pPESPacket)
 {
 	int ret;
 
-	while ((ret = loadTSPacket(mTSPacket)) == DEMUXER_ERROR_NONE) {
-		if (isPESPid(mTSPacket->getPid())) {
+	while ((ret = loadPacketPool()) == DEMUXER_ERROR_NONE) {
+		while (mPoolIndex < mPoolPackets) {
+			uint8_t *pSlot = mPacketPool + mPoolIndex * TSPacket::PACKET_SIZE;
+			mPoolIndex++;
+
+			// filter by PID in raw packet header, other packets are not parsed at all.
+			if (!isPESPid(TSPacket::peekPid(pSlot))) {
+				continue;
+			}
+
+			mTSPacket->parse(pSlot);
 			pPESPacket = PESUnpack(mTSPacket);
 			if (pPESPacket) {
 				medvdbg("got new PES packet\n");
@@ -61,6 +61,9 @@ public:
 	// pull audio elementary stream data of the given program number
 	// param, pointer to program nubmer of uint16, nullptr means first program as default
 	virtual ssize_t pullData(uint8_t *buf, size_t size, void *param = nullptr) override;
+	// pull audio elementary stream data of the given program number by reference,
+	// buf points to the payload in PES reassembly buffer, valid until the next pull
+	virtual ssize_t pullDataRef(uint8_t **buf, size_t size, void *param = nullptr) override;
 	// prepare TSDemuxer, preparse TS data in stream buffer to get program information ahead
 	virtual int prepare(void) override;
 	// check if TSDemuxer is ready (prepare succeed)
@@ -77,6 +80,14 @@ private:
 	bool isPsiPid(uint16_t pid);
 	// check if the given PID is PES packet's PID we need
 	bool isPESPid(uint16_t pid);
+	// setup PID of the audio PES packets of the given program number
+	// on success, return 0
+	// on failure, return negative value (see demuxer_error_e)
+	int setupPESPid(void *param);
+	// load TS packets from the input data stream into packet pool, if all packets in pool are handled
+	// on success, return 0
+	// on failure, return negative value (see demuxer_error_e)
+	int loadPacketPool(void);
 	// extract a PES packet from the input transport stream
 	// on success, return 0
 	// on failure, return negative value (see demuxer_error_e)
@@ -98,8 +109,16 @@ private:
 private:
 	// <pid, section_ptr> pairs in map to take incomplete sections
 	std::map<uint16_t, std::shared_ptr<Section>> mPidSectionMap;
-	// <pid, pespacket_ptr> pairs in map to take incomplete PES packets
-	std::map<uint16_t, std::shared_ptr<PESPacket>> mPidPESPacketMap;
+	// PES packet reassembly buffer, reused for each PES packet of mPESPid
+	std::shared_ptr<PESPacket> mPESPacket;
+	// PES packet in reassembly buffer is incomplete
+	bool mPESPending;
+	// pool of TS packet slots, TSPacket::PACKET_SIZE bytes each
+	uint8_t *mPacketPool;
+	// number of packets in pool
+	size_t mPoolPackets;
+	// index of the next packet in pool to be handled
+	size_t mPoolIndex;
 	// PSI table pasers manager
 	std::shared_ptr<ParserManager> mParserManager;
 	// stream buffer to held inputing TS stream data
@@ -102,7 +102,8 @@ bool TSPacket::AdaptationField::parse(const uint8_t *pData)
 }
 
 TSPacket::TSPacket()
-	: mSyncByte(0)
+	: mData(mBuffer)
+	, mSyncByte(0)
 	, mTransportErrorIndicator(0)
 	, mPayloadUnitStartIndicator(0)
 	, mTransportPriority(0)
@@ -117,6 +118,12 @@ TSPacket::~TSPacket()
 {
 }
 
+bool TSPacket::parse(uint8_t *pData)
+{
+	mData = pData;
+	return parse();
+}
+
 bool TSPacket::parse(void)
 {
 	const uint8_t *pData = mData;
@@ -147,6 +154,7 @@ uint8_t *TSPacket::getPacketBuffer(uint8_t *packetBuffLen)
 	if (packetBuffLen) {
 		*packetBuffLen = PACKET_SIZE;
 	}
+	mData = mBuffer;
 	return mData;
 }
 
@@ -69,6 +69,11 @@ public:
 	// parse transport packet stored in packet data buffer
 	// get packet buffer and put data in the buffer firstly
 	bool parse(void);
+	// parse transport packet stored in an external slot of PACKET_SIZE bytes,
+	// the slot is referred by the packet, so it must be kept until the packet is handled.
+	bool parse(uint8_t *pData);
+	// get PID from the raw packet header, without parsing the packet
+	static ts_pid_t peekPid(const uint8_t *pData) { return ((pData[1] << 8) | pData[2]) & INVALID_PID; }
 
 	// getters
 	ts_pid_t getPid(void) { return mPid; }
@@ -78,6 +83,7 @@ public:
 	uint8_t continuityCounter(void) { return mContinuityCounter; }
 	AdaptationField &adaptationField(void) { return mAdaptationField; }
 	// get pointer to the packet data buffer (188 bytes)
+	// packet refers to its own buffer again after calling this method
 	uint8_t *getPacketBuffer(uint8_t *packetBuffLen);
 	// get pointer to the payload data start address
 	// return nullptr if there's no payload
@@ -86,7 +92,9 @@ public:
 
 private:
 	// packet data array
-	uint8_t mData[PACKET_SIZE];
+	uint8_t mBuffer[PACKET_SIZE];
+	// packet data being parsed, mBuffer or an external slot
+	uint8_t *mData;
 	// sync byte
 	uint8_t mSyncByte;
 	// transport error indicator
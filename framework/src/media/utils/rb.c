@@ -155,6 +155,22 @@ size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset)
 	return len;
 }
 
+size_t rb_peek(rb_p rbp, const void **ptr, size_t offset)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+
+	size_t used = rb_used(rbp);
+	RETURN_VAL_IF_FAIL(offset < used, SIZE_ZERO);
+
+	size_t rd_idx = rbp->rd_idx;
+	_incr(rbp, &rd_idx, offset);
+	rd_idx = (rd_idx & IDX_MASK);
+
+	*ptr = (const void *)((const uint8_t *)rbp->buf + rd_idx);
+	return MINIMUM(used - offset, rbp->depth - rd_idx);
+}
+
 bool rb_reset(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, false);
@@ -102,6 +102,17 @@ size_t rb_read(rb_p rbp, void *ptr, size_t len);
  */
 size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset);
 
+/**
+ * @brief  Refer data in the ring-buffer at an offset position without copying,
+ *         rd_idx will not be increased.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Set to the data in the ring-buffer
+ * @param  offset: offset from rd_idx started to refer.
+ * @return size of data contiguous in the ring-buffer from 'ptr',
+ *         it's less than size of available data if the data wraps around.
+ */
+size_t rb_peek(rb_p rbp, const void **ptr, size_t offset);
+
 /**
  * @brief  Reset ring-buffer, data in ring-buffer will be dropped.
  * @param  rbp: Pointer to the ring-buffer object
@@ -95,6 +95,15 @@ size_t rbs_read(void *ptr, size_t size, size_t nmemb, rbstream_p rbsp)
 	return read;
 }
 
+size_t rbs_peek(const void **ptr, rbstream_p rbsp)
+{
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(rbsp != NULL, SIZE_ZERO);
+
+	size_t offset = rbsp->cur_pos - rbsp->rd_size;
+	return rb_peek(rbsp->rbp, ptr, offset);
+}
+
 size_t rbs_write(const void *ptr, size_t size, size_t nmemb, rbstream_p rbsp)
 {
 	medvdbg("[%s] ptr %p nmemb %lu\n", __FUNCTION__, ptr, nmemb);
@@ -117,6 +117,17 @@ size_t rbs_read(void *ptr, size_t size, size_t nmemb, rbstream_p stream);
  */
 size_t rbs_write(const void *ptr, size_t size, size_t nmemb, rbstream_p stream);
 
+/**
+ * @brief  Refers data from the position seeked by rbs_seek(_ext) without copying,
+ *         the current read position is not changed and no data is requested.
+ *
+ * @param  ptr : Set to the data in ring-buffer, it's valid until data is
+ *         popped out from ring-buffer.
+ * @param  stream : Pointer to the ring-buffer stream
+ * @return the number of bytes contiguous from 'ptr'.
+ */
+size_t rbs_peek(const void **ptr, rbstream_p stream);
+
 /**
  * @brief  Sets the current read position indicator (cur_pos) for the stream.
  *
@@ -75,9 +75,35 @@ bool SoftwareEndPointDetector::waitEndPoint(int timeout)
 	return ret == 0 ? true : false;
 }
 
+bool SoftwareEndPointDetector::isSilence(const short *frame)
+{
+#if CONFIG_MEDIA_VOICE_EPD_SILENCE_LEVEL > 0
+	/* Sum of squares of a frame whose RMS level is at the silence level */
+	const uint64_t limit = (uint64_t)CONFIG_MEDIA_VOICE_EPD_SILENCE_LEVEL * CONFIG_MEDIA_VOICE_EPD_SILENCE_LEVEL * CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE;
+	uint64_t energy = 0;
+
+	for (int i = 0; i < CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE; i++) {
+		int32_t s = frame[i];
+		energy += (uint32_t)(s * s);
+		if (energy >= limit) {
+			return false;
+		}
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 bool SoftwareEndPointDetector::detectEndPoint(short *sample, int numSample)
 {
 	for (short *ptr = sample; ptr <= sample + numSample - CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE; ptr += CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE) {
+		/* Frames quieter than the silence level can not hold speech, skip the preprocessor for them */
+		if (isSilence(ptr)) {
+			continue;
+		}
+
 		int vad = speex_preprocess_run(mState, ptr); // vad : 0 (no speech) or 1 (speech)
 		if (vad != 0) {
 			return false;
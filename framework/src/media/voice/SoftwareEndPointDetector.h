@@ -28,6 +28,10 @@
 #define CONFIG_VOICE_SOFTWARE_EPD_FRAMESIZE 256
 #endif
 
+#ifndef CONFIG_MEDIA_VOICE_EPD_SILENCE_LEVEL
+#define CONFIG_MEDIA_VOICE_EPD_SILENCE_LEVEL 0
+#endif
+
 #include <functional>
 #include <semaphore.h>
 
@@ -51,6 +55,8 @@ public:
 	bool waitEndPoint(int timeout) override;
 
 private:
+	bool isSilence(const short *frame);
+
 	SpeexPreprocessState *mState;
 	sem_t mSem;
 };
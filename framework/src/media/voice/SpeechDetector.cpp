@@ -18,7 +18,9 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <debug.h>
+#include <string.h>
 #include <functional>
+#include <mutex>
 
 #include "SoftwareKeywordDetector.h"
 #include "SoftwareEndPointDetector.h"
@@ -37,7 +39,7 @@ namespace voice {
 class SpeechDetectorImpl : public SpeechDetector
 {
 public:
-	SpeechDetectorImpl() = default;
+	SpeechDetectorImpl();
 	bool initKeywordDetect(uint32_t samprate, uint8_t channels) override;
 	bool initEndPointDetect(uint32_t samprate, uint8_t channels) override;
 	bool deinitKeywordDetect() override;
@@ -46,12 +48,31 @@ public:
 	bool startEndPointDetect(int timeout) override;
 	bool detectEndPoint(short *sample, int numSample) override;
 	bool waitEndPoint(int timeout) override;
+	bool initPreRoll(uint32_t samprate, uint8_t channels, uint32_t msec) override;
+	bool deinitPreRoll() override;
+	bool capturePreRoll(short *sample, int numSample) override;
+	int readPreRoll(short *sample, int numSample) override;
 
 private:
 	std::shared_ptr<KeywordDetector> mKeywordDetector;
 	std::shared_ptr<EndPointDetector> mEndPointDetector;
+
+	/* Pre-roll ring, captured and read from different threads */
+	std::mutex mPreRollMtx;
+	short *mPreRoll;
+	size_t mPreRollSize;
+	size_t mPreRollHead;
+	size_t mPreRollCount;
 };
 
+SpeechDetectorImpl::SpeechDetectorImpl() :
+	mPreRoll(nullptr),
+	mPreRollSize(0),
+	mPreRollHead(0),
+	mPreRollCount(0)
+{
+}
+
 SpeechDetector *SpeechDetector::instance()
 {
 	static SpeechDetectorImpl inst;
@@ -182,5 +203,118 @@ bool SpeechDetectorImpl::waitEndPoint(int timeout)
 	return mEndPointDetector->waitEndPoint(timeout);
 }
 
+bool SpeechDetectorImpl::initPreRoll(uint32_t samprate, uint8_t channels, uint32_t msec)
+{
+	if (samprate == 0 || channels == 0 || msec == 0) {
+		meddbg("%s[line : %d] fail : invalid parameter. samprate : %u, channels : %u, msec : %u\n", __func__, __LINE__, samprate, channels, msec);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mPreRollMtx);
+	if (mPreRoll) {
+		meddbg("PreRoll is already init\n");
+		return false;
+	}
+
+	size_t size = (size_t)((uint64_t)samprate * channels * msec / 1000);
+	if (size == 0) {
+		meddbg("PreRoll is too short, msec : %u\n", msec);
+		return false;
+	}
+
+	mPreRoll = new short[size];
+	if (!mPreRoll) {
+		meddbg("Out of memory! samples : %u\n", size);
+		return false;
+	}
+
+	mPreRollSize = size;
+	mPreRollHead = 0;
+	mPreRollCount = 0;
+	return true;
+}
+
+bool SpeechDetectorImpl::deinitPreRoll()
+{
+	std::lock_guard<std::mutex> lock(mPreRollMtx);
+	if (!mPreRoll) {
+		meddbg("Nothing to deinit\n");
+		return false;
+	}
+
+	delete[] mPreRoll;
+	mPreRoll = nullptr;
+	mPreRollSize = 0;
+	mPreRollHead = 0;
+	mPreRollCount = 0;
+	return true;
+}
+
+bool SpeechDetectorImpl::capturePreRoll(short *sample, int numSample)
+{
+	if (sample == nullptr || numSample <= 0) {
+		meddbg("invalid parameter. sample : %p, numSample : %d\n", sample, numSample);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mPreRollMtx);
+	if (!mPreRoll) {
+		meddbg("PreRoll is not init\n");
+		return false;
+	}
+
+	size_t count = (size_t)numSample;
+	if (count > mPreRollSize) {
+		/* Only the latest samples fit in the ring */
+		sample += count - mPreRollSize;
+		count = mPreRollSize;
+	}
+
+	size_t first = mPreRollSize - mPreRollHead;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(mPreRoll + mPreRollHead, sample, first * sizeof(short));
+	memcpy(mPreRoll, sample + first, (count - first) * sizeof(short));
+
+	mPreRollHead = (mPreRollHead + count) % mPreRollSize;
+	mPreRollCount += count;
+	if (mPreRollCount > mPreRollSize) {
+		mPreRollCount = mPreRollSize;
+	}
+
+	return true;
+}
+
+int SpeechDetectorImpl::readPreRoll(short *sample, int numSample)
+{
+	if (sample == nullptr || numSample <= 0) {
+		meddbg("invalid parameter. sample : %p, numSample : %d\n", sample, numSample);
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(mPreRollMtx);
+	if (!mPreRoll) {
+		meddbg("PreRoll is not init\n");
+		return 0;
+	}
+
+	size_t count = (size_t)numSample;
+	if (count > mPreRollCount) {
+		count = mPreRollCount;
+	}
+
+	size_t tail = (mPreRollHead + mPreRollSize - mPreRollCount) % mPreRollSize;
+	size_t first = mPreRollSize - tail;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(sample, mPreRoll + tail, first * sizeof(short));
+	memcpy(sample + first, mPreRoll, (count - first) * sizeof(short));
+
+	mPreRollCount -= count;
+	return (int)count;
+}
+
 } // namespace voice
 } // namespace media
@@ -133,6 +133,8 @@ struct pcm {
 	int prepared:1;
 	/** Whether the PCM is in draining state */
 	int draining:1;
+	/** Whether an underrun was seen while collecting dequeued buffers */
+	int xrun:1;
 	/** Size of the buffer */
 	unsigned int buffer_size;
 	/* Number of buffers */
@@ -163,6 +165,14 @@ struct pcm {
 	unsigned int next_offset;
 	/* Index of next buffer in ring for mmap operations */
 	unsigned int mmap_idx;
+	/* Ring of buffers dequeued by the kernel but not handed out yet */
+	struct ap_buffer_s **ready_bufs;
+	/* Index of the oldest buffer in the ready ring */
+	unsigned int ready_head;
+	/* Number of buffers in the ready ring */
+	unsigned int ready_cnt;
+	/* Playback buffer lent to the caller by pcm_writei_begin */
+	struct ap_buffer_s *lent_buf;
 };
 
 int pcm_start(struct pcm *pcm);
@@ -463,6 +473,175 @@ static int pcm_mmap_transfer_areas(struct pcm *pcm, char *buf, unsigned int offs
 	return count;
 }
 
+static void pcm_ready_reset(struct pcm *pcm)
+{
+	pcm->ready_head = 0;
+	pcm->ready_cnt = 0;
+	pcm->xrun = 0;
+}
+
+/* Get the next buffer given back by the kernel. One wakeup collects every
+ * buffer already waiting on the message queue, so the following calls are
+ * served from the ready ring without another mq_receive.
+ * Returns -EAGAIN if block is zero and no buffer is available.
+ */
+static int pcm_dequeue_buffer(struct pcm *pcm, int block, struct ap_buffer_s **apb)
+{
+	struct audio_msg_s msg;
+	struct mq_attr attr;
+	struct timespec st_time;
+	unsigned int size;
+	int prio;
+
+	if (pcm->ready_cnt > 0) {
+		*apb = pcm->ready_bufs[pcm->ready_head];
+		pcm->ready_head = (pcm->ready_head + 1) % pcm->buffer_cnt;
+		pcm->ready_cnt--;
+		return 0;
+	}
+
+	/* An underrun is reported only after the buffers dequeued before it */
+	if (pcm->xrun) {
+		pcm->xrun = 0;
+		return -EPIPE;
+	}
+
+	if (block) {
+		size = mq_receive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio);
+	} else {
+		clock_gettime(CLOCK_REALTIME, &st_time);
+		size = mq_timedreceive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio, &st_time);
+	}
+
+	if (size != sizeof(msg)) {
+		if (!block) {
+			return -EAGAIN;
+		}
+		/* Interrupted by a signal? What to do? */
+		return oops(pcm, EINTR, "Interrupted while waiting for deque message from kernel\n");
+	}
+
+	if (msg.msgId == AUDIO_MSG_XRUN) {
+		/* Underrun to be handled by client */
+		return -EPIPE;
+	} else if (msg.msgId != AUDIO_MSG_DEQUEUE) {
+		return oops(pcm, EINTR, "Recieved unexpected msg (id = %d) while waiting for deque message from kernel\n", msg.msgId);
+	}
+
+	*apb = (struct ap_buffer_s *)msg.u.pPtr;
+
+	/* Collect the other buffers the kernel has already given back */
+	if (mq_getattr(pcm->mq, &attr) == 0) {
+		while (attr.mq_curmsgs-- > 0 && pcm->ready_cnt < pcm->buffer_cnt) {
+			size = mq_receive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio);
+			if (size != sizeof(msg)) {
+				break;
+			}
+			if (msg.msgId == AUDIO_MSG_DEQUEUE) {
+				pcm->ready_bufs[(pcm->ready_head + pcm->ready_cnt) % pcm->buffer_cnt] = (struct ap_buffer_s *)msg.u.pPtr;
+				pcm->ready_cnt++;
+			} else if (msg.msgId == AUDIO_MSG_XRUN) {
+				pcm->xrun = 1;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/** Lends the next free playback buffer to the caller.
+ * The caller renders up to @p frames frames straight into @p buffer and
+ * hands it to the driver with @ref pcm_writei_commit, which avoids the copy
+ * done by @ref pcm_writei. Calling this again before the commit returns the
+ * same buffer.
+ * This function is only valid for PCMs opened with the @ref PCM_OUT flag.
+ * @param pcm A PCM handle.
+ * @param buffer Returned pointer to the sample memory of the buffer.
+ * @param frames Number of frames wanted, reduced to the buffer capacity.
+ * @return On success, zero; otherwise, a negative number.
+ * @ingroup libtinyalsa-pcm
+ */
+int pcm_writei_begin(struct pcm *pcm, void **buffer, unsigned int *frames)
+{
+	struct ap_buffer_s *apb;
+	int ret;
+
+	if (pcm == NULL || buffer == NULL || frames == NULL) {
+		return -EINVAL;
+	}
+
+	if (!(pcm->flags & PCM_OUT)) {
+		return -EINVAL;
+	}
+
+	if (pcm->lent_buf == NULL) {
+		if (pcm->buf_idx < pcm->buffer_cnt) {
+			/* If we have empty buffers, use them first */
+			apb = pcm->pBuffers[pcm->buf_idx];
+			pcm->buf_idx++;
+		} else {
+			/* We dont have any empty buffers. wait for the kernel to return one */
+			ret = pcm_dequeue_buffer(pcm, 1, &apb);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+		pcm->lent_buf = apb;
+	}
+
+	*buffer = pcm->lent_buf->samp;
+	if (*frames > pcm->buffer_size) {
+		*frames = pcm->buffer_size;
+	}
+
+	return 0;
+}
+
+/** Enqueues the buffer lent by @ref pcm_writei_begin.
+ * If the PCM has not been started, it is started in this function.
+ * Committing zero frames keeps the buffer lent to the caller.
+ * @param pcm A PCM handle.
+ * @param frames The number of frames written into the buffer.
+ * @return On success, the number of frames committed; otherwise, a negative number.
+ * @ingroup libtinyalsa-pcm
+ */
+int pcm_writei_commit(struct pcm *pcm, unsigned int frames)
+{
+	struct audio_buf_desc_s bufdesc;
+	struct ap_buffer_s *apb;
+
+	if (pcm == NULL || pcm->lent_buf == NULL || frames > pcm->buffer_size) {
+		return -EINVAL;
+	}
+
+	if (frames == 0) {
+		return 0;
+	}
+
+	/* Buffer is ready. Enque it */
+	apb = pcm->lent_buf;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+	bufdesc.session = pcm->session;
+#endif
+	apb->nbytes = pcm_frames_to_bytes(pcm, frames);
+	apb->curbyte = 0;
+	apb->flags = 0;
+	bufdesc.numbytes = apb->nbytes;
+	bufdesc.u.pBuffer = apb;
+	if (ioctl(pcm->fd, AUDIOIOC_ENQUEUEBUFFER, (unsigned long)&bufdesc) < 0) {
+		return oops(pcm, errno, "AUDIOIOC_ENQUEUEBUFFER ioctl failed\n");
+	}
+	pcm->lent_buf = NULL;
+
+	/* If playback is not already started, start now! */
+	if ((!pcm->running) && (pcm_start(pcm) < 0)) {
+		return -errno;
+	}
+
+	return frames;
+}
+
 /** Writes audio samples to PCM.
  * If the PCM has not been started, it is started in this function.
  * This function is only valid for PCMs opened with the @ref PCM_OUT flag.
@@ -475,12 +654,9 @@ static int pcm_mmap_transfer_areas(struct pcm *pcm, char *buf, unsigned int offs
  */
 int pcm_writei(struct pcm *pcm, const void *data, unsigned int frame_count)
 {
-	unsigned int nbytes = 0, pending = 0, offset = 0;
-	struct audio_buf_desc_s bufdesc;
-	struct ap_buffer_s *apb;
-	struct audio_msg_s msg;
-	unsigned int size;
-	int prio;
+	unsigned int frames = 0, pending = 0, offset = 0;
+	void *buffer;
+	int ret;
 
 	if (pcm == NULL || data == NULL || frame_count == 0) {
 		return -EINVAL;
@@ -494,57 +670,135 @@ int pcm_writei(struct pcm *pcm, const void *data, unsigned int frame_count)
 		return -EINVAL;
 	}
 
-	pending = pcm_frames_to_bytes(pcm, frame_count);
+	pending = frame_count;
 
 	while (pending > 0) {
-		nbytes = pending > pcm_frames_to_bytes(pcm, pcm->buffer_size) ? pcm_frames_to_bytes(pcm, pcm->buffer_size) : pending;
-		if (pcm->buf_idx < pcm->buffer_cnt) {
-			/* If we have empty buffers, fill them first */
-			memcpy(pcm->pBuffers[pcm->buf_idx]->samp, (char *)data + offset, nbytes);
-			apb = pcm->pBuffers[pcm->buf_idx];
-			pcm->buf_idx++;
-		} else {
-			/* We dont have any empty buffers. wait for deque message from kernel */
-			size = mq_receive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio);
-			if (size != sizeof(msg)) {
-				/* Interrupted by a signal? What to do? */
-				return oops(pcm, EINTR, "Interrupted while waiting for deque message from kernel\n");
-			}
-			if (msg.msgId == AUDIO_MSG_DEQUEUE) {
-				apb = (struct ap_buffer_s *)msg.u.pPtr;
-				memcpy(apb->samp, (char *)data + offset, nbytes);
-			} else if (msg.msgId == AUDIO_MSG_XRUN) {
-				/* Underrun to be handled by client */
-				return -EPIPE;
-			} else {
-				return oops(pcm, EINTR, "Recieved unexpected msg (id = %d) while waiting for deque message from kernel\n", msg.msgId);
-			}
+		frames = pending;
+		ret = pcm_writei_begin(pcm, &buffer, &frames);
+		if (ret < 0) {
+			return ret;
+		}
+
+		memcpy(buffer, (char *)data + pcm_frames_to_bytes(pcm, offset), pcm_frames_to_bytes(pcm, frames));
+
+		ret = pcm_writei_commit(pcm, frames);
+		if (ret < 0) {
+			return ret;
+		}
+
+		offset += frames;
+		pending -= frames;
+	}
+
+	return frames;
+}
+
+/** Lends the recorded data of the next filled capture buffer to the caller.
+ * The caller consumes up to @p frames frames straight from @p buffer and
+ * reports how many it used with @ref pcm_readi_commit, which avoids the
+ * copy done by @ref pcm_readi.
+ * If the PCM has not been started, it is started in this function.
+ * This function is only valid for PCMs opened with the @ref PCM_IN flag.
+ * @param pcm A PCM handle.
+ * @param buffer Returned pointer to the recorded samples.
+ * @param frames Number of frames wanted, reduced to the frames available.
+ *  Zero is returned once a drained PCM has no recorded data left.
+ * @return On success, zero; otherwise, a negative number.
+ * @ingroup libtinyalsa-pcm
+ */
+int pcm_readi_begin(struct pcm *pcm, void **buffer, unsigned int *frames)
+{
+	struct ap_buffer_s *apb;
+	unsigned int avail;
+	int ret;
+
+	if (pcm == NULL || buffer == NULL || frames == NULL) {
+		return -EINVAL;
+	}
+
+	if (!(pcm->flags & PCM_IN)) {
+		return -EINVAL;
+	}
+
+	/* If device is not yet started, start now! */
+	if ((!pcm->draining) && (!pcm->running) && (pcm_start(pcm) < 0)) {
+		return -errno;
+	}
+
+	if (pcm->next_buf == NULL) {
+		/* When we are in draining state, we only take buffers already
+		   returned by the kernel and do not wait for new ones */
+		ret = pcm_dequeue_buffer(pcm, !pcm->draining, &apb);
+		if (ret == -EAGAIN) {
+			pcm->draining = 0;
+			*frames = 0;
+			return 0;
+		} else if (ret < 0) {
+			return ret;
 		}
 
-		/* Buffer is ready. Enque it */
+		pcm->next_buf = apb;
+		pcm->next_offset = 0;
+		pcm->next_size = apb->nbytes;
+	}
+
+	*buffer = pcm->next_buf->samp + pcm->next_offset;
+	avail = pcm_bytes_to_frames(pcm, pcm->next_size);
+	if (*frames > avail) {
+		*frames = avail;
+	}
+
+	return 0;
+}
+
+/** Consumes frames lent by @ref pcm_readi_begin.
+ * Once all data of the buffer has been consumed, it is enqueued again.
+ * @param pcm A PCM handle.
+ * @param frames The number of frames the caller has used.
+ * @return On success, the number of frames consumed; otherwise, a negative number.
+ * @ingroup libtinyalsa-pcm
+ */
+int pcm_readi_commit(struct pcm *pcm, unsigned int frames)
+{
+	struct audio_buf_desc_s bufdesc;
+	struct ap_buffer_s *apb;
+	unsigned int nbytes;
+
+	if (pcm == NULL || pcm->next_buf == NULL) {
+		return -EINVAL;
+	}
+
+	nbytes = pcm_frames_to_bytes(pcm, frames);
+	if (nbytes > pcm->next_size) {
+		return -EINVAL;
+	}
+
+	pcm->next_offset += nbytes;
+	pcm->next_size -= nbytes;
+	if (pcm->next_size > 0) {
+		return frames;
+	}
+
+	apb = pcm->next_buf;
+	pcm->next_buf = NULL;
+	pcm->next_offset = 0;
+
+	/* Dont enque the buffer if we are draining, the pcm has already been stopped */
+	if (!pcm->draining) {
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 		bufdesc.session = pcm->session;
 #endif
-		apb->nbytes = nbytes;
+		bufdesc.numbytes = pcm_frames_to_bytes(pcm, pcm->buffer_size);
+		apb->nbytes = 0;
 		apb->curbyte = 0;
 		apb->flags = 0;
-		bufdesc.numbytes = apb->nbytes;
 		bufdesc.u.pBuffer = apb;
 		if (ioctl(pcm->fd, AUDIOIOC_ENQUEUEBUFFER, (unsigned long)&bufdesc) < 0) {
-			return oops(pcm, errno, "AUDIOIOC_ENQUEUEBUFFER ioctl failed\n");
-		}
-		/* If playback is not already started, start now! */
-		if ((!pcm->running) && (pcm_start(pcm) < 0)) {
-			return -errno;
-		} else {
-			pcm->running = 1;
+			return oops(pcm, errno, "failed to enque buffer after read\n");
 		}
-
-		offset += nbytes;
-		pending -= nbytes;
 	}
 
-	return pcm_bytes_to_frames(pcm, nbytes);
+	return frames;
 }
 
 /** Reads audio samples from PCM.
@@ -559,13 +813,9 @@ int pcm_writei(struct pcm *pcm, const void *data, unsigned int frame_count)
  */
 int pcm_readi(struct pcm *pcm, void *data, unsigned int frame_count)
 {
-	int nbytes = 0, pending = 0, offset = 0;
-	struct audio_buf_desc_s bufdesc;
-	struct ap_buffer_s *apb;
-	struct audio_msg_s msg;
-	unsigned int size;
-	int prio;
-	struct timespec st_time;
+	unsigned int frames, pending, offset = 0;
+	void *buffer;
+	int ret;
 
 	if (pcm == NULL || data == NULL || frame_count == 0) {
 		return -EINVAL;
@@ -579,117 +829,32 @@ int pcm_readi(struct pcm *pcm, void *data, unsigned int frame_count)
 		return -EINVAL;
 	}
 
-	pending = pcm_frames_to_bytes(pcm, frame_count);
-
-	bufdesc.numbytes = pcm_frames_to_bytes(pcm, (pcm->buffer_size));
-
-#ifdef CONFIG_AUDIO_MULTI_SESSION
-	bufdesc.session = pcm->session;
-#endif
-
-	/* If device is not yet started, start now! */
-	if ((!pcm->draining) && (!pcm->running) && (pcm_start(pcm) < 0)) {
-		return -errno;
-	}
+	pending = frame_count;
 
 	while (pending > 0) {
+		frames = pending;
+		ret = pcm_readi_begin(pcm, &buffer, &frames);
+		if (ret < 0) {
+			return ret;
+		}
 
-		/* Read data */
-		if (pcm->next_buf != NULL) {
-			/* We have a pending buffer with some data in it. */
-			apb = pcm->next_buf;
-			if (pending <= pcm->next_size) {
-				/* User wants less data than we have in buffer.
-				   Copy the requested amount of data to user buffer and return */
-				memcpy((char *)data + offset, apb->samp + pcm->next_offset, pending);
-				pcm->next_size -= pending;
-				pcm->next_offset += pending;
-
-				nbytes = pending;
-			} else {
-				/* User wants more data than we have in buffer.
-				   Copy available data to user buffer, enqueue buffer and return */
-				memcpy((char *)data + offset, apb->samp + pcm->next_offset, pcm->next_size);
-
-				nbytes = pcm->next_size;
-				pcm->next_size = 0;
-				pcm->next_offset = 0;
-				pcm->next_buf = NULL;
-
-				apb->nbytes = 0;
-				apb->curbyte = 0;
-				apb->flags = 0;
-				bufdesc.u.pBuffer = apb;
-				if (ioctl(pcm->fd, AUDIOIOC_ENQUEUEBUFFER, (unsigned long)&bufdesc) < 0) {
-					return oops(pcm, errno, "failed to enque buffer after read\n");
-				}
-			}
+		if (pcm->next_buf == NULL) {
+			/* Drained and no recorded data left */
+			break;
+		}
 
-		} else {
-			/* We got here because we dont have any pending buffers */
-			/* Wait for deque message from kernel */
-			if (pcm->draining) {
-				/* When we are in draining state, we will check for buffers already in the msg queue
-				   If there is no buffer on the queue, we return immediately */
-				clock_gettime(CLOCK_REALTIME, &st_time);
-				size = mq_timedreceive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio, &st_time);
-				if (size != sizeof(msg)) {
-					pcm->draining = 0;
-					pcm->next_size = 0;
-					pcm->next_offset = 0;
-					pcm->next_buf = NULL;
-					return pcm_frames_to_bytes(pcm, frame_count) - pending;
-				}
-			} else {
-				size = mq_receive(pcm->mq, (FAR char *)&msg, sizeof(msg), &prio);
-				if (size != sizeof(msg)) {
-					/* Interrupted by a signal? What to do? */
-					return oops(pcm, EINTR, "Interrupted while waiting for deque message from kernel\n");
-				}
-			}
-			if (msg.msgId == AUDIO_MSG_DEQUEUE) {
-				apb = (struct ap_buffer_s *)msg.u.pPtr;
-				if (pending <= apb->nbytes) {
-					/* User wants less data than we have in buffer.
-					   Copy the requested amount of data and keep the buffer as pending buffer */
-					memcpy((char *)data + offset, apb->samp, pending);
-
-					pcm->next_buf = apb;
-					pcm->next_offset = pending;
-					pcm->next_size = apb->nbytes - pending;
-
-					nbytes = pending;
-				} else {
-					/* User wants more data than we have in buffer.
-					   Copy available data to user buffer, enqueue buffer and return */
-					memcpy((char *)data + offset, apb->samp, apb->nbytes);
-					nbytes = apb->nbytes;
-
-					if (!pcm->draining) {
-						/* Dont enque the buffer since we are draining and
-						   the pcm has already been stopped */
-						apb->nbytes = 0;
-						apb->curbyte = 0;
-						apb->flags = 0;
-						bufdesc.u.pBuffer = apb;
-						if (ioctl(pcm->fd, AUDIOIOC_ENQUEUEBUFFER, (unsigned long)&bufdesc) < 0) {
-							return oops(pcm, errno, "failed to enque buffer after read\n");
-						}
-					}
-				}
-			} else if (msg.msgId == AUDIO_MSG_XRUN) {
-				/* Underrun to be handled by client */
-				return -EPIPE;
-			} else {
-				return oops(pcm, EINTR, "Recieved unexpected msg (id = %d) while waiting for deque message from kernel\n", msg.msgId);
-			}
+		memcpy((char *)data + pcm_frames_to_bytes(pcm, offset), buffer, pcm_frames_to_bytes(pcm, frames));
+
+		ret = pcm_readi_commit(pcm, frames);
+		if (ret < 0) {
+			return ret;
 		}
 
-		offset += nbytes;
-		pending -= nbytes;
+		offset += frames;
+		pending -= frames;
 	}
 
-	return pcm_bytes_to_frames(pcm, pcm_frames_to_bytes(pcm, frame_count) - pending);
+	return offset;
 }
 
 /** Writes audio samples to PCM.
@@ -891,12 +1056,13 @@ struct pcm *pcm_open(unsigned int card, unsigned int device, unsigned int flags,
 		goto fail_after_mq;
 	}
 	
-	/* Create array of pointers to buffers */
-	pcm->pBuffers = (FAR struct ap_buffer_s **)malloc(pcm->buffer_cnt * sizeof(FAR void *));
+	/* Create array of pointers to buffers, followed by the ready ring */
+	pcm->pBuffers = (FAR struct ap_buffer_s **)malloc(2 * pcm->buffer_cnt * sizeof(FAR void *));
 	if (pcm->pBuffers == NULL) {
 		/* Error allocating memory for buffer storage! */
 		goto fail_after_mq;
 	}
+	pcm->ready_bufs = pcm->pBuffers + pcm->buffer_cnt;
 
 	/* Create our audio pipeline buffers to use for queueing up data */
 
@@ -930,6 +1096,8 @@ struct pcm *pcm_open(unsigned int card, unsigned int device, unsigned int flags,
 	pcm->next_offset = 0;
 	pcm->next_buf = NULL;
 	pcm->mmap_idx = 0;
+	pcm->lent_buf = NULL;
+	pcm_ready_reset(pcm);
 
 	return pcm;
 
@@ -1062,6 +1230,12 @@ int pcm_start(struct pcm *pcm)
 			} while (size > 0);
 		}
 
+		/* All buffers go back to the driver, forget any we were holding */
+		pcm_ready_reset(pcm);
+		pcm->next_size = 0;
+		pcm->next_offset = 0;
+		pcm->next_buf = NULL;
+
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 		bufdesc.session = pcm->session;
 #endif
@@ -1137,6 +1311,8 @@ int pcm_stop(struct pcm *pcm)
 	pcm->next_offset = 0;
 	pcm->next_buf = NULL;
 	pcm->mmap_idx = 0;
+	pcm->lent_buf = NULL;
+	pcm_ready_reset(pcm);
 
 	return 0;
 }
@@ -1172,6 +1348,11 @@ int pcm_drain(struct pcm *pcm)
 		int prio;
 
 		/* Playback case */
+		/* Buffers in the ready ring or lent to the caller are not with the kernel */
+		pcm->buf_idx -= pcm->ready_cnt + (pcm->lent_buf != NULL);
+		pcm->lent_buf = NULL;
+		pcm_ready_reset(pcm);
+
 		/* Wait for all enqueued buffers to get dequeued. */
 		while (pcm->buf_idx > 0) {
 			/* Wait for deque message from kernel */
@@ -65,6 +65,11 @@
 #include <tinyara/fs/ioctl.h>
 #endif
 
+#ifdef CONFIG_AUDIO_NULL
+#include <tinyara/audio/audio.h>
+#include <tinyara/audio/audio_null.h>
+#endif
+
 #include "up_arch.h"
 #include "up_internal.h"
 #include "lm3s6965ek_internal.h"
@@ -77,6 +82,34 @@
  * Private Functions
  ************************************************************************************/
 
+#if defined(CONFIG_BOARD_INITIALIZE) && (defined(CONFIG_QEMU_SRAM) || defined(CONFIG_QEMU_SDRAM)) && defined(CONFIG_AUDIO_NULL)
+/************************************************************************************
+ * Name: qemu_audio_null_initialize
+ *
+ * Description:
+ *   QEMU has no audio hardware. Register the null audio device as the playback
+ *   card so that the media framework can run on QEMU.
+ *
+ ************************************************************************************/
+
+static void qemu_audio_null_initialize(void)
+{
+	FAR struct audio_lowerhalf_s *dev;
+	int ret;
+
+	dev = audio_null_initialize();
+	if (!dev) {
+		lldbg("ERROR: failed to initialize the null audio device\n");
+		return;
+	}
+
+	ret = audio_register("pcmC0D0p", dev);
+	if (ret < 0) {
+		lldbg("ERROR: failed to register the null audio device, ret = %d\n", ret);
+	}
+}
+#endif
+
 /************************************************************************************
  * Public Functions
  ************************************************************************************/
@@ -146,6 +179,12 @@ int board_initialize(void)
 	int partoffset = QEMU_SMARTFS_PARTITION_START;
 	int partsize = QEMU_SMARTFS_PARTITION_SIZE;
 
+#ifdef CONFIG_AUDIO_NULL
+	/* Register the audio device first, the flash setup below may bail out */
+
+	qemu_audio_null_initialize();
+#endif
+
 #ifdef CONFIG_MTD
 	mtd = up_flashinitialize();
 
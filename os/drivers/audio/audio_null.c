@@ -80,6 +80,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_AUDIO_NULL_BUFFER_DELAY
+#define CONFIG_AUDIO_NULL_BUFFER_DELAY 20
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -885,7 +889,9 @@ static int null_enqueuebuffer(FAR struct audio_lowerhalf_s *dev, FAR struct ap_b
 #else
 	priv->dev.upper(priv->dev.priv, AUDIO_CALLBACK_DEQUEUE, apb, OK);
 #endif
-	usleep(20 * 1000); //20ms as a delay, assuming that i2s operations
+#if CONFIG_AUDIO_NULL_BUFFER_DELAY > 0
+	usleep(CONFIG_AUDIO_NULL_BUFFER_DELAY * 1000);	/* time the i2s transfer would take */
+#endif
 
 	/* Say we are done playing if this was the last buffer in the stream */
 
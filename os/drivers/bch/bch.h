@@ -68,21 +68,39 @@
  ****************************************************************************/
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
+#define bchlib_markdirty(d)	((d)->slots[(d)->current].dirty = true)
+
+/* Number of sectors held in the sector cache */
+#if CONFIG_BCH_CACHE_SIZE > 0
+#define BCH_CACHE_NSLOTS(s)	((CONFIG_BCH_CACHE_SIZE / (s)) > 0 ? (CONFIG_BCH_CACHE_SIZE / (s)) : 1)
+#else
+#define BCH_CACHE_NSLOTS(s)	1
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+struct bch_slot_s {
+	size_t sector;				/* The sector held in this slot */
+	uint32_t stamp;				/* Last access time, for LRU replacement */
+	bool dirty;					/* true: Data has been written to the slot */
+};
+
 struct bchlib_s {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
 	size_t nsectors;			/* Number of sectors supported by the device */
-	size_t sector;				/* The current sector in the buffer */
+	size_t lastsector;			/* The last sector accessed, for read-ahead */
 	sem_t sem;					/* For atomic accesses to this structure */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	FAR uint8_t *buffer;		/* The current sector in the cache */
+	FAR uint8_t *cache;			/* Sector cache, nslots sectors */
+	FAR struct bch_slot_s *slots;	/* Description of each cached sector */
+	uint32_t stamp;				/* Access counter for LRU replacement */
+	int nslots;					/* Number of sectors in the cache */
+	int current;				/* The slot of the current sector */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -108,6 +126,8 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors);
+EXTERN void bchlib_mergedirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer, size_t sector, size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
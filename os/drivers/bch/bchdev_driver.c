@@ -331,6 +331,12 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 		bchlib_semgive(bch);
 	}
+	/* Is this a request to write back the sector cache? */
+	else if (cmd == BIOC_FLUSH) {
+		bchlib_semtake(bch);
+		ret = bchlib_flushsector(bch);
+		bchlib_semgive(bch);
+	}
 #ifdef CONFIG_BCH_ENCRYPTION
 	/* Is this a request to set the encryption key? */
 	else if (cmd == DIOC_SETKEY) {
@@ -57,6 +57,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -67,6 +68,12 @@
 #  include <crypto/crypto.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define BCH_NOSECTOR		((size_t)-1)
+#define bchlib_slotbuf(b, i)	(&(b)->cache[(size_t)(i) * (b)->sectsize])
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -88,16 +95,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data, size_t sector, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)data;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -115,61 +122,201 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bchlib_findslot
+ *
+ * Description:
+ *   Return the cache slot holding 'sector' or -1 if it is not cached.
+ *
  ****************************************************************************/
+static int bchlib_findslot(FAR struct bchlib_s *bch, size_t sector)
+{
+	int i;
+
+	for (i = 0; i < bch->nslots; i++) {
+		if (bch->slots[i].sector == sector) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_victim
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Return the least recently used cache slot.  Empty slots are used first.
  *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ ****************************************************************************/
+static int bchlib_victim(FAR struct bchlib_s *bch)
+{
+	int victim = 0;
+	int i;
+
+	for (i = 0; i < bch->nslots; i++) {
+		if (bch->slots[i].sector == BCH_NOSECTOR) {
+			return i;
+		}
+
+		if ((int32_t)(bch->slots[i].stamp - bch->slots[victim].stamp) < 0) {
+			victim = i;
+		}
+	}
+
+	return victim;
+}
+
+/****************************************************************************
+ * Name: bchlib_writeslot
+ *
+ * Description:
+ *   Write one cache slot back to the media if it is dirty.
  *
  ****************************************************************************/
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bchlib_writeslot(FAR struct bchlib_s *bch, int slot)
 {
-	FAR struct inode *inode;
+	FAR struct bch_slot_s *entry = &bch->slots[slot];
+	FAR struct inode *inode = bch->inode;
+	FAR uint8_t *data;
 	ssize_t ret = OK;
 
-	/*
-	 * Check if the sector has been modified and is out of sync with the
-	 * media.
-	 */
-	if (bch->dirty) {
-		inode = bch->inode;
+	if (!entry->dirty) {
+		return OK;
+	}
+
+	data = bchlib_slotbuf(bch, slot);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+	/* Encrypt data as necessary */
+	bch_cypher(bch, data, entry->sector, CYPHER_ENCRYPT);
+#endif
+
+	/* Write the sector to the media */
+	ret = inode->u.i_bops->write(inode, data, entry->sector, 1);
+	if (ret < 0) {
+		fdbg("Write failed: %d\n", ret);
+	}
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
+	/*
+	 * Computation overhead to save memory for extra sector buffer
+	 * TODO: Add configuration switch for extra sector buffer
+	 */
+	bch_cypher(bch, data, entry->sector, CYPHER_DECRYPT);
 #endif
 
-		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-		if (ret < 0) {
-			fdbg("Write failed: %d\n");
+	/* The sector is now in sync with the media */
+	entry->dirty = false;
+	return (int)ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_readahead
+ *
+ * Description:
+ *   Fill 'slot', the victim chosen for 'sector', and the slots that follow
+ *   it with 'sector' and the sectors after it using a single read from the
+ *   block driver.  The run only extends over a slot if it is the one that
+ *   bchlib_victim() would evict next, so read-ahead never displaces a more
+ *   recently used sector than a normal miss would.  The run also stops at
+ *   the end of the media or at the first sector that is already cached.
+ *   Returns the number of sectors read or a negated errno value.
+ *
+ ****************************************************************************/
+static ssize_t bchlib_readahead(FAR struct bchlib_s *bch, int slot, size_t sector)
+{
+	FAR struct inode *inode = bch->inode;
+	ssize_t ret;
+	int count;
+	int next;
+	int max;
+	int i;
+
+	max = bch->nslots / 2;
+	if (max < 1) {
+		max = 1;
+	}
+
+	if ((size_t)max > bch->nsectors - sector) {
+		max = bch->nsectors - sector;
+	}
+
+	/* Claim the slots of the run as they are selected so that the next
+	 * victim is chosen among the remaining ones.
+	 */
+	(void)bchlib_writeslot(bch, slot);
+	bch->slots[slot].sector = sector;
+	bch->slots[slot].stamp  = bch->stamp;
+
+	for (count = 1; count < max; count++) {
+		if (bchlib_findslot(bch, sector + count) >= 0) {
+			break;
 		}
 
+		next = bchlib_victim(bch);
+		if (next != slot + count) {
+			break;
+		}
+
+		(void)bchlib_writeslot(bch, next);
+		bch->slots[next].sector = sector + count;
+		bch->slots[next].stamp  = bch->stamp;
+	}
+
+	ret = inode->u.i_bops->read(inode, bchlib_slotbuf(bch, slot), sector, count);
+	if (ret < 0) {
+		fdbg("Read failed: %d\n", ret);
+		for (i = slot; i < slot + count; i++) {
+			bch->slots[i].sector = BCH_NOSECTOR;
+		}
+		return ret;
+	}
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-		/*
-		 * Computation overhead to save memory for extra sector buffer
-		 * TODO: Add configuration switch for extra sector buffer
-		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
+	for (i = 0; i < count; i++) {
+		bch_cypher(bch, bchlib_slotbuf(bch, slot + i), sector + i, CYPHER_DECRYPT);
+	}
 #endif
 
-		/* The sector is now in sync with the media */
-		bch->dirty = false;
+	return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush every dirty sector in the sector cache to the media
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+	int ret = OK;
+	int err;
+	int i;
+
+	for (i = 0; i < bch->nslots; i++) {
+		err = bchlib_writeslot(bch, i);
+		if (err < 0) {
+			ret = err;
+		}
 	}
 
-	return (int)ret;
+	return ret;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make 'sector' the current sector, bch->buffer, reading it into the
+ *   sector cache if it is not already cached.  On a sequential miss, the
+ *   following sectors are read ahead into the cache as well.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -179,22 +326,86 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
 	FAR struct inode *inode;
 	ssize_t ret = OK;
+	int slot;
 
-	if (bch->sector != sector) {
-		inode = bch->inode;
+	bch->stamp++;
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+	slot = bchlib_findslot(bch, sector);
+	if (slot < 0) {
+		slot = bchlib_victim(bch);
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-		if (ret < 0) {
-			fdbg("Read failed: %d\n");
-		}
-		bch->sector = sector;
+		if (bch->nslots > 1 && sector == bch->lastsector + 1) {
+			ret = bchlib_readahead(bch, slot, sector);
+		} else {
+			inode = bch->inode;
+
+			(void)bchlib_writeslot(bch, slot);
+			bch->slots[slot].sector = BCH_NOSECTOR;
+
+			ret = inode->u.i_bops->read(inode, bchlib_slotbuf(bch, slot), sector, 1);
+			if (ret < 0) {
+				fdbg("Read failed: %d\n", ret);
+			} else {
+				bch->slots[slot].sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+				bch_cypher(bch, bchlib_slotbuf(bch, slot), sector, CYPHER_DECRYPT);
 #endif
+			}
+		}
 	}
+
+	bch->slots[slot].stamp = bch->stamp;
+	bch->current    = slot;
+	bch->buffer     = bchlib_slotbuf(bch, slot);
+	bch->lastsector = sector;
 	return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Drop any cached copy of the sectors [sector, sector + nsectors).  Used
+ *   when the sectors are about to be overwritten directly on the media, so
+ *   dirty copies are discarded rather than written back.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	int i;
+
+	for (i = 0; i < bch->nslots; i++) {
+		if (bch->slots[i].sector != BCH_NOSECTOR && bch->slots[i].sector >= sector &&
+			bch->slots[i].sector < sector + nsectors) {
+			bch->slots[i].sector = BCH_NOSECTOR;
+			bch->slots[i].dirty  = false;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: bchlib_mergedirty
+ *
+ * Description:
+ *   Copy the dirty cached sectors that fall in [sector, sector + nsectors)
+ *   over 'buffer', which was just read directly from the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_mergedirty(FAR struct bchlib_s *bch, FAR uint8_t *buffer, size_t sector, size_t nsectors)
+{
+	int i;
+
+	for (i = 0; i < bch->nslots; i++) {
+		if (bch->slots[i].dirty && bch->slots[i].sector >= sector &&
+			bch->slots[i].sector < sector + nsectors) {
+			memcpy(&buffer[(bch->slots[i].sector - sector) * bch->sectsize],
+				   bchlib_slotbuf(bch, i), bch->sectsize);
+		}
+	}
+}
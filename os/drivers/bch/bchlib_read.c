@@ -161,6 +161,9 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 			return ret;
 		}
 
+		/* Cached sectors not yet written back are newer than the media */
+		bchlib_mergedirty(bch, (FAR uint8_t *)buffer, sector, nsectors);
+
 		/* Adjust pointers and counts */
 		sector    += nsectors;
 		nbytes     = nsectors * bch->sectsize;
@@ -87,6 +87,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	FAR struct bchlib_s *bch;
 	struct geometry geo;
 	int ret;
+	int i;
 
 	DEBUGASSERT(blkdev);
 
@@ -128,20 +129,38 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	sem_init(&bch->sem, 0, 1);
 	bch->nsectors = geo.geo_nsectors;
 	bch->sectsize = geo.geo_sectorsize;
-	bch->sector   = (size_t)-1;
+	bch->lastsector = (size_t)-1;
 	bch->readonly = readonly;
+	bch->nslots   = BCH_CACHE_NSLOTS(bch->sectsize);
 
-	/* Allocate the sector I/O buffer */
-	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
-	if (!bch->buffer) {
+	/* Allocate the sector cache */
+	bch->cache = (FAR uint8_t *)kmm_malloc(bch->nslots * bch->sectsize);
+	if (!bch->cache) {
 		fdbg("ERROR: Failed to allocate sector buffer\n");
 		ret = -ENOMEM;
 		goto errout_with_bch;
 	}
 
+	bch->slots = (FAR struct bch_slot_s *)kmm_malloc(bch->nslots * sizeof(struct bch_slot_s));
+	if (!bch->slots) {
+		fdbg("ERROR: Failed to allocate sector cache\n");
+		ret = -ENOMEM;
+		goto errout_with_cache;
+	}
+
+	for (i = 0; i < bch->nslots; i++) {
+		bch->slots[i].sector = (size_t)-1;
+		bch->slots[i].stamp  = 0;
+		bch->slots[i].dirty  = false;
+	}
+
+	bch->buffer = bch->cache;
+
 	*handle = bch;
 	return OK;
 
+errout_with_cache:
+	kmm_free(bch->cache);
 errout_with_bch:
 	kmm_free(bch);
 	return ret;
@@ -94,8 +94,12 @@ int bchlib_teardown(FAR void *handle)
 	(void)close_blockdriver(bch->inode);
 
 	/* Free the BCH state structure */
-	if (bch->buffer) {
-		kmm_free(bch->buffer);
+	if (bch->cache) {
+		kmm_free(bch->cache);
+	}
+
+	if (bch->slots) {
+		kmm_free(bch->slots);
 	}
 
 	sem_destroy(&bch->sem);
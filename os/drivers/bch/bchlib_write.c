@@ -117,7 +117,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 		}
 
 		memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-		bch->dirty = true;
+		bchlib_markdirty(bch);
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -141,6 +141,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nsectors = bch->nsectors - sector;
 		}
 
+		/* Drop any cached copy of the sectors being overwritten */
+		bchlib_invalidate(bch, sector, nsectors);
+
 		/* Write the contiguous sectors */
 		ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
 				sector, nsectors);
@@ -169,18 +172,20 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 
 		/* Copy the head end of the sector from the user buffer */
 		memcpy(bch->buffer, buffer, len);
-		bch->dirty = true;
+		bchlib_markdirty(bch);
 
 		/* Adjust counts */
 		byteswritten += len;
 	}
 
+#ifndef CONFIG_BCH_WRITEBACK
 	/* Finally, flush any cached writes to the device as well */
 	ret = bchlib_flushsector(bch);
 	if (ret < 0) {
 		fdbg("ERROR: Flush failed: %d\n", ret);
 		return ret;
 	}
+#endif
 
 	return byteswritten;
 }
@@ -73,12 +73,17 @@
 #include <crc16.h>
 #include <crc32.h>
 #include <tinyara/math.h>
+#include <tinyara/clock.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart_procfs.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_MTD_SMART_BGGC
+#include <semaphore.h>
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Private Definitions
@@ -118,6 +123,35 @@
 #define SMART_SECTSIZE_8192       0x14
 #define SMART_SECTSIZE_16384      0x18
 
+/* Free sector bitmap.  A set bit means the physical sector may still be
+ * free; a clear bit means it is known to be in use until its erase block is
+ * erased again.  The bitmap is only a hint and is always verified against
+ * the sector header on the media.
+ */
+
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+#define SMART_FREEMAP_TEST(d, s)  ((d)->freemap[(s) >> 3] & (1 << ((s) & 0x07)))
+#define SMART_FREEMAP_CLR(d, s)   ((d)->freemap[(s) >> 3] &= ~(1 << ((s) & 0x07)))
+#define SMART_FREEMAP_SIZE(d)     (((uint32_t)(d)->neraseblocks * (d)->sectorsPerBlk + 7) >> 3)
+#endif
+
+/* Background garbage collection only bothers with blocks at least half
+ * full of released sectors, so that idle time erases pay for themselves.
+ */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#define SMART_BGGC_MINRELEASE(d)  ((d)->availSectPerBlk >> 1)
+#endif
+
+/* Packed sector map.  Small volumes store 12-bit entries with 0xFFF as the
+ * "not mapped" marker; larger ones store plain 16-bit entries.
+ */
+
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+#define SMART_PACKMAP12_UNUSED    0x0FFF
+#define SMART_PACKMAP_SIZE(d)     ((d)->packmap12 ? (((uint32_t)(d)->totalsectors * 3) >> 1) + 2 : (uint32_t)(d)->totalsectors << 1)
+#endif
+
 #define SMART_FMT_STAT_UNKNOWN    0
 #define SMART_FMT_STAT_FORMATTED  1
 #define SMART_FMT_STAT_NOFMT      2
@@ -304,7 +338,12 @@ struct smart_struct_s {
 	uint16_t cache_lastlog;			/* Keep track of the last sector accessed */
 	uint16_t cache_lastphys;		/* Keep the physical sector number also */
 	uint16_t cache_nextbirth;		/* Sector cache aging value */
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	FAR uint8_t *sPackMap;			/* Packed full logical to physical map */
+	bool packmap12;				/* Map entries are 12 bits wide */
+#endif
 #endif
+	uint32_t scantime;		/* Duration of the last scan in msec */
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	FAR uint8_t *erasecounts;	/* Number of erases for each erase block */
 #endif
@@ -318,6 +357,13 @@ struct smart_struct_s {
 	uint16_t njournaleraseblocks;		/* Total Number of Journal Erase block */
 	uint32_t njournalentries;		/* Total Number of Journal Entries */
 #endif
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	FAR uint8_t *freemap;			/* Physical sectors that may still be free */
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+	sem_t exclsem;				/* Serializes access with the background GC */
+	struct work_s gcwork;			/* Background garbage collection work */
+#endif
 };
 
 #define SMART_WEARFLAGS_FORCE_REORG    0x01
@@ -453,6 +499,9 @@ static int smart_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
 
 static uint16_t smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t canrelocate);
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_gc_worker(FAR void *arg);
+#endif
 
 #ifdef CONFIG_FS_WRITABLE
 static int smart_writesector(FAR struct smart_struct_s *dev, unsigned long arg);
@@ -463,6 +512,7 @@ static int smart_allocsector(FAR struct smart_struct_s *dev, unsigned long reque
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+static int smart_write_wearstatus(struct smart_struct_s *dev);
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t block, uint8_t forceerase);
@@ -747,6 +797,62 @@ static void smart_add_count(struct smart_struct_s *dev, uint8_t *pCount, uint16_
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_freemap_setblock
+ *
+ * Description: Mark every sector of a freshly erased block as possibly free
+ *              in the free sector bitmap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+static void smart_freemap_setblock(FAR struct smart_struct_s *dev, uint16_t block)
+{
+	uint32_t sector;
+	uint32_t end;
+
+	if (dev->freemap == NULL) {
+		return;
+	}
+
+	end = (uint32_t)(block + 1) * dev->sectorsPerBlk;
+	for (sector = (uint32_t)block * dev->sectorsPerBlk; sector < end; sector++) {
+		dev->freemap[sector >> 3] |= 1 << (sector & 0x07);
+	}
+}
+#else
+#define smart_freemap_setblock(dev, block)
+#endif
+
+/****************************************************************************
+ * Name: smart_semtake / smart_semgive
+ *
+ * Description: Serialize the block driver entry points with the background
+ *              garbage collector.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+	while (sem_wait(&dev->exclsem) != OK) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+static void smart_semgive(FAR struct smart_struct_s *dev)
+{
+	sem_post(&dev->exclsem);
+}
+#else
+#define smart_semtake(dev)
+#define smart_semgive(dev)
+#endif
+
 /****************************************************************************
  * Name: smart_checkfree
  *
@@ -885,6 +991,7 @@ static ssize_t smart_reload(struct smart_struct_s *dev, FAR uint8_t *buffer, off
 static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t start_sector, unsigned int nsectors)
 {
 	struct smart_struct_s *dev;
+	ssize_t ret;
 
 	fvdbg("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -894,7 +1001,10 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer, size_t
 #else
 	dev = (struct smart_struct_s *)inode->i_private;
 #endif
-	return smart_reload(dev, buffer, start_sector, nsectors);
+	smart_semtake(dev);
+	ret = smart_reload(dev, buffer, start_sector, nsectors);
+	smart_semgive(dev);
+	return ret;
 }
 
 /****************************************************************************
@@ -929,7 +1039,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-	/* I think maybe we need to lock on a mutex here. */
+	smart_semtake(dev);
 
 	/* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
 	 * per erase block is a power of 2, and (2) the erase begins with that same
@@ -966,11 +1076,11 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 			ret = MTD_ERASE(dev->mtd, eraseblock, 1);
 			if (ret < 0) {
 				fdbg("Erase block=%d failed: %d\n", eraseblock, ret);
-
-				/* Unlock the mutex if we add one. */
-
+				smart_semgive(dev);
 				return ret;
 			}
+
+			smart_freemap_setblock(dev, eraseblock);
 		}
 
 		/* Calculate the number of blocks to write. */
@@ -992,9 +1102,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 			/* The block is not empty!!  What to do? */
 
 			fdbg("Write block %d failed: %d.\n", nextblock, nxfrd);
-
-			/* Unlock the mutex if we add one. */
-
+			smart_semgive(dev);
 			return -EIO;
 		}
 
@@ -1006,6 +1114,7 @@ static ssize_t smart_write(FAR struct inode *inode, FAR const unsigned char *buf
 		alignedblock += mtdBlksPerErase;
 	}
 
+	smart_semgive(dev);
 	return nsectors;
 }
 #endif							/* CONFIG_FS_WRITABLE */
@@ -1158,6 +1267,12 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		smart_free(dev, dev->sBitMap);
 		dev->sBitMap = NULL;
 	}
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	if (dev->sPackMap != NULL) {
+		smart_free(dev, dev->sPackMap);
+		dev->sPackMap = NULL;
+	}
+#endif
 
 	dev->cache_entries = 0;
 	dev->cache_lastlog = 0xFFFF;
@@ -1178,6 +1293,12 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		dev->wearstatus = NULL;
 	}
 #endif
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	if (dev->freemap != NULL) {
+		smart_free(dev, dev->freemap);
+		dev->freemap = NULL;
+	}
+#endif
 
 	/* Allocate a virtual to physical sector map buffer.  Also allocate
 	 * the storage space for releasecount and freecounts.
@@ -1217,6 +1338,19 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		goto errexit;
 	}
 
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	/* Allocate the packed sector map.  12-bit entries are enough as long
+	 * as 0xFFF is not a valid physical sector number.
+	 */
+
+	dev->packmap12 = (totalsectors < SMART_PACKMAP12_UNUSED);
+	dev->sPackMap = (FAR uint8_t *)smart_malloc(dev, SMART_PACKMAP_SIZE(dev), "Packed map");
+	if (dev->sPackMap == NULL) {
+		fdbg("Error allocating SMART packed sector map\n");
+		goto errexit;
+	}
+#endif
+
 	/* Calculate the alloc size of the freesector and release sector arrays. */
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
@@ -1289,6 +1423,20 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	dev->uneven_wearcount = 0;
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	/* Allocate the free sector bitmap.  Everything starts out as possibly
+	 * free and is narrowed down as sectors are probed.
+	 */
+
+	dev->freemap = (FAR uint8_t *)smart_malloc(dev, SMART_FREEMAP_SIZE(dev), "Free bitmap");
+	if (!dev->freemap) {
+		fdbg("Error allocating SMART free sector bitmap\n");
+		goto errexit;
+	}
+
+	memset(dev->freemap, 0xFF, SMART_FREEMAP_SIZE(dev));
+#endif
+
 	/* Allocate a read/write buffer. */
 
 	dev->rwbuffer = (FAR char *)smart_malloc(dev, size, "RW Buffer");
@@ -1319,6 +1467,11 @@ errexit:
 	if (dev->sBitMap) {
 		smart_free(dev, dev->sBitMap);
 	}
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	if (dev->sPackMap) {
+		smart_free(dev, dev->sPackMap);
+	}
+#endif
 
 	if (dev->sCache) {
 		smart_free(dev, dev->sCache);
@@ -1337,6 +1490,12 @@ errexit:
 	}
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	if (dev->freemap) {
+		smart_free(dev, dev->freemap);
+	}
+#endif
+
 	kmm_free(dev);
 	return -ENOMEM;
 }
@@ -1405,6 +1564,72 @@ static ssize_t smart_bytewrite(FAR struct smart_struct_s *dev, size_t offset, in
 	return ret;
 }
 
+/****************************************************************************
+ * Name: smart_packmap_get
+ *
+ * Description: Returns the physical sector for a logical sector from the
+ *              packed sector map, or 0xFFFF if it is not mapped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+static uint16_t smart_packmap_get(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	FAR uint8_t *entry;
+	uint16_t physical;
+
+	if (!dev->packmap12) {
+		entry = &dev->sPackMap[logical << 1];
+		return entry[0] | (entry[1] << 8);
+	}
+
+	/* Two 12-bit entries share three bytes. */
+
+	entry = &dev->sPackMap[(logical * 3) >> 1];
+	if (logical & 0x01) {
+		physical = (entry[0] >> 4) | (entry[1] << 4);
+	} else {
+		physical = entry[0] | ((entry[1] & 0x0F) << 8);
+	}
+
+	if (physical == SMART_PACKMAP12_UNUSED) {
+		physical = 0xFFFF;
+	}
+
+	return physical;
+}
+
+/****************************************************************************
+ * Name: smart_packmap_set
+ *
+ * Description: Stores the physical sector for a logical sector in the
+ *              packed sector map.  0xFFFF removes the mapping.
+ *
+ ****************************************************************************/
+
+static void smart_packmap_set(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+{
+	FAR uint8_t *entry;
+
+	if (!dev->packmap12) {
+		entry = &dev->sPackMap[logical << 1];
+		entry[0] = physical & 0xFF;
+		entry[1] = physical >> 8;
+		return;
+	}
+
+	physical &= SMART_PACKMAP12_UNUSED;
+	entry = &dev->sPackMap[(logical * 3) >> 1];
+	if (logical & 0x01) {
+		entry[0] = (entry[0] & 0x0F) | ((physical & 0x0F) << 4);
+		entry[1] = physical >> 4;
+	} else {
+		entry[0] = physical & 0xFF;
+		entry[1] = (entry[1] & 0xF0) | (physical >> 8);
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1424,6 +1649,15 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev, uint16_t lo
 	uint16_t index, x;
 	uint16_t oldest;
 
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	/* With the packed map every sector is mapped; the cache is not used. */
+
+	if (dev->sPackMap != NULL) {
+		smart_packmap_set(dev, logical, physical);
+		return 0;
+	}
+#endif
+
 	/* If we aren't full yet, just add the sector to the end of the list. */
 
 	index = 1;
@@ -1494,6 +1728,12 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 	struct smart_sect_header_s header;
 	size_t readaddress;
 
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	if (dev->sPackMap != NULL) {
+		return smart_packmap_get(dev, logical);
+	}
+#endif
+
 	physical = 0xFFFF;
 
 	/* Test if searching for the last sector used. */
@@ -1601,6 +1841,13 @@ static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t logical,
 {
 	uint16_t x;
 
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	if (dev->sPackMap != NULL) {
+		smart_packmap_set(dev, logical, physical);
+		return;
+	}
+#endif
+
 	/* Scan through all cache entries and find the logical sector entry */
 
 	for (x = 0; x < dev->cache_entries; x++) {
@@ -1832,6 +2079,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	uint16_t seqwrap;
 	struct smart_sect_header_s header;
 	bool status_released, status_committed;
+	clock_t start;
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
 	int dupsector;
 	uint16_t duplogsector;
@@ -1845,6 +2093,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	// ToDo: Revert to the flexible logic that searches sectors and
 	//       reads sector sizes stored in the sectors instead of
 	//		 using CONFIG_MTD_SMART_SECTOR_SIZE.
+	start = clock_systimer();
 	ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
 	if (ret != OK) {
 		goto err_out;
@@ -1857,6 +2106,9 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	dev->formatstatus = SMART_FMT_STAT_NOFMT;
 	dev->freesectors = dev->availSectPerBlk * dev->neraseblocks;
 	dev->releasesectors = 0;
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	memset(dev->freemap, 0xFF, SMART_FREEMAP_SIZE(dev));
+#endif
 
 	/* Initialize the freecount and releasecount arrays. */
 
@@ -1886,6 +2138,11 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	/* Clear all logical sector used bits. */
 
 	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	/* All ones is the "not mapped" value for both entry sizes. */
+
+	memset(dev->sPackMap, 0xFF, SMART_PACKMAP_SIZE(dev));
+#endif
 #endif
 
 	/* Now scan the MTD device. */
@@ -2185,6 +2442,11 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		/* Mark the logical sector as used in the bitmap */
 		dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
 
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+		if (dev->sPackMap != NULL) {
+			smart_packmap_set(dev, logicalsector, winner);
+		} else
+#endif
 		if (logicalsector < SMART_FIRST_ALLOC_SECTOR) {
 			smart_add_sector_to_cache(dev, logicalsector, winner, __LINE__);
 		}
@@ -2261,12 +2523,20 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 	smart_read_wearstatus(dev);
 #endif
 
+	/* Record how long the scan took so mount time can be compared across
+	 * partition sizes and map modes.
+	 */
+
+	dev->scantime = TICK2MSEC(clock_systimer() - start);
+
 	fdbg("SMART Scan\n");
 	fdbg("   Erase size:           %10d\n", dev->sectorsPerBlk * dev->sectorsize);
 	fdbg("   Erase block:          %10d\n", dev->geo.neraseblocks);
 	fdbg("   Sect/block:           %10d\n", dev->sectorsPerBlk);
 	fdbg("   MTD Blk/Sect:         %10d\n", dev->mtdBlksPerSector);
 	fdbg("   avail sect/block:     %10d\n", dev->availSectPerBlk);
+	fdbg("   Total sectors:        %10d\n", dev->totalsectors);
+	fdbg("   Scan time (msec):     %10d\n", dev->scantime);
 #ifdef CONFIG_MTD_SMART_JOURNALING
 	fdbg("   Data Erase block:     %10d\n", dev->neraseblocks);
 	fdbg("   Journal Erase block:  %10d\n", dev->njournaleraseblocks);
@@ -2391,6 +2661,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t
 			return;
 		}
 
+		smart_freemap_setblock(dev, block);
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 		if (dev->erasecounts) {
@@ -2788,6 +3059,9 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 	if (ret < 0) {
 		return ret;
 	}
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	memset(dev->freemap, 0xFF, SMART_FREEMAP_SIZE(dev));
+#endif
 
 	/* Now construct a logical sector zero header to write to the device. */
 
@@ -2919,6 +3193,9 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 		dev->sMap[x] = -1;
 	}
+#elif defined(CONFIG_MTD_SMART_PACKED_MAP)
+	memset(dev->sPackMap, 0xFF, SMART_PACKMAP_SIZE(dev));
+	smart_packmap_set(dev, 0, 0);
 #endif
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -3231,6 +3508,8 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 		dev->freecount[block] = 0;
 		return ret;
 	}
+
+	smart_freemap_setblock(dev, block);
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	dev->unusedsectors += freecount;
 	dev->blockerases++;
@@ -3323,6 +3602,9 @@ static uint16_t smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t
 	uint32_t readaddr;
 	struct smart_sect_header_s header;
 	int ret;
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	int pass;
+#endif
 	/* Determine which erase block we should allocate the new
 	 * sector from. This is based on the number of free sectors
 	 * available in each erase block. */
@@ -3449,7 +3731,20 @@ retry:
 	/* Now find a free physical sector within this selected
 	 * erase block to allocate. */
 
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	/* Only probe the sectors the bitmap still reports as possibly free.  If
+	 * none of them turns out to be free, probe the whole block as before.
+	 */
+
+	for (pass = 0; pass < 2 && physicalsector == 0xFFFF; pass++)
+#endif
 	for (x = allocblock * dev->sectorsPerBlk; x < allocblock * dev->sectorsPerBlk + dev->availSectPerBlk; x++) {
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+		if (pass == 0 && !SMART_FREEMAP_TEST(dev, x)) {
+			continue;
+		}
+#endif
+
 		/* Check if this physical sector is available. */
 
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
@@ -3483,6 +3778,14 @@ retry:
 			fdbg("Error reading phys sector %d\n", physicalsector);
 			return -1;
 		}
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+
+		/* The sector is either in use or about to be handed out.  Either
+		 * way it need not be probed again until its block is erased.
+		 */
+
+		SMART_FREEMAP_CLR(dev, x);
+#endif
 		if ((UINT8TOUINT16(header.logicalsector) == 0xFFFF) &&
 #if SMART_STATUS_VERSION == 1
 			((header.seq == 0xFF) && (header.crc8 == 0xFF)) &&
@@ -3516,16 +3819,55 @@ retry:
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
-static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+
+/****************************************************************************
+ * Name: smart_gc_victim
+ *
+ * Description:  Return the erase block with the most released sectors (the
+ *               cheapest one to collect) and its released sector count, or
+ *               0xFFFF if no block has released sectors.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_gc_victim(FAR struct smart_struct_s *dev, FAR uint16_t *released)
 {
 	uint16_t collectblock;
 	uint16_t releasemax;
-	bool collect = TRUE;
+	uint16_t count;
 	int x;
-	int ret;
+
+	collectblock = 0xFFFF;
+	releasemax = 0;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		/* Don't collect blocks that have been worn completely. */
+
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
+			continue;
+		}
+#endif
+
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
-	uint8_t count;
+		count = smart_get_count(dev, dev->releasecount, x);
+#else
+		count = dev->releasecount[x];
 #endif
+		if (count > releasemax) {
+			releasemax = count;
+			collectblock = x;
+		}
+	}
+
+	*released = releasemax;
+	return collectblock;
+}
+
+static int smart_garbagecollect(FAR struct smart_struct_s *dev)
+{
+	uint16_t collectblock;
+	uint16_t releasemax;
+	bool collect = TRUE;
+	int ret;
 
 	while (collect) {
 		collect = FALSE;
@@ -3549,31 +3891,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (collect) {
 			/* Find the block with the most released sectors. */
 
-			collectblock = 0xFFFF;
-			releasemax = 0;
-			for (x = 0; x < dev->neraseblocks; x++) {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-				/* Don't collect blocks that have been worn completely. */
-
-				if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
-					continue;
-				}
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-				count = smart_get_count(dev, dev->releasecount, x);
-				if (count > releasemax) {
-					releasemax = count;
-					collectblock = x;
-				}
-#else
-				if (dev->releasecount[x] > releasemax) {
-					releasemax = dev->releasecount[x];
-					collectblock = x;
-				}
-#endif
-			}
-			//releasemax = smart_get_count(dev, dev->releasecount, collectblock);
+			collectblock = smart_gc_victim(dev, &releasemax);
 
 			if (collectblock == 0xFFFF) {
 				/* Need to collect, but no sectors with released blocks! */
@@ -3613,6 +3931,49 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Background garbage collection.  Runs periodically on the low
+ *               priority work queue and, while free sectors are below the
+ *               configured threshold, collects one worthwhile block per run
+ *               so the write path rarely has to collect synchronously.  If
+ *               the device is busy the run is skipped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static void smart_gc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	uint16_t collectblock;
+	uint16_t released;
+	int ret;
+
+	if (sem_trywait(&dev->exclsem) == OK) {
+		if (dev->formatstatus == SMART_FMT_STAT_FORMATTED && (uint32_t)dev->freesectors * 100 < (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_BGGC_FREE_PERCENT) {
+			collectblock = smart_gc_victim(dev, &released);
+			if (collectblock != 0xFFFF && released >= SMART_BGGC_MINRELEASE(dev)) {
+				fvdbg("Background collect block %d, released=%d free=%d\n", collectblock, released, dev->freesectors);
+				ret = smart_relocate_block(dev, collectblock);
+				if (ret != OK) {
+					fdbg("Background collection of block %d failed: %d\n", collectblock, ret);
+				}
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+				if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+					smart_write_wearstatus(dev);
+				}
+#endif
+			}
+		}
+
+		smart_semgive(dev);
+	}
+
+	work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_BGGC_INTERVAL));
+}
+#endif
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -4748,6 +5109,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+	smart_semtake(dev);
+
 	/* Process the ioctl's we care about first, pass any we don't respond
 	 * to directly to the underlying MTD device.
 	 */
@@ -4762,7 +5125,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_DEBUG
 		if (arg == 0) {
 			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #endif
 
@@ -4835,7 +5199,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	case BIOC_FIBMAP:
 
 		if ((uint16_t)arg >= dev->totalsectors) {
-			return -EINVAL;
+			ret = -EINVAL;
+			goto ok_out;
 		}
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 		ret = (int)dev->sMap[(uint16_t)arg];
@@ -4859,6 +5224,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		procfs_data->unusedsectors = dev->unusedsectors;
 		procfs_data->blockerases = dev->blockerases;
 		procfs_data->sectorsperblk = dev->sectorsPerBlk;
+		procfs_data->scantime = dev->scantime;
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 		procfs_data->formatsector = dev->sMap[0];
@@ -4919,6 +5285,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+	smart_semgive(dev);
 	return ret;
 }
 
@@ -5760,9 +6127,13 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #else
 		dev->sCache = NULL;
 		dev->sBitMap = NULL;
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+		dev->sPackMap = NULL;
+#endif
 #endif
 		dev->rwbuffer = NULL;
 		dev->bytebuffer = NULL;
+		dev->scantime = 0;
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 		dev->erasecounts = NULL;
 #endif
@@ -5771,6 +6142,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 		dev->allocsector = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+		dev->freemap = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_BGGC
+		sem_init(&dev->exclsem, 0, 1);
 #endif
 		dev->sectorsize = 0;
 		ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
@@ -5864,6 +6241,13 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #endif
 		/* Do a scan of the device. */
 		smart_scan(dev);
+
+#ifdef CONFIG_MTD_SMART_BGGC
+		/* Start background garbage collection */
+
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, MSEC2TICK(CONFIG_MTD_SMART_BGGC_INTERVAL));
+#endif
 	}
 
 	return OK;
@@ -5876,6 +6260,11 @@ errout:
 #else
 	smart_free(dev, dev->sBitMap);
 	smart_free(dev, dev->sCache);
+#ifdef CONFIG_MTD_SMART_PACKED_MAP
+	if (dev->sPackMap != NULL) {
+		smart_free(dev, dev->sPackMap);
+	}
+#endif
 #endif
 	if (dev->rwbuffer != NULL) {
 		smart_free(dev, dev->rwbuffer);
@@ -5892,6 +6281,11 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_FREE_BITMAP
+	if (dev->freemap != NULL) {
+		smart_free(dev, dev->freemap);
+	}
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 	if (rootdirdev) {
 		smart_free(dev, rootdirdev);
@@ -288,6 +288,29 @@ FAR struct inode *inode_search(FAR const char **path, FAR struct inode **peer, F
 	FAR struct inode *node = root_inode;
 	FAR struct inode *left = NULL;
 	FAR struct inode *above = NULL;
+#if CONFIG_FS_INODE_CACHE_SIZE > 0
+	FAR const char *start = *path;
+	FAR const char *rest;
+	size_t len;
+
+	/* A plain lookup does not need the companion nodes, so it may be
+	 * answered from the path cache.
+	 */
+
+	if (!peer && !parent) {
+		node = inode_cache_lookup(start, &rest);
+		if (node) {
+			if (relpath) {
+				*relpath = rest;
+			}
+
+			*path = rest;
+			return node;
+		}
+
+		node = root_inode;
+	}
+#endif
 
 	while (node) {
 		int result = _inode_compare(name, node);
@@ -367,6 +390,21 @@ FAR struct inode *inode_search(FAR const char **path, FAR struct inode **peer, F
 		*parent = above;
 	}
 
+#if CONFIG_FS_INODE_CACHE_SIZE > 0
+	/* Remember the path of the node found.  For a mountpoint, remember
+	 * only the path of the mountpoint itself, without the delimiter.
+	 */
+
+	if (node && !peer && !parent) {
+		len = name - start;
+		if (*name != '\0' && len > 0 && start[len - 1] == '/') {
+			len--;
+		}
+
+		inode_cache_add(start, len, node);
+	}
+#endif
+
 	*path = name;
 	return node;
 }
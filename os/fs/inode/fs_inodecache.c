@@ -0,0 +1,206 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <tinyara/fs/fs.h>
+
+#include "inode/inode.h"
+
+#if CONFIG_FS_INODE_CACHE_SIZE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of '/' delimited prefixes of one path that are probed */
+
+#define INODE_CACHE_MAXDEPTH 8
+
+/* FNV-1a hash */
+
+#define INODE_CACHE_HASHINIT  2166136261u
+#define INODE_CACHE_HASH(h, c) (((h) ^ (uint8_t)(c)) * 16777619u)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached path.  The entry maps either a full path to its inode or, for
+ * a mountpoint, the path of the mountpoint so that every path below it
+ * resolves with the same entry.
+ */
+
+struct inode_cache_s {
+	FAR struct inode *node;		/* The inode, NULL if the entry is empty */
+	uint32_t hash;				/* Hash of the cached path */
+	uint8_t len;				/* Length of the cached path */
+	char path[CONFIG_FS_INODE_CACHE_PATHLEN];	/* The cached path (not terminated) */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look 'path' up in the path cache.  The full path is tried first, then
+ *   each shorter '/' delimited prefix that may name a mountpoint.
+ *
+ * Returned Value:
+ *   The inode, with the remainder of the path below a mountpoint returned
+ *   in 'relpath', or NULL if the path is not cached.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_cache_lookup(FAR const char *path, FAR const char **relpath)
+{
+	FAR struct inode_cache_s *entry;
+	uint32_t hashes[INODE_CACHE_MAXDEPTH + 1];
+	uint8_t lens[INODE_CACHE_MAXDEPTH + 1];
+	uint32_t hash = INODE_CACHE_HASHINIT;
+	int nprefix = 0;
+	int i;
+
+	/* Hash the path once, remembering the hash of each prefix that ends
+	 * just before a '/' delimiter.
+	 */
+
+	for (i = 0; path[i] != '\0'; i++) {
+		if (i >= CONFIG_FS_INODE_CACHE_PATHLEN) {
+			return NULL;
+		}
+
+		if (path[i] == '/' && i > 0 && nprefix < INODE_CACHE_MAXDEPTH) {
+			hashes[nprefix] = hash;
+			lens[nprefix++] = i;
+		}
+
+		hash = INODE_CACHE_HASH(hash, path[i]);
+	}
+
+	hashes[nprefix] = hash;
+	lens[nprefix]   = i;
+
+	/* Probe the longest match first */
+
+	for (i = nprefix; i >= 0; i--) {
+		entry = &g_inode_cache[hashes[i] % CONFIG_FS_INODE_CACHE_SIZE];
+		if (entry->node == NULL || entry->hash != hashes[i] || entry->len != lens[i] ||
+			memcmp(entry->path, path, lens[i]) != 0) {
+			continue;
+		}
+
+		if (path[lens[i]] == '\0') {
+			/* The full path */
+
+			if (relpath) {
+				*relpath = &path[lens[i]];
+			}
+
+			return entry->node;
+		}
+
+		if (INODE_IS_MOUNTPT(entry->node)) {
+			/* A mountpoint above the path.  Skip the delimiter. */
+
+			if (relpath) {
+				*relpath = &path[lens[i] + 1];
+			}
+
+			return entry->node;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember that the first 'len' characters of 'path' resolve to 'node'.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path, size_t len, FAR struct inode *node)
+{
+	FAR struct inode_cache_s *entry;
+	uint32_t hash = INODE_CACHE_HASHINIT;
+	size_t i;
+
+	if (len == 0 || len >= CONFIG_FS_INODE_CACHE_PATHLEN) {
+		return;
+	}
+
+	for (i = 0; i < len; i++) {
+		hash = INODE_CACHE_HASH(hash, path[i]);
+	}
+
+	/* Replace whatever occupied the slot */
+
+	entry       = &g_inode_cache[hash % CONFIG_FS_INODE_CACHE_SIZE];
+	entry->node = node;
+	entry->hash = hash;
+	entry->len  = (uint8_t)len;
+	memcpy(entry->path, path, len);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Drop every cached path.  Called whenever the shape of the inode tree
+ *   changes.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_FS_INODE_CACHE_SIZE; i++) {
+		g_inode_cache[i].node = NULL;
+	}
+}
+
+#endif							/* CONFIG_FS_INODE_CACHE_SIZE > 0 */
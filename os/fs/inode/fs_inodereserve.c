@@ -151,6 +151,9 @@ static void inode_insert(FAR struct inode *node, FAR struct inode *peer, FAR str
 		node->i_peer = root_inode;
 		root_inode = node;
 	}
+	/* The shape of the tree changed */
+
+	inode_cache_invalidate();
 }
 
 /****************************************************************************
@@ -231,6 +231,28 @@ void inode_free(FAR struct inode *node);
 
 const char *inode_nextname(FAR const char *name);
 
+/* fs_inodecache.c **********************************************************/
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add, inode_cache_invalidate
+ *
+ * Description:
+ *   Hashed cache of resolved paths used by inode_search().  The cache holds
+ *   no references; it must be invalidated whenever an inode is added to or
+ *   removed from the tree.
+ *
+ * Assumptions:
+ *   The caller holds the tree_sem
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_INODE_CACHE_SIZE > 0
+FAR struct inode *inode_cache_lookup(FAR const char *path, FAR const char **relpath);
+void inode_cache_add(FAR const char *path, size_t len, FAR struct inode *node);
+void inode_cache_invalidate(void);
+#else
+#define inode_cache_invalidate()
+#endif
+
 /* fs_inodereserver.c *******************************************************/
 /****************************************************************************
  * Name: inode_reserve
@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/fs/ioctl.h>
+
+#include "fs_rammap.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap
+ *
+ * Description:
+ *   Map a file into memory.  TinyAra has no MMU, so only a subset of the
+ *   mmap() semantics is provided:
+ *
+ *   - If the file system can expose the file data directly (FIOC_MMAP),
+ *     e.g. a romfs image in execute-in-place flash or a tmpfs file held
+ *     in one extent, the returned address points at that data and nothing
+ *     is copied.
+ *   - Otherwise, if CONFIG_FS_RAMMAP is enabled, the requested range is
+ *     copied into a heap buffer that is released by munmap().  Writes to
+ *     such a copy are never written back to the file.
+ *
+ *   A private writable mapping always uses the copy so that writes cannot
+ *   modify the file.  MAP_FIXED and anonymous mappings are not supported.
+ *
+ * Parameters:
+ *   start   A hint at where to map the memory.  Ignored.
+ *   length  The length of the mapping.
+ *   prot    See the PROT_* definitions in sys/mman.h.
+ *   flags   See the MAP_* definitions in sys/mman.h.
+ *   fd      file descriptor of the backing file.
+ *   offset  The offset into the file to map.
+ *
+ * Returned Value:
+ *   On success, mmap() returns a pointer to the mapped area.  On error, the
+ *   value MAP_FAILED is returned, and errno is set appropriately.
+ *
+ *     EBADF    'fd' is not a valid file descriptor.
+ *     EINVAL   'length' was 0, 'offset' was negative, or the range is past
+ *              the end of a directly mapped file and CONFIG_FS_RAMMAP is not
+ *              enabled.
+ *     ENODEV   The file cannot be mapped directly and CONFIG_FS_RAMMAP is
+ *              not enabled.
+ *     ENOMEM   Not enough memory to copy the file.
+ *     ENOSYS   An unsupported flag was requested.
+ *
+ ****************************************************************************/
+
+FAR void *mmap(FAR void *start, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	FAR void *addr = NULL;
+	struct stat buf;
+	int errcode;
+	int ret;
+
+	if ((flags & (MAP_FIXED | MAP_ANONYMOUS)) != 0) {
+		fdbg("ERROR: Unsupported flags: %04x\n", flags);
+		errcode = ENOSYS;
+		goto errout;
+	}
+
+	if (length == 0 || offset < 0) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	/* Ask the file system for a direct pointer to the file data, unless
+	 * writes to the mapping must stay private.
+	 */
+
+	ret = ERROR;
+	if ((prot & PROT_WRITE) == 0 || (flags & MAP_PRIVATE) == 0) {
+		ret = ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+	}
+
+	/* The data of a regular file is only contiguous from the returned
+	 * address up to the end of the file (a tmpfs file is mapped only while
+	 * it fits in one extent), so the whole range must lie within the file.
+	 * Device drivers, like the frame buffer, know their own size.
+	 */
+
+	errcode = ENODEV;
+	if (ret >= 0 && addr != NULL) {
+		ret = fstat(fd, &buf);
+		if (ret < 0 || (S_ISREG(buf.st_mode) && ((off_t)length > buf.st_size || offset > buf.st_size - (off_t)length))) {
+			fdbg("ERROR: Range %lu+%lu is past the end of the file\n", (unsigned long)offset, (unsigned long)length);
+			errcode = EINVAL;
+			addr = NULL;
+		}
+	}
+
+	if (ret < 0 || addr == NULL) {
+#ifdef CONFIG_FS_RAMMAP
+		/* Fall back to a copy of the file in RAM */
+
+		ret = rammap(fd, length, offset, &addr);
+		if (ret < 0) {
+			errcode = -ret;
+			goto errout;
+		}
+
+		return addr;
+#else
+		fdbg("ERROR: File cannot be mapped directly\n");
+		goto errout;
+#endif
+	}
+
+	/* Return the offset address */
+
+	return (FAR void *)(((FAR uint8_t *)addr) + offset);
+
+errout:
+	set_errno(errcode);
+	return MAP_FAILED;
+}
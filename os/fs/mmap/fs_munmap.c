@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: munmap
+ *
+ * Description:
+ *   Release a mapping returned by mmap().  Mappings that point directly
+ *   into the media (XIP romfs, tmpfs file data) need no clean-up.  Files
+ *   that were copied into RAM are freed.  Only a whole copied mapping may
+ *   be released.
+ *
+ * Parameters:
+ *   start   The start address of the mapping to delete.
+ *   length  The length of the mapping to delete.
+ *
+ * Returned Value:
+ *   On success, munmap() returns 0, on failure -1, and errno is set
+ *   (probably to EINVAL).
+ *
+ ****************************************************************************/
+
+int munmap(FAR void *start, size_t length)
+{
+	FAR struct fs_rammap_s *prev;
+	FAR struct fs_rammap_s *curr;
+	FAR uint8_t *addr = (FAR uint8_t *)start;
+	int errcode;
+
+	while (sem_wait(&g_rammaps.exclsem) < 0) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	/* Search the list of copied mappings for the one containing 'start' */
+
+	for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink) {
+		if (addr >= (FAR uint8_t *)curr->addr &&
+			addr < (FAR uint8_t *)curr->addr + curr->length) {
+			break;
+		}
+	}
+
+	/* Not a copied mapping.  Nothing to release for a direct mapping. */
+
+	if (curr == NULL) {
+		sem_post(&g_rammaps.exclsem);
+		return OK;
+	}
+
+	/* Partial unmapping of a copied file is not supported */
+
+	if (addr != curr->addr || length < curr->length) {
+		fdbg("ERROR: Partial unmap is not supported\n");
+		errcode = ENOSYS;
+		goto errout_with_semaphore;
+	}
+
+	/* Remove the mapping from the list and free it */
+
+	if (prev) {
+		prev->flink = curr->flink;
+	} else {
+		g_rammaps.head = curr->flink;
+	}
+
+	sem_post(&g_rammaps.exclsem);
+	kumm_free(curr);
+	return OK;
+
+errout_with_semaphore:
+	sem_post(&g_rammaps.exclsem);
+	set_errno(errcode);
+	return ERROR;
+}
+
+#endif							/* CONFIG_FS_RAMMAP */
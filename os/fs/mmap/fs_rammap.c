@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* This is the list of all mapped files */
+
+struct fs_allmaps_s g_rammaps = {
+	SEM_INITIALIZER(1),
+	NULL
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap
+ *
+ * Description:
+ *   Support simulation of memory mapped files by copying files into RAM.
+ *
+ ****************************************************************************/
+
+int rammap(int fd, size_t length, off_t offset, FAR void **mapped)
+{
+	FAR struct fs_rammap_s *map;
+	FAR uint8_t *rdbuffer;
+	ssize_t nread;
+	size_t remaining;
+	int ret;
+
+	/* Allocate the mapping and the memory to hold the file data at once */
+
+	map = (FAR struct fs_rammap_s *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
+	if (map == NULL) {
+		fdbg("ERROR: Failed to allocate %lu bytes\n", (unsigned long)length);
+		return -ENOMEM;
+	}
+
+	map->addr   = (FAR uint8_t *)map + sizeof(struct fs_rammap_s);
+	map->length = length;
+
+	/* Read the file data into memory.  pread() leaves the file position
+	 * untouched.
+	 */
+
+	rdbuffer  = (FAR uint8_t *)map->addr;
+	remaining = length;
+
+	while (remaining > 0) {
+		nread = pread(fd, rdbuffer, remaining, offset);
+		if (nread < 0) {
+			ret = -get_errno();
+			if (ret == -EINTR) {
+				continue;
+			}
+
+			fdbg("ERROR: Read failed: offset=%d ret=%d\n", (int)offset, ret);
+			goto errout_with_map;
+		}
+
+		/* Zero the rest of the mapping past the end of the file */
+
+		if (nread == 0) {
+			memset(rdbuffer, 0, remaining);
+			break;
+		}
+
+		rdbuffer  += nread;
+		offset    += nread;
+		remaining -= nread;
+	}
+
+	/* Add the mapping to the list of mapped files */
+
+	while (sem_wait(&g_rammaps.exclsem) < 0) {
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	map->flink     = g_rammaps.head;
+	g_rammaps.head = map;
+
+	sem_post(&g_rammaps.exclsem);
+
+	*mapped = map->addr;
+	return OK;
+
+errout_with_map:
+	kumm_free(map);
+	return ret;
+}
+
+#endif							/* CONFIG_FS_RAMMAP */
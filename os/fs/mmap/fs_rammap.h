@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_RAMMAP_H
+#define __FS_MMAP_FS_RAMMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <semaphore.h>
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one file that has been copied into memory
+ * because the underlying file system cannot map it directly.  The mapped
+ * data follows this structure in the same allocation.
+ */
+
+struct fs_rammap_s {
+	FAR struct fs_rammap_s *flink;	/* Implements a singly linked list */
+	FAR void *addr;				/* Start of the mapped data */
+	size_t length;				/* Length of the mapped data */
+};
+
+/* This structure describes all of the mapped files */
+
+struct fs_allmaps_s {
+	sem_t exclsem;				/* Provides exclusive access the list */
+	FAR struct fs_rammap_s *head;	/* List of mapped files */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct fs_allmaps_s g_rammaps;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammap
+ *
+ * Description:
+ *   Support simulation of memory mapped files by copying files into RAM.
+ *
+ * Input Parameters:
+ *   fd      - A file descriptor of an open file.  The file position is not
+ *             changed.
+ *   length  - The number of bytes to map, starting at 'offset'
+ *   offset  - The offset into the file to start the mapping
+ *   mapped  - Location to return the address of the mapped data
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap(int fd, size_t length, off_t offset, FAR void **mapped);
+
+#endif							/* CONFIG_FS_RAMMAP */
+#endif							/* __FS_MMAP_FS_RAMMAP_H */
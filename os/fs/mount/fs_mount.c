@@ -353,6 +353,10 @@ int mount(FAR const char *source, FAR const char *target, FAR const char *filesy
 	mountpt_inode->i_mode = mode;
 #endif
 	mountpt_inode->i_private = fshandle;
+
+	/* Paths below the new mountpoint resolve differently now */
+
+	inode_cache_invalidate();
 	inode_semgive();
 
 	/* We can release our reference to the blkdrver_inode, if the filesystem
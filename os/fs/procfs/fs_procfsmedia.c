@@ -0,0 +1,307 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfsmedia.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if defined(CONFIG_MEDIA_STATISTICS) && defined(CONFIG_BUILD_FLAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEDIA)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct media_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	size_t textsize;			/* Number of valid characters in text */
+	FAR char *text;				/* Measurements sampled at the first read */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Implemented by the media framework, see framework/src/media/MediaStatistics.h.
+ * It is called directly, which is why the node is limited to the flat build.
+ */
+
+int media_statistics_read(char *buf, size_t size);
+
+/* File system methods */
+
+static int media_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int media_close(FAR struct file *filep);
+static ssize_t media_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int media_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int media_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations media_operations = {
+	media_open,					/* open */
+	media_close,				/* close */
+	media_read,					/* read */
+	NULL,						/* write */
+
+	media_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	media_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: media_open
+ ****************************************************************************/
+
+static int media_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct media_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "media" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "media") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct media_file_s *)kmm_zalloc(sizeof(struct media_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: media_close
+ ****************************************************************************/
+
+static int media_close(FAR struct file *filep)
+{
+	FAR struct media_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct media_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	if (attr->text) {
+		kmm_free(attr->text);
+	}
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: media_read
+ ****************************************************************************/
+
+static ssize_t media_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct media_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+	int len;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct media_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* If f_pos is zero, then sample the measurements.  Otherwise, use the
+	 * ones sampled by the previous read(), so that they stay consistent
+	 * when the file is read in pieces.
+	 */
+
+	if (filep->f_pos == 0) {
+		if (attr->text) {
+			kmm_free(attr->text);
+			attr->text = NULL;
+		}
+		attr->textsize = 0;
+
+		len = media_statistics_read(NULL, 0);
+		if (len <= 0) {
+			return 0;
+		}
+
+		attr->text = (FAR char *)kmm_malloc(len + 1);
+		if (!attr->text) {
+			fdbg("ERROR: Failed to allocate %d bytes\n", len + 1);
+			return -ENOMEM;
+		}
+
+		/* A player may be added in between, the text is cut then */
+
+		media_statistics_read(attr->text, len + 1);
+		attr->textsize = strlen(attr->text);
+	}
+
+	/* Transfer the measurements to user receive buffer */
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->text, attr->textsize, buffer, buflen, &offset);
+
+	/* Update the file offset */
+
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: media_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int media_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct media_file_s *oldattr;
+	FAR struct media_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct media_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the attributes */
+
+	newattr = (FAR struct media_file_s *)kmm_zalloc(sizeof(struct media_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Copy the sampled measurements, the new file owns its own copy */
+
+	newattr->base = oldattr->base;
+	if (oldattr->text) {
+		newattr->text = (FAR char *)kmm_malloc(oldattr->textsize + 1);
+		if (!newattr->text) {
+			kmm_free(newattr);
+			return -ENOMEM;
+		}
+		memcpy(newattr->text, oldattr->text, oldattr->textsize + 1);
+		newattr->textsize = oldattr->textsize;
+	}
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: media_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int media_stat(const char *relpath, struct stat *buf)
+{
+	/* "media" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "media") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "media" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_MEDIA_STATISTICS && CONFIG_BUILD_FLAT && !CONFIG_FS_PROCFS_EXCLUDE_MEDIA */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
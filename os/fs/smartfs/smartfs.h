@@ -66,6 +66,9 @@
 
 #include <tinyara/fs/mtd.h>
 #include <tinyara/fs/smart.h>
+#ifdef CONFIG_SMARTFS_WRITE_BUFFER_TIMEOUT
+#include <tinyara/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -208,7 +211,11 @@
 /* Underlying MTD Block driver access functions */
 
 #define FS_BOPS(f)        (f)->fs_blkdriver->u.i_bops
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+#define FS_IOCTL(f, c, a) smartfs_blkioctl(f, c, a)
+#else
 #define FS_IOCTL(f, c, a) (FS_BOPS(f)->ioctl ? FS_BOPS(f)->ioctl((f)->fs_blkdriver, c, a) : (-ENOSYS))
+#endif
 
 /* The logical sector number of the root directory. */
 
@@ -239,16 +246,28 @@
 #define UINT8_TO_UINT16(UINT8_ARRAY)                    ((uint16_t)(((uint16_t)UINT8_ARRAY[1] << 8) & 0xFF00) | UINT8_ARRAY[0])
 #define SMARTFS_NEXTSECTOR(h)   (UINT8_TO_UINT16(h->nextsector))
 #define SMARTFS_USED(h)                 (UINT8_TO_UINT16(h->used))
-#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+#if defined(CONFIG_MTD_SMART_ENABLE_CRC) || defined(CONFIG_SMARTFS_WRITE_BUFFER)
 #define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
 
+/* Dirty sector buffers are flushed from the work queue after a timeout */
+
+#if defined(CONFIG_SMARTFS_WRITE_BUFFER_TIMEOUT) && CONFIG_SMARTFS_WRITE_BUFFER_TIMEOUT > 0
+#define SMARTFS_WRITE_TIMEOUT 1
+#endif
+
 #define USED_ARRAY_SIZE                 2
 
 #if !defined(CONFIG_SMARTFS_DYNAMIC_HEADER) || !defined(CONFIG_MTD_SMART_SECTOR_SIZE)
 #undef  CONFIG_SMARTFS_DYNAMIC_HEADER
 #endif
 
+/* The directory entry index is enabled with a non-zero slot count */
+
+#if defined(CONFIG_SMARTFS_DIRINDEX_SIZE) && CONFIG_SMARTFS_DIRINDEX_SIZE > 0
+#define SMARTFS_DIRINDEX 1
+#endif
+
 #define SMARTFS_AVAIL_DATABYTES(f) f->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s)
 
 /****************************************************************************
@@ -329,6 +348,32 @@ struct smartfs_ofile_s {
 								 * causes the sector to change. */
 };
 
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+/* Write amplification counters, reported through procfs */
+
+struct smartfs_wstats_s {
+	uint32_t requests;			/* Number of write() calls */
+	uint32_t userbytes;			/* Bytes written by applications */
+	uint32_t sectorwrites;		/* BIOC_WRITESECT requests to the SMART layer */
+	uint32_t sectorbytes;		/* Bytes passed in those requests */
+};
+#endif
+
+#ifdef SMARTFS_DIRINDEX
+/* This structure is one slot of the in-memory directory entry index.  It
+ * remembers which sector of a directory chain holds a named entry so that
+ * a lookup can go straight to that sector instead of walking the chain.
+ * The slot is only a hint; the sector is always re-read and the entry
+ * name compared before the hint is trusted.
+ */
+
+struct smartfs_dirindex_s {
+	uint32_t hash;				/* Hash of the parent directory and name */
+	uint16_t dfirst;			/* First sector of the parent directory */
+	uint16_t dsector;			/* Sector holding the entry (0 = unused) */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -353,6 +398,16 @@ struct smartfs_mountpt_s {
 #ifdef CONFIG_SMARTFS_ENTRY_TIMESTAMP
 	uint32_t entry_seq;
 #endif
+#ifdef SMARTFS_DIRINDEX
+	FAR struct smartfs_dirindex_s *fs_dirindex;	/* Directory entry index */
+#endif
+#ifdef SMARTFS_WRITE_TIMEOUT
+	struct work_s fs_flushwork;	/* Delayed flush of dirty file buffers */
+	bool fs_flushpending;		/* fs_flushwork is queued or running */
+#endif
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+	struct smartfs_wstats_s fs_wstats;	/* Write amplification counters */
+#endif
 };
 
 
@@ -409,6 +464,10 @@ off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s
 
 ssize_t smartfs_append_data(FAR struct smartfs_mountpt_s *fs, FAR struct smartfs_ofile_s *sf, const char *buffer, size_t byteswritten, size_t buflen);
 
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+int smartfs_blkioctl(FAR struct smartfs_mountpt_s *fs, int cmd, unsigned long arg);
+#endif
+
 uint16_t smartfs_rdle16(FAR const void *val);
 
 void smartfs_wrle16(void *dest, uint16_t val);
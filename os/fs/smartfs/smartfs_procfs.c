@@ -745,6 +745,9 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer, size
 	size_t len;
 #ifdef CONFIG_DEBUG_FS
 	int utilization;
+#endif
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+	FAR struct smartfs_wstats_s *wstats;
 #endif
 	priv = (FAR struct smartfs_file_s *)filep->f_priv;
 
@@ -760,7 +763,17 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer, size
 
 		if (ret == OK) {
 			/* Format and return data in the buffer */
-			len = snprintf(buffer, buflen, "Total Sectors    %d\nFree Sectors     %d\n" "Released Sectors %d\n", procfs_data.totalsectors, procfs_data.freesectors, procfs_data.releasesectors);
+			len = snprintf(buffer, buflen, "Total Sectors    %d\nFree Sectors     %d\n" "Released Sectors %d\nScan Time (ms)   %u\n", procfs_data.totalsectors, procfs_data.freesectors, procfs_data.releasesectors, procfs_data.scantime);
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+			/* Report how many bytes reached the SMART layer for each byte
+			 * written by applications, in hundredths.
+			 */
+
+			wstats = &priv->level1.mount->fs_wstats;
+			if (len < buflen) {
+				len += snprintf(&buffer[len], buflen - len, "Write Requests   %u\nBytes Written    %u\n" "Sector Writes    %u\nSector Bytes     %u\n" "Write Amp x100   %u\n", wstats->requests, wstats->userbytes, wstats->sectorwrites, wstats->sectorbytes, wstats->userbytes ? (uint32_t)((uint64_t)wstats->sectorbytes * 100 / wstats->userbytes) : 0);
+			}
+#endif
 #ifdef CONFIG_DEBUG_FS
 			/* Calculate the sector utilization percentage */
 			if (procfs_data.blockerases == 0) {
@@ -115,6 +115,9 @@ static int smartfs_rmdir(struct inode *mountpt, const char *relpath);
 static int smartfs_rename(struct inode *mountpt, const char *oldrelpath, const char *newrelpath);
 static void smartfs_stat_common(FAR struct smartfs_mountpt_s *fs, FAR struct smartfs_entry_s *entry, FAR struct stat *buf);
 static int smartfs_stat(struct inode *mountpt, const char *relpath, struct stat *buf);
+#ifdef SMARTFS_WRITE_TIMEOUT
+static void smartfs_flush_worker(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Private Variables
@@ -165,6 +168,38 @@ const struct mountpt_operations smartfs_operations = {
  * Private Functions
  ****************************************************************************/
 
+#ifdef SMARTFS_WRITE_TIMEOUT
+/****************************************************************************
+ * Name: smartfs_flush_worker
+ *
+ * Description: Write out the sector buffer of every open file that still
+ *   holds unsynced data once the write buffer timeout has expired.
+ *
+ ****************************************************************************/
+
+static void smartfs_flush_worker(FAR void *arg)
+{
+	FAR struct smartfs_mountpt_s *fs = (FAR struct smartfs_mountpt_s *)arg;
+	FAR struct smartfs_ofile_s *sf;
+	int ret;
+
+	smartfs_semtake(fs);
+	for (sf = fs->fs_head; sf != NULL; sf = sf->fnext) {
+		if (sf->bflags & SMARTFS_BFLAG_DIRTY) {
+			ret = smartfs_sync_internal(fs, sf);
+			if (ret < 0) {
+				fdbg("Error %d flushing sector %d\n", ret, sf->currsector);
+			}
+		}
+	}
+
+	/* smartfs_unbind() may free fs as soon as this is cleared */
+
+	fs->fs_flushpending = false;
+	smartfs_semgive(fs);
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_open
  ****************************************************************************/
@@ -760,6 +795,24 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 	}
 	ret = byteswritten;
 
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+	if (ret > 0) {
+		fs->fs_wstats.requests++;
+		fs->fs_wstats.userbytes += ret;
+	}
+#endif
+
+#ifdef SMARTFS_WRITE_TIMEOUT
+	/* Make sure buffered data reaches the flash even if the file is
+	 * held open without further writes or syncs.
+	 */
+
+	if ((sf->bflags & SMARTFS_BFLAG_DIRTY) && !fs->fs_flushpending) {
+		fs->fs_flushpending = true;
+		work_queue(LPWORK, &fs->fs_flushwork, smartfs_flush_worker, fs, MSEC2TICK(CONFIG_SMARTFS_WRITE_BUFFER_TIMEOUT));
+	}
+#endif
+
 errout_with_semaphore:
 	smartfs_semgive(fs);
 	return ret;
@@ -1293,6 +1346,22 @@ static int smartfs_unbind(void *handle, FAR struct inode **blkdriver)
 
 	ret = OK;					/* Assume success */
 	smartfs_semtake(fs);
+#ifdef SMARTFS_WRITE_TIMEOUT
+	/* If no files are open, there is nothing left for a pending flush.  A
+	 * flush that has already left the work queue cannot be cancelled and
+	 * may be blocked on the semaphore, so let it finish before fs is freed.
+	 */
+
+	if (fs->fs_head == NULL && work_cancel(LPWORK, &fs->fs_flushwork) == OK) {
+		fs->fs_flushpending = false;
+	}
+
+	while (fs->fs_head == NULL && fs->fs_flushpending) {
+		smartfs_semgive(fs);
+		usleep(USEC_PER_TICK);
+		smartfs_semtake(fs);
+	}
+#endif
 	if (fs->fs_head != NULL) {
 		/* We cannot unmount now.. there are open files */
 
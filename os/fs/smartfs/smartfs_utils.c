@@ -186,6 +186,110 @@ struct sector_recover_info_s {
  * Private Functions
  ****************************************************************************/
 
+#ifdef SMARTFS_DIRINDEX
+/****************************************************************************
+ * Name: smartfs_dirindex_hash
+ *
+ * Description: FNV-1a hash of an entry name (at most namesize characters,
+ *   matching the strncmp used by the directory scan) seeded with the first
+ *   sector of the parent directory.
+ *
+ ****************************************************************************/
+
+static uint32_t smartfs_dirindex_hash(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name)
+{
+	uint32_t hash = 2166136261u;
+	uint16_t i;
+
+	hash = (hash ^ (dfirst & 0xff)) * 16777619u;
+	hash = (hash ^ (dfirst >> 8)) * 16777619u;
+	for (i = 0; i < fs->fs_llformat.namesize && name[i] != '\0'; i++) {
+		hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_lookup
+ *
+ * Description: Return the directory sector last seen holding 'name' in the
+ *   directory starting at 'dfirst', or 0 if the index has no hint for it.
+ *
+ ****************************************************************************/
+
+static uint16_t smartfs_dirindex_lookup(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name)
+{
+	FAR struct smartfs_dirindex_s *slot;
+	uint32_t hash;
+
+	if (fs->fs_dirindex == NULL) {
+		return 0;
+	}
+
+	hash = smartfs_dirindex_hash(fs, dfirst, name);
+	slot = &fs->fs_dirindex[hash % CONFIG_SMARTFS_DIRINDEX_SIZE];
+	if (slot->dsector != 0 && slot->hash == hash && slot->dfirst == dfirst) {
+		return slot->dsector;
+	}
+
+	return 0;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_add
+ *
+ * Description: Remember that 'name' of the directory starting at 'dfirst'
+ *   lives in directory sector 'dsector'.  The index is direct mapped, so
+ *   this simply replaces whatever the slot held before.
+ *
+ ****************************************************************************/
+
+static void smartfs_dirindex_add(FAR struct smartfs_mountpt_s *fs, uint16_t dfirst, FAR const char *name, uint16_t dsector)
+{
+	FAR struct smartfs_dirindex_s *slot;
+	uint32_t hash;
+
+	if (fs->fs_dirindex == NULL) {
+		return;
+	}
+
+	hash = smartfs_dirindex_hash(fs, dfirst, name);
+	slot = &fs->fs_dirindex[hash % CONFIG_SMARTFS_DIRINDEX_SIZE];
+	slot->hash = hash;
+	slot->dfirst = dfirst;
+	slot->dsector = dsector;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_clear
+ *
+ * Description: Drop every hint.  This must be done whenever a directory
+ *   sector is released, since the logical sector may later be reused by
+ *   another directory.  Mounts sharing the block device are cleared too.
+ *
+ ****************************************************************************/
+
+static void smartfs_dirindex_clear(FAR struct smartfs_mountpt_s *fs)
+{
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	FAR struct smartfs_mountpt_s *nextfs;
+
+	for (nextfs = g_mounthead; nextfs != NULL; nextfs = nextfs->fs_next) {
+		if (nextfs != fs && nextfs->fs_blkdriver == fs->fs_blkdriver && nextfs->fs_dirindex != NULL) {
+			memset(nextfs->fs_dirindex, 0, CONFIG_SMARTFS_DIRINDEX_SIZE * sizeof(struct smartfs_dirindex_s));
+		}
+	}
+#endif
+
+	if (fs->fs_dirindex != NULL) {
+		memset(fs->fs_dirindex, 0, CONFIG_SMARTFS_DIRINDEX_SIZE * sizeof(struct smartfs_dirindex_s));
+	}
+}
+#else
+#define smartfs_dirindex_clear(fs)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -216,6 +320,30 @@ void smartfs_semgive(struct smartfs_mountpt_s *fs)
 	sem_post(fs->fs_sem);
 }
 
+#ifdef CONFIG_SMARTFS_WRITE_STATS
+/****************************************************************************
+ * Name: smartfs_blkioctl
+ *
+ * Description: Pass a request to the SMART block driver, counting the
+ *   sector writes for the write amplification statistics.
+ *
+ ****************************************************************************/
+
+int smartfs_blkioctl(FAR struct smartfs_mountpt_s *fs, int cmd, unsigned long arg)
+{
+	if (FS_BOPS(fs)->ioctl == NULL) {
+		return -ENOSYS;
+	}
+
+	if (cmd == BIOC_WRITESECT) {
+		fs->fs_wstats.sectorwrites++;
+		fs->fs_wstats.sectorbytes += ((FAR struct smart_read_write_s *)arg)->count;
+	}
+
+	return FS_BOPS(fs)->ioctl(fs->fs_blkdriver, cmd, arg);
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_rdle16
  *
@@ -891,6 +1019,17 @@ int smartfs_mount(struct smartfs_mountpt_s *fs, bool writeable)
 	fs->fs_workbuffer = (char *)kmm_malloc(256);
 	fs->fs_rootsector = SMARTFS_ROOT_DIR_SECTOR;
 
+#ifdef SMARTFS_DIRINDEX
+	/* The directory entry index is only an accelerator.  Run without it if
+	 * there is not enough memory.
+	 */
+
+	fs->fs_dirindex = (FAR struct smartfs_dirindex_s *)kmm_zalloc(CONFIG_SMARTFS_DIRINDEX_SIZE * sizeof(struct smartfs_dirindex_s));
+	if (fs->fs_dirindex == NULL) {
+		fdbg("No memory for directory index, continuing without it\n");
+	}
+#endif
+
 	/* We did it! */
 
 	fs->fs_mounted = TRUE;
@@ -1008,6 +1147,15 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 		fs->fs_workbuffer = (char *)0xDEADBEEF;
 	}
 
+#ifdef SMARTFS_DIRINDEX
+	/* The directory index is private to each mount */
+
+	if (fs->fs_dirindex != NULL) {
+		kmm_free(fs->fs_dirindex);
+		fs->fs_dirindex = NULL;
+	}
+#endif
+
 	/* Now removed ourselves from the linked list */
 
 	if (fs == g_mounthead) {
@@ -1035,6 +1183,12 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 #endif
 	kmm_free(fs->fs_rwbuffer);
 	kmm_free(fs->fs_workbuffer);
+#ifdef SMARTFS_DIRINDEX
+	if (fs->fs_dirindex != NULL) {
+		kmm_free(fs->fs_dirindex);
+		fs->fs_dirindex = NULL;
+	}
+#endif
 #endif
 
 	return ret;
@@ -1071,6 +1225,9 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 	int used_value;
 #endif
+#ifdef SMARTFS_DIRINDEX
+	bool hinted = false;
+#endif
 
 	/* Initialize directory level zero as the root sector */
 	direntry->dsector = 0xFFFF;
@@ -1154,6 +1311,18 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 			dirsector = dirstack[depth];
 
+#ifdef SMARTFS_DIRINDEX
+			/* If the index knows which sector of the chain held this name
+			 * the last time, look there first.
+			 */
+
+			dirsector = smartfs_dirindex_lookup(fs, dirstack[depth], fs->fs_workbuffer);
+			hinted = (dirsector != 0);
+			if (!hinted) {
+				dirsector = dirstack[depth];
+			}
+#endif
+
 			/* Read the directory */
 
 			offset = 0xFFFF;
@@ -1168,6 +1337,15 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 				smartfs_setbuffer(&readwrite, dirsector, 0, fs->fs_llformat.availbytes, (uint8_t *)fs->fs_rwbuffer);
 				ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+#ifdef SMARTFS_DIRINDEX
+				if (hinted && (ret < 0 || ((struct smartfs_chain_header_s *)fs->fs_rwbuffer)->type != SMARTFS_SECTOR_TYPE_DIR)) {
+					/* Stale hint.  Fall back to walking the whole chain */
+
+					hinted = false;
+					dirsector = dirstack[depth];
+					continue;
+				}
+#endif
 				if (ret < 0) {
 					goto errout;
 				}
@@ -1194,6 +1372,16 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 						continue;
 					}
 
+#ifdef SMARTFS_DIRINDEX
+					/* Index every live entry passed on a full walk so that
+					 * later lookups in this directory take a single read.
+					 */
+
+					if (!hinted) {
+						smartfs_dirindex_add(fs, dirstack[depth], entry->name, readwrite.logsector);
+					}
+#endif
+
 					/* Test if the name matches */
 
 					if (strncmp(entry->name, fs->fs_workbuffer, fs->fs_llformat.namesize) == 0) {
@@ -1319,6 +1507,17 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 				if (offset < readwrite.count) {
 					break;
 				}
+
+#ifdef SMARTFS_DIRINDEX
+				/* The hinted sector no longer holds the name.  Search the
+				 * chain from its start.
+				 */
+
+				if (hinted) {
+					hinted = false;
+					dirsector = dirstack[depth];
+				}
+#endif
 			}
 
 			/* If we found a dir entry, then continue searching */
@@ -1340,6 +1539,7 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 			if (*ptr == '\0') {
 				direntry->dsector = dirstack[depth];
+				direntry->dfirst = dirstack[depth];
 				strncpy(direntry->name, segment, seglen);
 			} else {
 				direntry->dsector = 0xFFFF;
@@ -1587,6 +1787,12 @@ int smartfs_writeentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s new_
 		}
 	}
 
+#ifdef SMARTFS_DIRINDEX
+	/* Record where the new entry lives so the next lookup finds it at once */
+
+	smartfs_dirindex_add(fs, new_entry.dfirst, new_entry.name, new_entry.dsector);
+#endif
+
 	ret = OK;
 
 errout:
@@ -1783,6 +1989,10 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 			/* We don't have to inactive entry, we will release entire of sector */
 			inactive_entry = FALSE;
 
+			/* Hints pointing at the released sector must not survive it */
+
+			smartfs_dirindex_clear(fs);
+
 			/* Okay, to release the sector, we must find the sector that we
 			 * are chained to and remove ourselves from the chain.
 			 * First save our nextsector value so we can "unchain" ourselves.
@@ -1868,6 +2078,12 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 		}
 	}
 
+	/* Releasing a directory's own chain invalidates any hint into it */
+
+	if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_DIR) {
+		smartfs_dirindex_clear(fs);
+	}
+
 	/* Now Free Chained sector from target entry */
 	nextsector = entry->firstsector;
 	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
@@ -2519,6 +2735,10 @@ int smartfs_sector_recovery(struct smartfs_mountpt_s *fs)
 	fvdbg("sector recover start\n");
 	memset(map, 0, size);
 
+	/* Recovery may release directory sectors behind the index's back */
+
+	smartfs_dirindex_clear(fs);
+
 	/* If any of logical sector is mapped to physical block it means active block, Mark it */
 	for (sector = SMARTFS_ROOT_DIR_SECTOR; sector < fs->fs_llformat.nsectors; sector++) {
 		ret = FS_IOCTL(fs, BIOC_FIBMAP, (unsigned long)sector);
@@ -83,10 +83,6 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
-
 #define tmpfs_lock_file(tfo) \
 	(tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -108,7 +104,9 @@ static void tmpfs_unlock(FAR struct tmpfs_s *fs);
 static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo, unsigned int nentries);
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo, size_t newsize);
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize);
+static void tmpfs_read_extents(FAR struct tmpfs_file_s *tfo, size_t pos, FAR uint8_t *buffer, size_t len);
+static size_t tmpfs_write_extents(FAR struct tmpfs_file_s *tfo, size_t pos, FAR const uint8_t *buffer, size_t len);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo, FAR const char *name);
@@ -341,65 +339,150 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_resize_file
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-		size_t newsize)
+static int tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
 {
-	FAR struct tmpfs_file_s *oldtfo = *tfo;
-	FAR struct tmpfs_file_s *newtfo;
-	size_t objsize;
-	size_t allocsize;
+	FAR uint8_t **extents;
+	size_t nextents;
+	size_t maxextents;
+	size_t offset;
+	size_t i;
+
+	nextents = TMPFS_NEXTENTS(newsize);
+
+	if (nextents > tfo->tfo_maxextents) {
+		/* Growing past the extent table.  Grow the table geometrically so
+		 * that appending stays cheap.  The extents themselves are not
+		 * allocated until they are written.
+		 */
 
-	/* Check if the current allocation is sufficent */
+		maxextents = tfo->tfo_maxextents * 2;
+		if (maxextents < nextents) {
+			maxextents = nextents;
+		}
 
-	objsize = SIZEOF_TMPFS_FILE(newsize);
+		extents = (FAR uint8_t **)kmm_realloc(tfo->tfo_extents, maxextents * sizeof(FAR uint8_t *));
+		if (extents == NULL) {
+			return -ENOMEM;
+		}
 
-	/* Are we growing or shrinking the object? */
+		tfo->tfo_alloc      += (maxextents - tfo->tfo_maxextents) * sizeof(FAR uint8_t *);
+		tfo->tfo_extents     = extents;
+		tfo->tfo_maxextents  = maxextents;
+	}
 
-	if (objsize <= oldtfo->tfo_alloc) {
-		/* Shrinking ... Shrink unconditionally if the size is shrinking to
-		 * zero.
+	if (nextents > tfo->tfo_nextents) {
+		for (i = tfo->tfo_nextents; i < nextents; i++) {
+			tfo->tfo_extents[i] = NULL;
+		}
+	} else if (newsize < tfo->tfo_size) {
+		/* Shrinking.  Free the extents past the new end of the file and
+		 * clear the tail of the last one.
 		 */
 
-		if (newsize > 0) {
-			/* Otherwise, don't realloc unless the object has shrunk by a
-			 * lot.
-			 */
+		for (i = nextents; i < tfo->tfo_nextents; i++) {
+			if (tfo->tfo_extents[i] != NULL) {
+				kmm_free(tfo->tfo_extents[i]);
+				tfo->tfo_alloc -= TMPFS_EXTENT_SIZE;
+			}
+		}
 
-			if (oldtfo->tfo_alloc - objsize <= CONFIG_FS_TMPFS_FILE_FREEGUARD) {
-				/* Hasn't shrunk enough.. Return doing nothing for now */
+		offset = newsize % TMPFS_EXTENT_SIZE;
+		if (offset > 0 && tfo->tfo_extents[nextents - 1] != NULL) {
+			memset(&tfo->tfo_extents[nextents - 1][offset], 0, TMPFS_EXTENT_SIZE - offset);
+		}
 
-				oldtfo->tfo_size = newsize;
-				return OK;
-			}
+		if (nextents == 0) {
+			kmm_free(tfo->tfo_extents);
+			tfo->tfo_alloc     -= tfo->tfo_maxextents * sizeof(FAR uint8_t *);
+			tfo->tfo_extents    = NULL;
+			tfo->tfo_maxextents = 0;
 		}
 	}
 
-	/* Added some additional amount to the new size to account frequent
-	 * reallocations.
-	 */
+	tfo->tfo_nextents = nextents;
+	tfo->tfo_size     = newsize;
+	return OK;
+}
 
-	allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+/****************************************************************************
+ * Name: tmpfs_read_extents
+ ****************************************************************************/
 
-	/* Realloc the file object */
+static void tmpfs_read_extents(FAR struct tmpfs_file_s *tfo, size_t pos,
+		FAR uint8_t *buffer, size_t len)
+{
+	FAR uint8_t *extent;
+	size_t offset;
+	size_t nbytes;
+
+	while (len > 0) {
+		extent = tfo->tfo_extents[pos / TMPFS_EXTENT_SIZE];
+		offset = pos % TMPFS_EXTENT_SIZE;
+		nbytes = TMPFS_EXTENT_SIZE - offset;
+		if (nbytes > len) {
+			nbytes = len;
+		}
 
-	newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-	if (newtfo == NULL) {
-		return -ENOMEM;
+		/* An extent that was never written reads back as zeros */
+
+		if (extent != NULL) {
+			memcpy(buffer, &extent[offset], nbytes);
+		} else {
+			memset(buffer, 0, nbytes);
+		}
+
+		pos    += nbytes;
+		buffer += nbytes;
+		len    -= nbytes;
 	}
-	/* Adjust the reference in the parent directory entry */
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_extents
+ *
+ * Description:
+ *   Copy data into the file, allocating extents as needed.  The extent
+ *   table must already cover the range.  Returns the number of bytes
+ *   written, which is short only if an extent could not be allocated.
+ *
+ ****************************************************************************/
 
-	DEBUGASSERT(newtfo->tfo_dirent);
-	newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+static size_t tmpfs_write_extents(FAR struct tmpfs_file_s *tfo, size_t pos,
+		FAR const uint8_t *buffer, size_t len)
+{
+	FAR uint8_t **extent;
+	size_t nwritten = 0;
+	size_t offset;
+	size_t nbytes;
+
+	while (nwritten < len) {
+		extent = &tfo->tfo_extents[pos / TMPFS_EXTENT_SIZE];
+		offset = pos % TMPFS_EXTENT_SIZE;
+		nbytes = TMPFS_EXTENT_SIZE - offset;
+		if (nbytes > len - nwritten) {
+			nbytes = len - nwritten;
+		}
 
-	/* Return the new address of the reallocated file object */
+		if (*extent == NULL) {
+			*extent = (FAR uint8_t *)kmm_zalloc(TMPFS_EXTENT_SIZE);
+			if (*extent == NULL) {
+				break;
+			}
 
-	newtfo->tfo_alloc = allocsize;
-	newtfo->tfo_size  = newsize;
-	*tfo              = newtfo;
-	return OK;
+			tfo->tfo_alloc += TMPFS_EXTENT_SIZE;
+		}
+
+		memcpy(&(*extent)[offset], buffer, nbytes);
+
+		pos      += nbytes;
+		buffer   += nbytes;
+		nwritten += nbytes;
+	}
+
+	return nwritten;
 }
 
 /****************************************************************************
@@ -434,6 +517,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
 	if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0) {
 		sem_destroy(&tfo->tfo_exclsem.ts_sem);
+		(void)tmpfs_resize_file(tfo, 0);
 		kmm_free(tfo);
 	}
 
@@ -575,7 +659,7 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 
 	/* Create a new zero length file object */
 
-	allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
+	allocsize = sizeof(struct tmpfs_file_s);
 	tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
 	if (tfo == NULL) {
 		return NULL;
@@ -590,6 +674,10 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 	tfo->tfo_flags = 0;
 	tfo->tfo_size  = 0;
 
+	tfo->tfo_nextents   = 0;
+	tfo->tfo_maxextents = 0;
+	tfo->tfo_extents    = NULL;
+
 	tfo->tfo_exclsem.ts_holder = getpid();
 	tfo->tfo_exclsem.ts_count  = 1;
 	sem_init(&tfo->tfo_exclsem.ts_sem, 0, 0);
@@ -1171,6 +1259,10 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 			tfo->tfo_flags |= TFO_FLAG_UNLINKED;
 			return TMPFS_UNLINKED;
 		}
+
+		/* No.. free the file data */
+
+		(void)tmpfs_resize_file(tfo, 0);
 	}
 
 	/* Free the object now */
@@ -1316,7 +1408,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 			 */
 
 			if (tfo->tfo_size > 0) {
-				ret = tmpfs_realloc_file(&tfo, 0);
+				ret = tmpfs_resize_file(tfo, 0);
 				if (ret < 0)
 					goto errout_with_filelock;
 			}
@@ -1420,6 +1512,7 @@ static int tmpfs_close(FAR struct file *filep)
 		 * have any other references.
 		 */
 
+		(void)tmpfs_resize_file(tfo, 0);
 		kmm_free(tfo);
 		return OK;
 	}
@@ -1467,7 +1560,12 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
 	/* Copy data from the memory object to the user buffer */
 
-	memcpy(buffer, &tfo->tfo_data[startpos], nread);
+	if (nread > 0) {
+		tmpfs_read_extents(tfo, (size_t)startpos, (FAR uint8_t *)buffer, nread);
+	} else {
+		nread = 0;
+	}
+
 	filep->f_pos += nread;
 
 	/* Release the lock on the file */
@@ -1485,6 +1583,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
 	FAR struct tmpfs_file_s *tfo;
 	ssize_t nwritten;
+	size_t oldsize;
 	off_t startpos;
 	off_t endpos;
 	int ret;
@@ -1507,19 +1606,33 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 	nwritten = buflen;
 	endpos   = startpos + buflen;
 
+	oldsize  = tfo->tfo_size;
+
 	if (endpos > tfo->tfo_size) {
-		/* Reallocate the file to handle the write past the end of the file. */
+		/* Extend the file to handle the write past the end of the file. */
 
-		ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
+		ret = tmpfs_resize_file(tfo, (size_t)endpos);
 		if (ret < 0) {
 			goto errout_with_lock;
 		}
-		filep->f_priv = tfo;
 	}
 
-	/* Copy data from the memory object to the user buffer */
+	/* Copy data from the user buffer to the file extents */
+
+	nwritten = tmpfs_write_extents(tfo, (size_t)startpos, (FAR const uint8_t *)buffer, buflen);
+	if ((size_t)nwritten < buflen) {
+		/* Out of memory.  Drop the part of the extension not written. */
+
+		if (tfo->tfo_size > oldsize) {
+			(void)tmpfs_resize_file(tfo, startpos + nwritten > oldsize ? startpos + nwritten : oldsize);
+		}
+
+		if (nwritten == 0) {
+			ret = -ENOMEM;
+			goto errout_with_lock;
+		}
+	}
 
-	memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
 	filep->f_pos += nwritten;
 
 	/* Release the lock on the file */
@@ -1612,10 +1725,15 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 	if (cmd == FIOC_MMAP && ppv != NULL) {
 		/* Return the address on the media corresponding to the start of
-		 * the file.
+		 * the file.  The file data is contiguous only while it fits in a
+		 * single extent.
 		 */
 
-		*ppv = (FAR void *)tfo->tfo_data;
+		if (tfo->tfo_nextents != 1 || tfo->tfo_extents[0] == NULL) {
+			return -ENOSYS;
+		}
+
+		*ppv = (FAR void *)tfo->tfo_extents[0];
 		return OK;
 	}
 
@@ -1717,22 +1835,14 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
 	oldsize = tfo->tfo_size;
 	if (oldsize != length) {
-		/* The size is changing.. up or down.  Reallocate the file memory. */
-		ret = tmpfs_realloc_file(&tfo, (size_t)length);
-		if (ret < 0) {
-			goto errout_with_lock;
-		}
-
-		filep->f_priv = tfo;
-
-		/* If the size has increased, then we need to zero the newly added
-		 * memory.
+		/* The size is changing.. up or down.  Any newly added range reads
+		 * back as zeros until it is written.
 		 */
 
-		if (length > oldsize) {
-		  memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+		ret = tmpfs_resize_file(tfo, (size_t)length);
+		if (ret < 0) {
+			goto errout_with_lock;
 		}
-		ret = OK;
 	}
 
 	/* Release the lock on the file */
@@ -2117,6 +2227,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
 	else {
 		sem_destroy(&tfo->tfo_exclsem.ts_sem);
+		(void)tmpfs_resize_file(tfo, 0);
 		kmm_free(tfo);
 	}
 
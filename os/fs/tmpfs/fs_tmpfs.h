@@ -174,10 +174,17 @@ struct tmpfs_file_s {
 
 	uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
 	size_t   tfo_size;     /* Valid file size */
-	uint8_t  tfo_data[1];  /* File data starts here */
+	size_t   tfo_nextents; /* Number of extents covering tfo_size */
+	size_t   tfo_maxextents; /* Allocated entries in tfo_extents */
+	FAR uint8_t **tfo_extents; /* File data, NULL for an unwritten extent */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
+/* File data is held in fixed size extents allocated as they are written.
+ * Bytes past tfo_size in an allocated extent are always zero.
+ */
+
+#define TMPFS_EXTENT_SIZE      CONFIG_FS_TMPFS_FILE_EXTENTSIZE
+#define TMPFS_NEXTENTS(n)      (((n) + TMPFS_EXTENT_SIZE - 1) / TMPFS_EXTENT_SIZE)
 
 /* This structure represents one instance of a TMPFS file system */
 
@@ -322,13 +322,19 @@
 #define __SYS_mmap                     (__SYS_filedesc + 7)
 #endif
 #define SYS_mmap                       (__SYS_mmap + 0)
-#define SYS_open                       (__SYS_mmap + 1)
-#define SYS_opendir                    (__SYS_mmap + 2)
+#if defined(CONFIG_FS_RAMMAP)
+#define SYS_munmap                     (__SYS_mmap + 1)
+#define __SYS_open                     (__SYS_mmap + 2)
+#else
+#define __SYS_open                     (__SYS_mmap + 1)
+#endif
+#define SYS_open                       (__SYS_open + 0)
+#define SYS_opendir                    (__SYS_open + 1)
 #if defined(CONFIG_PIPES)
-#define SYS_pipe                       (__SYS_mmap + 3)
-#define __SYS_readdir                  (__SYS_mmap + 4)
+#define SYS_pipe                       (__SYS_open + 2)
+#define __SYS_readdir                  (__SYS_open + 3)
 #else
-#define __SYS_readdir                  (__SYS_mmap + 3)
+#define __SYS_readdir                  (__SYS_open + 2)
 #endif
 #define SYS_readdir                    (__SYS_readdir + 0)
 #define SYS_rewinddir                  (__SYS_readdir + 1)
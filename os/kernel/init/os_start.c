@@ -137,6 +137,13 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+/* These are the priority indexes of the g_readytorun and g_pendingtasks lists */
+
+struct sched_pqindex_s g_readytorun_index;
+struct sched_pqindex_s g_pendingtasks_index;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
@@ -376,6 +383,15 @@ void os_start(void)
 
 	dq_addfirst((FAR dq_entry_t *)&g_idletcb, (FAR dq_queue_t *)&g_readytorun);
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+	/* The idle task is below SCHED_PRIORITY_MIN, so sched_addprioritized()
+	 * does not take it.  Enter it in the priority index by hand.
+	 */
+
+	g_readytorun_index.tail[SCHED_PRIORITY_IDLE] = &g_idletcb.cmn;
+	g_readytorun_index.bitmap[0] |= (uint32_t)1 << SCHED_PRIORITY_IDLE;
+#endif
+
 	/* Initialize the processor-specific portion of the TCB */
 
 	up_initial_state(&g_idletcb.cmn);
@@ -125,6 +125,22 @@ struct tasklist_s {
 	bool prioritized;			/* true if the list is prioritized */
 };
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+/* This structure indexes a prioritized task list by priority.  The tasks
+ * of the same priority are kept as a FIFO run in the list, tail[] points
+ * to the last task of each run and bitmap has a bit set for each priority
+ * which has a run.  With this, the place to insert a task is found without
+ * walking the list.
+ */
+
+#define SCHED_PQINDEX_NWORDS   ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+struct sched_pqindex_s {
+	uint32_t bitmap[SCHED_PQINDEX_NWORDS];
+	FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];
+};
+#endif
+
 /****************************************************************************
  * Global Variables
  ****************************************************************************/
@@ -154,6 +170,20 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+/* These are the priority indexes of the g_readytorun and g_pendingtasks
+ * lists.  They are maintained by sched_addprioritized() and
+ * sched_remprioritized().
+ */
+
+extern struct sched_pqindex_s g_readytorun_index;
+extern struct sched_pqindex_s g_pendingtasks_index;
+
+#define sched_pqindex(list) \
+	((list) == &g_readytorun ? &g_readytorun_index : \
+	 ((list) == &g_pendingtasks ? &g_pendingtasks_index : NULL))
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -239,6 +269,7 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 bool sched_mergepending(void);
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
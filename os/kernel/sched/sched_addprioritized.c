@@ -80,9 +80,44 @@
  ************************************************************************/
 
 /************************************************************************
- * Private Function Prototypes
+ * Private Functions
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+/************************************************************************
+ * Name: sched_pqindex_findprev
+ *
+ * Description:
+ *  Find the last TCB of the lowest priority which is still higher than
+ *  the given priority.  A new TCB of the given priority goes just after
+ *  the returned TCB if there is no TCB of the same priority yet.
+ *
+ ************************************************************************/
+
+static FAR struct tcb_s *sched_pqindex_findprev(FAR struct sched_pqindex_s *index, uint8_t sched_priority)
+{
+	unsigned int priority = (unsigned int)sched_priority + 1;
+	unsigned int word;
+	uint32_t bits;
+
+	if (priority > SCHED_PRIORITY_MAX) {
+		return NULL;
+	}
+
+	word = priority >> 5;
+	bits = index->bitmap[word] & (0xffffffff << (priority & 31));
+
+	while (!bits) {
+		if (++word >= SCHED_PQINDEX_NWORDS) {
+			return NULL;
+		}
+		bits = index->bitmap[word];
+	}
+
+	return index->tail[(word << 5) + __builtin_ctz(bits)];
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -118,6 +153,9 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 	FAR struct tcb_s *prev;
 	uint8_t sched_priority = tcb->sched_priority;
 	bool ret = false;
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+	FAR struct sched_pqindex_s *index = sched_pqindex(list);
+#endif
 
 	/* Lets do a sanity check before we get started. */
 
@@ -127,7 +165,28 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 	 * Each is list is maintained in ascending sched_priority order.
 	 */
 
-	for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+	if (index) {
+		/* The tcb goes just after the last tcb of the same or the nearest
+		 * higher priority, which is found in the index without a search.
+		 */
+
+		prev = index->tail[sched_priority];
+		if (!prev) {
+			prev = sched_pqindex_findprev(index, sched_priority);
+		}
+
+		next = prev ? prev->flink : (FAR struct tcb_s *)list->head;
+
+		/* Now the tcb is the last one of its priority */
+
+		index->tail[sched_priority] = tcb;
+		index->bitmap[sched_priority >> 5] |= (uint32_t)1 << (sched_priority & 31);
+	} else
+#endif
+	{
+		for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+	}
 
 	/* Add the tcb to the spot found in the list.  Check if the tcb
 	 * goes at the end of the list. NOTE:  This could only happen if list
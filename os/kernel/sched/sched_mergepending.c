@@ -58,6 +58,7 @@
 
 #include <stdbool.h>
 #include <sched.h>
+#include <string.h>
 #include <queue.h>
 #include <assert.h>
 
@@ -114,9 +115,41 @@ bool sched_mergepending(void)
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
 	FAR struct tcb_s *rtrtcb;
+#ifndef CONFIG_SCHED_READYQUEUE_BITMAP
 	FAR struct tcb_s *rtrprev;
+#endif
 	bool ret = false;
 
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+	/* Each pending TCB is put in place through the priority index of the
+	 * g_readytorun list, so the list is not searched at all.  The order is
+	 * the one of the list walk below: a pending TCB goes after the ready
+	 * TCBs of the same priority, and the pending TCBs keep their order.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+
+		rtrtcb = this_task();
+		if (sched_addprioritized(pndtcb, (FAR dq_queue_t *)&g_readytorun)) {
+			/* Special case: pndtcb was inserted at the head of the list */
+
+			rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+
+	/* Mark the input list and its index empty */
+
+	g_pendingtasks.head = NULL;
+	g_pendingtasks.tail = NULL;
+	memset(&g_pendingtasks_index, 0, sizeof(struct sched_pqindex_s));
+
+	return ret;
+#else
 	/* Initialize the inner search loop */
 
 	rtrtcb = this_task();
@@ -176,4 +209,5 @@ bool sched_mergepending(void)
 	g_pendingtasks.tail = NULL;
 
 	return ret;
+#endif
 }
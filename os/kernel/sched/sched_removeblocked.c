@@ -116,7 +116,7 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
 	 * with this state
 	 */
 
-	dq_rem((FAR dq_entry_t *)btcb, (dq_queue_t *)g_tasklisttable[task_state].list);
+	sched_remprioritized(btcb, (dq_queue_t *)g_tasklisttable[task_state].list);
 
 	/* Make sure the TCB's state corresponds to not being in
 	 * any list
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_remprioritized
+ *
+ * Description:
+ *  This function removes a TCB from a task list.  It is the counterpart of
+ *  sched_addprioritized() and keeps the priority index of the list
+ *  consistent, so every removal from a prioritized list must use it.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove from the list
+ *   list - Points to the list which holds tcb
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before
+ *   calling this function.
+ * - The priority of tcb has not been changed since it was added.
+ *
+ ****************************************************************************/
+
+void sched_remprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+#ifdef CONFIG_SCHED_READYQUEUE_BITMAP
+	FAR struct sched_pqindex_s *index = sched_pqindex(list);
+	FAR struct tcb_s *prev;
+	uint8_t sched_priority = tcb->sched_priority;
+
+	if (index && index->tail[sched_priority] == tcb) {
+		/* The previous TCB becomes the last one of this priority, if any */
+
+		prev = tcb->blink;
+		if (prev && prev->sched_priority == sched_priority) {
+			index->tail[sched_priority] = prev;
+		} else {
+			index->tail[sched_priority] = NULL;
+			index->bitmap[sched_priority >> 5] &= ~((uint32_t)1 << (sched_priority & 31));
+		}
+	}
+#endif
+
+	dq_rem((FAR dq_entry_t *)tcb, list);
+}
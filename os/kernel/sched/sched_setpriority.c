@@ -161,9 +161,13 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		/* Otherwise, we can just change priority since it has no effect */
 
 		else {
-			/* Change the task priority */
+			/* Change the task priority.  The task stays at the head of
+			 * the list, but it is moved to keep the list index consistent.
+			 */
 
+			sched_remprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
 			tcb->sched_priority = (uint8_t)sched_priority;
+			sched_addprioritized(tcb, (FAR dq_queue_t *)&g_readytorun);
 		}
 		break;
 
@@ -213,7 +217,7 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		if (g_tasklisttable[task_state].prioritized) {
 			/* Remove the TCB from the prioritized task list */
 
-			dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
+			sched_remprioritized(tcb, (FAR dq_queue_t *)g_tasklisttable[task_state].list);
 
 			/* Change the task priority */
 
@@ -127,7 +127,7 @@ int task_terminate_unloaded(FAR struct tcb_s *tcb)
 	sig_cleanup(tcb);
 
 	saved_state = irqsave();
-	dq_rem((FAR dq_entry_t *)tcb, (dq_queue_t *)g_tasklisttable[tcb->task_state].list);
+	sched_remprioritized(tcb, (dq_queue_t *)g_tasklisttable[tcb->task_state].list);
 	irqrestore(saved_state);
 
 #ifdef CONFIG_TASK_MONITOR
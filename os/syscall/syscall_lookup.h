@@ -226,6 +226,9 @@ SYSCALL_LOOKUP(lseek,                   3, STUB_lseek)
 SYSCALL_LOOKUP(mkfifo,                  2, STUB_mkfifo)
 #endif
 SYSCALL_LOOKUP(mmap,                    6, NULL)
+#if defined(CONFIG_FS_RAMMAP)
+SYSCALL_LOOKUP(munmap,                  2, STUB_munmap)
+#endif
 SYSCALL_LOOKUP(open,                    6, STUB_open)
 SYSCALL_LOOKUP(opendir,                 1, STUB_opendir)
 #if defined(CONFIG_PIPES)
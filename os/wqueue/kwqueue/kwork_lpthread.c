@@ -206,7 +206,7 @@ int work_lpstart(void)
 
 	/* Initialize work queue data structures */
 
-	memset(&g_lpwork, 0, sizeof(struct wqueue_s));
+	memset(&g_lpwork, 0, sizeof(struct lp_wqueue_s));
 
 	dq_init(&g_lpwork.q);
 
@@ -80,6 +80,12 @@ int work_signal(int qid)
 			*/
 
 		pid = g_lpwork.worker[wndx].pid;
+
+		/* Mark the selected thread busy now so that back-to-back requests
+		 * wake different IDLE threads instead of signalling the same one.
+		 */
+
+		g_lpwork.worker[wndx].busy = true;
 	} else
 #endif
 	{
@@ -73,6 +73,15 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Only the kernel low priority work queue is serviced by a pool of worker
+ * threads.
+ */
+
+#if defined(CONFIG_SCHED_LPWORK) && (CONFIG_SCHED_LPNTHREADS > 1) && \
+	!(defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__))
+#define WORK_POOL 1
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -89,6 +98,55 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef WORK_POOL
+/****************************************************************************
+ * Name: work_pool_idle
+ *
+ * Description:
+ *   Called with interrupts disabled by a worker thread that is about to
+ *   perform a work while more work remains queued.  If the next work is
+ *   already due, select another IDLE worker thread of the pool and mark it
+ *   busy so that the remaining work is not held up behind a long-running
+ *   one.  Delayed work is left to the timeout of the current worker; waking
+ *   a peer for it would only send the peer back to sleep.
+ *
+ * Input parameters:
+ *   wqueue - Describes the work queue being processed
+ *   wndx   - The index of the calling worker thread
+ *
+ * Returned Value:
+ *   The process ID of the selected worker thread, or zero if there is no
+ *   remaining ready work or no IDLE worker thread.
+ *
+ ****************************************************************************/
+
+static pid_t work_pool_idle(FAR struct wqueue_s *wqueue, int wndx)
+{
+	FAR struct work_s *head;
+	int i;
+
+	if (wqueue != (FAR struct wqueue_s *)&g_lpwork) {
+		return 0;
+	}
+
+	/* The queue is sorted by expiry, so only the head needs to be checked */
+
+	head = (FAR struct work_s *)wqueue->q.head;
+	if (head == NULL || clock() - head->qtime < head->delay) {
+		return 0;
+	}
+
+	for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+		if (i != wndx && !g_lpwork.worker[i].busy) {
+			g_lpwork.worker[i].busy = true;
+			return g_lpwork.worker[i].pid;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +175,9 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 	clock_t elapsed;
 	clock_t ctick;
 	clock_t next;
+#ifdef WORK_POOL
+	pid_t kick;
+#endif
 
 	/* Then process queued work.  We need to keep interrupts disabled while
 	 * we process items in the work list.
@@ -174,6 +235,12 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 
 				work->worker = NULL;
 
+#ifdef WORK_POOL
+				/* Hand the rest of the queue to an IDLE worker thread */
+
+				kick = work_pool_idle(wqueue, wndx);
+#endif
+
 				/* Do the work.  Re-enable interrupts while the work is being
 				 * performed... we don't have any idea how long this will take!
 				 */
@@ -182,6 +249,11 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 				work_unlock();
 #else
 				irqrestore(flags);
+#endif
+#ifdef WORK_POOL
+				if (kick > 0) {
+					(void)work_qsignal(kick);
+				}
 #endif
 				worker(arg);
 
@@ -0,0 +1,234 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <araui/ui_commons.h>
+#include "ui_renderer.h"
+#include "dal/ui_dal.h"
+#include "dal/dal_null.h"
+
+/****************************************************************************
+ * Macros
+ ****************************************************************************/
+#define BENCH_DEFAULT_FRAMES (200)
+
+#define BENCH_ICON_SIZE      (96)
+#define BENCH_ICON_NUM       (4)
+#define BENCH_GLYPH_WIDTH    (14)
+#define BENCH_GLYPH_HEIGHT   (18)
+#define BENCH_GLYPH_COLS     (20)
+#define BENCH_GLYPH_ROWS     (6)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+typedef struct {
+	const char *name;
+	void (*render)(void);
+} bench_scene_t;
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+static uint8_t g_background[CONFIG_UI_DISPLAY_WIDTH * CONFIG_UI_DISPLAY_HEIGHT * 3];
+static uint8_t g_icon[BENCH_ICON_SIZE * BENCH_ICON_SIZE * 4];
+static uint8_t g_glyph[BENCH_GLYPH_WIDTH * BENCH_GLYPH_HEIGHT];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static void bench_make_textures(void)
+{
+	int x;
+	int y;
+	uint8_t *p;
+
+	p = g_background;
+	for (y = 0; y < CONFIG_UI_DISPLAY_HEIGHT; y++) {
+		for (x = 0; x < CONFIG_UI_DISPLAY_WIDTH; x++) {
+			*p++ = (uint8_t)x;
+			*p++ = (uint8_t)y;
+			*p++ = (uint8_t)(x ^ y);
+		}
+	}
+
+	p = g_icon;
+	for (y = 0; y < BENCH_ICON_SIZE; y++) {
+		for (x = 0; x < BENCH_ICON_SIZE; x++) {
+			*p++ = (uint8_t)(x * 2);
+			*p++ = (uint8_t)(y * 2);
+			*p++ = 0x80;
+			*p++ = (uint8_t)(((x / 8) + (y / 8)) & 1 ? 0xff : 0x80);
+		}
+	}
+
+	p = g_glyph;
+	for (y = 0; y < BENCH_GLYPH_HEIGHT; y++) {
+		for (x = 0; x < BENCH_GLYPH_WIDTH; x++) {
+			*p++ = (x == 2 || x == BENCH_GLYPH_WIDTH - 3 || y == BENCH_GLYPH_HEIGHT / 2) ? 0xff : 0x00;
+		}
+	}
+}
+
+static void bench_draw_quad(float x, float y, float width, float height, int32_t degree, float scale)
+{
+	ui_mat3_t identity;
+	ui_mat3_t mat;
+
+	identity = ui_mat3_identity();
+	ui_renderer_translate(&identity, &mat, x, y);
+	if (degree) {
+		ui_renderer_rotate(&mat, degree);
+	}
+	if (scale != 1.0f) {
+		ui_renderer_scale(&mat, scale, scale);
+	}
+
+	ui_render_quad_uv(&mat,
+		(ui_vec3_t){ 0.0f, 0.0f, 1.0f },
+		(ui_vec3_t){ 0.0f, height, 1.0f },
+		(ui_vec3_t){ width, height, 1.0f },
+		(ui_vec3_t){ width, 0.0f, 1.0f },
+		(ui_uv_t){ 0.0f, 0.0f },
+		(ui_uv_t){ 0.0f, 1.0f },
+		(ui_uv_t){ 1.0f, 1.0f },
+		(ui_uv_t){ 1.0f, 0.0f });
+}
+
+static void bench_render_background(void)
+{
+	ui_renderer_set_texture(g_background, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT, UI_PIXEL_FORMAT_RGB888);
+	bench_draw_quad(0.0f, 0.0f, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT, 0, 1.0f);
+	ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+}
+
+static void bench_render_icons(void)
+{
+	int i;
+
+	ui_renderer_set_texture(g_icon, BENCH_ICON_SIZE, BENCH_ICON_SIZE, UI_PIXEL_FORMAT_RGBA8888);
+	for (i = 0; i < BENCH_ICON_NUM; i++) {
+		bench_draw_quad(20.0f + (i * 80), 40.0f + (i * 50), BENCH_ICON_SIZE, BENCH_ICON_SIZE, 0, 1.0f);
+	}
+	ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+}
+
+static void bench_render_text(void)
+{
+	int col;
+	int row;
+
+	ui_renderer_set_texture(g_glyph, BENCH_GLYPH_WIDTH, BENCH_GLYPH_HEIGHT, UI_PIXEL_FORMAT_A8);
+	ui_renderer_set_fill_color(0xffffff);
+	for (row = 0; row < BENCH_GLYPH_ROWS; row++) {
+		for (col = 0; col < BENCH_GLYPH_COLS; col++) {
+			bench_draw_quad(10.0f + (col * (BENCH_GLYPH_WIDTH + 3)), 20.0f + (row * (BENCH_GLYPH_HEIGHT + 30)),
+				BENCH_GLYPH_WIDTH, BENCH_GLYPH_HEIGHT, 0, 1.0f);
+		}
+	}
+	ui_renderer_set_fill_color(0x000000);
+	ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+}
+
+static void bench_render_transformed(void)
+{
+	int i;
+
+	ui_renderer_set_texture(g_icon, BENCH_ICON_SIZE, BENCH_ICON_SIZE, UI_PIXEL_FORMAT_RGBA8888);
+	for (i = 0; i < BENCH_ICON_NUM; i++) {
+		bench_draw_quad(80.0f + (i * 60), 60.0f + (i * 50), BENCH_ICON_SIZE, BENCH_ICON_SIZE, 15 * (i + 1), 1.5f);
+	}
+	ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+}
+
+static void bench_render_mixed(void)
+{
+	bench_render_background();
+	bench_render_icons();
+	bench_render_text();
+	bench_render_transformed();
+}
+
+static const bench_scene_t g_scenes[] = {
+	{ "background", bench_render_background },
+	{ "icons", bench_render_icons },
+	{ "text", bench_render_text },
+	{ "transformed", bench_render_transformed },
+	{ "mixed", bench_render_mixed }
+};
+
+static double bench_elapsed_sec(struct timespec *start, struct timespec *end)
+{
+	return (double)(end->tv_sec - start->tv_sec) + ((double)(end->tv_nsec - start->tv_nsec) / 1000000000.0);
+}
+
+/****************************************************************************
+ * Main
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	struct timespec start;
+	struct timespec end;
+	double elapsed;
+	int frames = BENCH_DEFAULT_FRAMES;
+	int scene;
+	int frame;
+
+	if (argc > 1) {
+		frames = atoi(argv[1]);
+		if (frames <= 0) {
+			printf("usage: %s [frames]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	if (ui_dal_init() != UI_OK) {
+		printf("error: ui_dal_init failed!\n");
+		return -1;
+	}
+
+	ui_dal_set_viewport(0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT);
+
+	bench_make_textures();
+
+	printf("AraUI renderer benchmark (%dx%d, %d frames per scene)\n",
+		CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT, frames);
+
+	for (scene = 0; scene < sizeof(g_scenes) / sizeof(g_scenes[0]); scene++) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (frame = 0; frame < frames; frame++) {
+			ui_dal_clear();
+			g_scenes[scene].render();
+			ui_renderer_flush();
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		elapsed = bench_elapsed_sec(&start, &end);
+		printf("%-12s %10.2f fps %10.3f ms/frame  checksum %08x\n",
+			g_scenes[scene].name, frames / elapsed, (elapsed * 1000.0) / frames, dal_null_checksum());
+	}
+
+	ui_dal_deinit();
+
+	return 0;
+}
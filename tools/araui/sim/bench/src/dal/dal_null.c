@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//!< AraUI Public
+#include <araui/ui_commons.h>
+
+//!< AraUI Internal
+#include "ui_debug.h"
+#include "dal/ui_dal.h"
+
+//!< Local
+#include "dal_null.h"
+#include "dal_span.h"
+
+/****************************************************************************
+ * Macros
+ ****************************************************************************/
+#define FB_SIZE (CONFIG_UI_DISPLAY_WIDTH * CONFIG_UI_DISPLAY_HEIGHT * 3)
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+static uint8_t   g_fb[FB_SIZE];
+static ui_rect_t g_viewport = {0, };
+
+/****************************************************************************
+ * DAL Interface Implementation
+ ****************************************************************************/
+UI_DAL ui_error_t ui_dal_init(void)
+{
+	memset(g_fb, 0, FB_SIZE);
+
+	return UI_OK;
+}
+
+UI_DAL ui_error_t ui_dal_deinit(void)
+{
+	return UI_OK;
+}
+
+UI_DAL void ui_dal_redraw(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+
+}
+
+UI_DAL void ui_dal_clear(void)
+{
+	memset(g_fb, 0, FB_SIZE);
+}
+
+UI_DAL void ui_dal_put_pixel_rgba8888(int32_t x, int32_t y, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg;
+	ui_color_rgb888_t *bg;
+
+	if (x < 0 || x >= CONFIG_UI_DISPLAY_WIDTH || y < 0 || y >= CONFIG_UI_DISPLAY_HEIGHT) {
+		return;
+	}
+
+	fg = (ui_color_rgba8888_t *)&color;
+	bg = (ui_color_rgb888_t *)&g_fb[(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+
+	bg->r = ((fg->r * fg->a) + (bg->r * (255 - fg->a))) / 255;
+	bg->g = ((fg->g * fg->a) + (bg->g * (255 - fg->a))) / 255;
+	bg->b = ((fg->b * fg->a) + (bg->b * (255 - fg->a))) / 255;
+}
+
+UI_DAL void ui_dal_put_pixel_rgb888(int32_t x, int32_t y, ui_color_t color)
+{
+	ui_color_rgb888_t *fg;
+	ui_color_rgb888_t *bg;
+
+	if (x < 0 || x >= CONFIG_UI_DISPLAY_WIDTH || y < 0 || y >= CONFIG_UI_DISPLAY_HEIGHT) {
+		return;
+	}
+
+	fg = (ui_color_rgb888_t *)&color;
+	bg = (ui_color_rgb888_t *)&g_fb[(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	bg->r = fg->r;
+	bg->g = fg->g;
+	bg->b = fg->b;
+}
+
+UI_DAL void ui_dal_fill_span(int32_t x, int32_t y, int32_t width, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg = (ui_color_rgba8888_t *)&color;
+	uint8_t *dst;
+
+	if (!dal_clip_span(&x, y, &width, NULL)) {
+		return;
+	}
+
+	dst = &g_fb[(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	while (width--) {
+		dal_blend(dst, fg->r, fg->g, fg->b, fg->a);
+		dst += 3;
+	}
+}
+
+UI_DAL void ui_dal_blit_span(int32_t x, int32_t y, int32_t width, const uint8_t *src, ui_pixel_format_t pf)
+{
+	uint8_t *dst;
+	int32_t skip = 0;
+
+	if (!dal_clip_span(&x, y, &width, &skip)) {
+		return;
+	}
+
+	dst = &g_fb[(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	if (pf == UI_PIXEL_FORMAT_RGB888) {
+		memcpy(dst, src + (skip * 3), width * 3);
+	} else if (pf == UI_PIXEL_FORMAT_RGBA8888) {
+		src += skip * 4;
+		while (width--) {
+			dal_blend(dst, src[0], src[1], src[2], src[3]);
+			dst += 3;
+			src += 4;
+		}
+	}
+}
+
+UI_DAL void ui_dal_blit_span_a8(int32_t x, int32_t y, int32_t width, const uint8_t *alpha, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg = (ui_color_rgba8888_t *)&color;
+	uint8_t *dst;
+	int32_t skip = 0;
+
+	if (!dal_clip_span(&x, y, &width, &skip)) {
+		return;
+	}
+
+	dst = &g_fb[(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	alpha += skip;
+	while (width--) {
+		dal_blend(dst, fg->r, fg->g, fg->b, *alpha++);
+		dst += 3;
+	}
+}
+
+UI_DAL ui_error_t ui_dal_set_viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	g_viewport.x = x;
+	g_viewport.y = y;
+	g_viewport.width = width;
+	g_viewport.height = height;
+
+	return UI_OK;
+}
+
+UI_DAL ui_rect_t ui_dal_get_viewport(void)
+{
+	return g_viewport;
+}
+
+#if defined(CONFIG_UI_ENABLE_TOUCH)
+
+UI_DAL bool ui_dal_get_touch(bool *pressed, ui_coord_t *coord)
+{
+	return false;
+}
+
+#endif // CONFIG_UI_ENABLE_TOUCH
+
+/****************************************************************************
+ * Public Functions Implementation
+ ****************************************************************************/
+uint32_t dal_null_checksum(void)
+{
+	uint32_t sum = 0;
+	int i;
+
+	for (i = 0; i < FB_SIZE; i++) {
+		sum = (sum * 31) + g_fb[i];
+	}
+
+	return sum;
+}
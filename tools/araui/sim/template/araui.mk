@@ -31,6 +31,9 @@ CSRCS += $(UIFW_DIR)/core/ui_request_callback.c
 CSRCS += $(UIFW_DIR)/core/ui_window.c
 CSRCS += $(UIFW_DIR)/core/ui_quick_panel.c
 CSRCS += $(UIFW_DIR)/core/ui_commons.c
+CSRCS += $(UIFW_DIR)/core/ui_dal_default.c
+CSRCS += $(UIFW_DIR)/core/ui_dal_batch.c
+CSRCS += $(UIFW_DIR)/assets/ui_glyph_cache.c
 CSRCS += $(UIFW_DIR)/assets/ui_asset.c
 CSRCS += $(UIFW_DIR)/assets/ui_font_asset.c
 CSRCS += $(UIFW_DIR)/assets/ui_image_asset.c
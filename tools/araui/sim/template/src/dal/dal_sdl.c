@@ -38,6 +38,7 @@
 
 //!< Local
 #include "dal_sdl.h"
+#include "dal_span.h"
 
 /****************************************************************************
  * Macros
@@ -193,6 +194,62 @@ inline UI_DAL void ui_dal_put_pixel_rgb888(int32_t x, int32_t y, ui_color_t colo
 	bg->b = fg->b;
 }
 
+UI_DAL void ui_dal_fill_span(int32_t x, int32_t y, int32_t width, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg = (ui_color_rgba8888_t *)&color;
+	uint8_t *dst;
+
+	if (!dal_clip_span(&x, y, &width, NULL)) {
+		return;
+	}
+
+	dst = &g_fb[BACK_PAGE][(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	while (width--) {
+		dal_blend(dst, fg->r, fg->g, fg->b, fg->a);
+		dst += 3;
+	}
+}
+
+UI_DAL void ui_dal_blit_span(int32_t x, int32_t y, int32_t width, const uint8_t *src, ui_pixel_format_t pf)
+{
+	uint8_t *dst;
+	int32_t skip = 0;
+
+	if (!dal_clip_span(&x, y, &width, &skip)) {
+		return;
+	}
+
+	dst = &g_fb[BACK_PAGE][(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	if (pf == UI_PIXEL_FORMAT_RGB888) {
+		memcpy(dst, src + (skip * 3), width * 3);
+	} else if (pf == UI_PIXEL_FORMAT_RGBA8888) {
+		src += skip * 4;
+		while (width--) {
+			dal_blend(dst, src[0], src[1], src[2], src[3]);
+			dst += 3;
+			src += 4;
+		}
+	}
+}
+
+UI_DAL void ui_dal_blit_span_a8(int32_t x, int32_t y, int32_t width, const uint8_t *alpha, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg = (ui_color_rgba8888_t *)&color;
+	uint8_t *dst;
+	int32_t skip = 0;
+
+	if (!dal_clip_span(&x, y, &width, &skip)) {
+		return;
+	}
+
+	dst = &g_fb[BACK_PAGE][(y * CONFIG_UI_DISPLAY_WIDTH + x) * 3];
+	alpha += skip;
+	while (width--) {
+		dal_blend(dst, fg->r, fg->g, fg->b, *alpha++);
+		dst += 3;
+	}
+}
+
 UI_DAL ui_error_t ui_dal_set_viewport(int32_t x, int32_t y, int32_t width, int32_t height)
 {
 	g_viewport.x = x;
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __DAL_SPAN_H__
+#define __DAL_SPAN_H__
+
+#include <tinyara/config.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Span helpers shared by the simulator DAL backends which render
+ * into an RGB888 frame buffer of the display size.
+ */
+
+/**
+ * @brief Clip a span of the row y to the display.
+ * skip, if given, returns how many pixels were cut from the left.
+ * Returns false when nothing of the span is left.
+ */
+static inline bool dal_clip_span(int32_t *x, int32_t y, int32_t *width, int32_t *skip)
+{
+	if (y < 0 || y >= CONFIG_UI_DISPLAY_HEIGHT) {
+		return false;
+	}
+
+	if (*x < 0) {
+		if (skip) {
+			*skip = -(*x);
+		}
+		*width += *x;
+		*x = 0;
+	}
+
+	if (*x + *width > CONFIG_UI_DISPLAY_WIDTH) {
+		*width = CONFIG_UI_DISPLAY_WIDTH - *x;
+	}
+
+	return (*width > 0);
+}
+
+/**
+ * @brief Blend a color with alpha a over the RGB888 pixel dst.
+ */
+static inline void dal_blend(uint8_t *dst, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	if (a == 0xff) {
+		dst[0] = r;
+		dst[1] = g;
+		dst[2] = b;
+	} else if (a) {
+		dst[0] = ((r * a) + (dst[0] * (255 - a))) / 255;
+		dst[1] = ((g * a) + (dst[1] * (255 - a))) / 255;
+		dst[2] = ((b * a) + (dst[2] * (255 - a))) / 255;
+	}
+}
+
+#endif // __DAL_SPAN_H__
@@ -9,14 +9,18 @@
 #define CONFIG_UI_DISPLAY_RGB888
 #define CONFIG_UI_ENABLE_TOUCH
 #define CONFIG_UI_ENABLE_EMOJI
+#define CONFIG_UI_USE_EXTERNAL_DAL_IMPL
 
 //!< Values
 #define CONFIG_UI_TOUCH_THRESHOLD     (10)
 #define CONFIG_UI_DISPLAY_WIDTH       (360)
 #define CONFIG_UI_DISPLAY_HEIGHT      (360)
 #define CONFIG_UI_STACK_SIZE          (8192)
-#define CONFIG_UI_UPDATE_MEMPOOL_SIZE (128)
 #define CONFIG_UI_MAXIMUM_FPS         (30)
+#define CONFIG_UI_IDLE_POLL_INTERVAL  (33)
+#define CONFIG_UI_DAL_BATCH_SIZE      (16)
+#define CONFIG_UI_GLYPH_CACHE_NUM     (128)
+#define CONFIG_UI_GLYPH_CACHE_SIZE    (16384)
 #define CONFIG_UI_DISPLAY_SCALE       (1)
 
 #endif